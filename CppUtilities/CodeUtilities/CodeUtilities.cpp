@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 // CodeUtilities.cpp - small, generally useful, helper classes     //
-// ver 1.7                                                         //
+// ver 1.8                                                         //
 //-----------------------------------------------------------------//
 // Jim Fawcett (c) copyright 2019                                  //
 // All rights granted provided this copyright notice is retained   //
@@ -31,6 +31,7 @@ int main(int argc, char* argv[])
   preface("Command Line: "); pcl.showCmdLine(argc, argv);
   preface("path:     "); pcl.showPath();
   preface("Options:  "); pcl.showOptions();
+  preface("Named:    "); pcl.showNamedOptions();
   preface("Patterns: "); pcl.showPatterns();
   preface("Rexex:    "); pcl.showRegex();
   preface("LogFile:  "); pcl.showLogFile();
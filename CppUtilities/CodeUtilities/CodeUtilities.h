@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////
 // CodeUtilities.h - small, generally useful, helper classes       //
-// ver 1.7                                                         //
+// ver 1.8                                                         //
 //-----------------------------------------------------------------//
 // Jim Fawcett (c) copyright 2019                                  //
 // All rights granted provided this copyright notice is retained   //
@@ -24,6 +24,9 @@
 *
 * Maintenance History:
 * --------------------
+* ver 1.8 : 18 Oct 2026
+* - added named options, e.g., /index build out.idx, which take zero or
+*   more values.  Any option longer than one character is named.
 * ver 1.7 : 04 Aug 2019
 * - replaced local option storage with pcl object
 * ver 1.6 : 01 Aug 2019
@@ -85,6 +88,9 @@ namespace Utilities
     using Regex = std::string;
     using LogFile = std::string;
     using Number = long int;
+    using NamedOption = std::string;
+    using NamedOptionValues = std::vector<std::string>;
+    using NamedOptions = std::unordered_map<NamedOption, NamedOptionValues>;
 
     ProcessCmdLine(int argc, char** argv, std::ostream& out = std::cout);
     ProcessCmdLine() : pOut_(&std::cout) {};
@@ -98,6 +104,9 @@ namespace Utilities
     Options& options();
     void option(Option op, OptionValue val = "");
     bool hasOption(Option op);
+    NamedOptions& namedOptions();
+    bool hasNamedOption(const NamedOption& name);
+    NamedOptionValues namedOption(const NamedOption& name);
     Patterns patterns();
     void pattern(const Pattern& patt);
     Number maxItems();
@@ -111,6 +120,7 @@ namespace Utilities
     void showParse();
     void showPath();
     void showOptions();
+    void showNamedOptions();
     void showPatterns();
     void showMaxItems();
     void showRegex();
@@ -122,6 +132,7 @@ namespace Utilities
     std::vector<char*> argv_;
     Patterns patterns_ = Patterns();
     Options options_ = Options();
+    NamedOptions namedOptions_ = NamedOptions();
     bool parseError_ = false;
     std::ostream* pOut_;
     std::ostringstream msg_ = std::ostringstream();
@@ -181,6 +192,39 @@ namespace Utilities
     }
   }
 
+  /*----< named options operations >---------------------------------*/
+  /*
+  *  Named options are words, e.g., /index build, collecting all the
+  *  values that follow them up to the next option.
+  */
+  inline ProcessCmdLine::NamedOptions& ProcessCmdLine::namedOptions()
+  {
+    return namedOptions_;
+  }
+
+  inline bool ProcessCmdLine::hasNamedOption(const NamedOption& name)
+  {
+    return namedOptions_.count(name) > 0;
+  }
+
+  inline ProcessCmdLine::NamedOptionValues ProcessCmdLine::namedOption(const NamedOption& name)
+  {
+    auto iter = namedOptions_.find(name);
+    if (iter == namedOptions_.end())
+      return NamedOptionValues();
+    return iter->second;
+  }
+
+  inline void ProcessCmdLine::showNamedOptions()
+  {
+    for (auto opt : namedOptions_)
+    {
+      *pOut_ << '/' << opt.first << " ";
+      for (auto val : opt.second)
+        *pOut_ << val << " ";
+    }
+  }
+
   /*----< patterns operations >--------------------------------------*/
 
   inline void ProcessCmdLine::pattern(const Pattern& pattern)
@@ -287,6 +331,7 @@ namespace Utilities
     *pOut_ << "\n  options:  ";
     preface("", false);
     showOptions();
+    showNamedOptions();
     *pOut_ << "\n  patterns: ";
     preface("", false);
     showPatterns();
@@ -334,12 +379,23 @@ namespace Utilities
       defaultUsageMessage();
 
     size_t i = 1;
+    std::string named;
     while (i < argc_)
     {
-      if (argv_[i][0] == '/')
+      if (argv_[i][0] == '/' && argv_[i][1] != '\0' && argv_[i][2] != '\0')
+      {
+        named = argv_[i] + 1;
+        namedOptions_[named] = NamedOptionValues();
+      }
+      else if (argv_[i][0] == '/')
       {
+        named.clear();
         options_[argv_[i][1]] = "";
       }
+      else if (named.size() > 0)
+      {
+        namedOptions_[named].push_back(argv_[i]);
+      }
       else
       {
         options_[argv_[i - 1][1]] = argv_[i];
@@ -419,6 +475,9 @@ namespace Utilities
     msg_ << "\n      /s                       // recurse";
     msg_ << "\n      /f                       // process files";
     msg_ << "\n      /d                       // process directories";
+    msg_ << "\n    /name [arg]* has a named option type, a word, and zero or more arguments";
+    msg_ << "\n    Example:";
+    msg_ << "\n      /index build out.idx     // named option with two arguments";
     msg_ << "\n";
   }
 
@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////
 // DirExplorerT.h - Template directory explorer                    //
-// ver 1.2                                                         //
+// ver 1.3                                                         //
 // Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018         //
 /////////////////////////////////////////////////////////////////////
 /*
@@ -27,12 +27,17 @@
 * ---------------
 * DirExplorerT.h, DirExplorerT.cpp
 * Application.h, Application.cpp    // provides defn's for doDir and doFile
+*   or PluginApplication.h, .cpp     // runs doDir and doFile of a plugin DLL
 * FileSystem.h, FileSystem.cpp      // Directory and Path classes
 * StringUtilities.h                 // Title function
 * CodeUtilities.h                   // ProcessCmdLine class
 *
 * Maintenance History:
 * --------------------
+* ver 1.3 : 18 Oct 2026
+* - added app(), for configuring the App, e.g., loading the plugin of
+*   a PluginApplication
+* - fixed fileCount() and dirCount(), which named App, not app_
 * ver 1.2 : 24 Jun 2019
 * - minor fixes due to CodeUtilities::ProcessCmdLine changes
 * ver 1.1 : 16 Aug 2018
@@ -52,7 +57,7 @@ namespace FileSystem
   public:
     using patterns = std::vector<std::string>;
 
-    static std::string version() { return "ver 1.2"; }
+    static std::string version() { return "ver 1.3"; }
 
     DirExplorerT(const std::string& path);
 
@@ -62,6 +67,7 @@ namespace FileSystem
     void showAllInCurrDir(bool showAllCurrDirFiles);
     bool showAllInCurrDir();
     void recurse(bool doRecurse = true);
+    App& app();
     
     void search();
     void find(const std::string& path);
@@ -135,6 +141,13 @@ namespace FileSystem
   {
     recurse_ = doRecurse;
   }
+  //----< the App, for configuring it before search >---------------
+
+  template<typename App>
+  App& DirExplorerT<App>::app()
+  {
+    return app_;
+  }
   //----< start Depth First Search at path held in path_ >-----------
 
   template<typename App>
@@ -203,14 +216,14 @@ namespace FileSystem
   template<typename App>
   size_t DirExplorerT<App>::fileCount()
   {
-    return App.fileCount();
+    return app_.fileCount();
   }
   //----< return number of directories processed >-------------------
 
   template<typename App>
   size_t DirExplorerT<App>::dirCount()
   {
-    return App.dirCount();
+    return app_.dirCount();
   }
   //----< show final counts for files and dirs >---------------------
 
@@ -0,0 +1,89 @@
+#ifndef PLUGINAPI_H
+#define PLUGINAPI_H
+///////////////////////////////////////////////////////////////////////
+// PluginApi.h - C interface of DirExplorerT applications in DLLs    //
+// ver 1.0                                                           //
+// Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018           //
+///////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+*  -------------------
+*  DirExplorerT's App is compiled into the explorer.  A plugin is an
+*  App built separately, as a DLL, and loaded by PluginApplication at
+*  run time, so an explorer can run processing it wasn't built with.
+*
+*  The interface is C, so a plugin may be built with another compiler,
+*  runtime library, or language than the explorer.  A plugin exports
+*  one function, named by DX_PLUGIN_ENTRY, returning a table of
+*  functions:
+*  - create and destroy make and free the plugin's state, passed to the
+*    other functions.  config is the text given to the explorer for the
+*    plugin.  create returns null to refuse to run.
+*  - doDir, doFile, done, and showStats are called as DirExplorerT calls
+*    an App's.  done returns nonzero to stop the walk.
+*  - doFiles, if not null, is called instead of doFile, with a batch of
+*    the names of one dir's files, so the cost of a call through the
+*    table is paid once per batch, not once per file.  Names are valid
+*    only during the call.
+*  Any of doDir, doFile, doFiles, done, and showStats may be null.
+*
+*  A plugin shows text through the host's write function, so its output
+*  goes where the explorer's does, in order, whatever runtime it uses.
+*
+*  The table's size lets later versions add functions at its end; a
+*  host ignores what it doesn't know, and treats missing functions as
+*  null.
+*
+*  Required Files:
+*  ---------------
+*  PluginApi.h
+*
+*  Maintenance History:
+*  --------------------
+*  ver 1.0 : 18 Oct 2026
+*  - first release
+*/
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DX_PLUGIN_ABI_VERSION 1
+#define DX_PLUGIN_ENTRY "DirExplorerPlugin"
+
+#ifdef _WIN32
+#define DX_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define DX_PLUGIN_EXPORT
+#endif
+
+typedef struct DxHost
+{
+  void* context;
+  void (*write)(void* context, const char* text, size_t length);
+} DxHost;
+
+typedef struct DxPlugin
+{
+  unsigned abiVersion;   /* DX_PLUGIN_ABI_VERSION */
+  size_t size;           /* sizeof(DxPlugin) */
+  void* (*create)(const DxHost* host, const char* config);
+  void (*destroy)(void* state);
+  void (*doDir)(void* state, const char* dir);
+  void (*doFile)(void* state, const char* file);
+  void (*doFiles)(void* state, const char* dir, const char* const* files, size_t count);
+  int (*done)(void* state);
+  void (*showStats)(void* state);
+} DxPlugin;
+
+typedef const DxPlugin* (*DxPluginEntry)(void);
+
+/* a plugin defines:  DX_PLUGIN_EXPORT const DxPlugin* DirExplorerPlugin(void) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
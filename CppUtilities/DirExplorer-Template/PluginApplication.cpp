@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////
+// PluginApplication.cpp - DirExplorerT App running a plugin DLL     //
+// ver 1.0                                                           //
+// Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018           //
+///////////////////////////////////////////////////////////////////////
+
+#include "PluginApplication.h"
+#include <windows.h>
+#include <iostream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+const size_t PluginApplication::MaxBatch;
+
+PluginApplication::PluginApplication()
+{
+  host_.context = this;
+  host_.write = &PluginApplication::write;
+}
+
+PluginApplication::~PluginApplication()
+{
+  unload();
+}
+//----< plugin's output goes to the explorer's >--------------------
+
+void PluginApplication::write(void* context, const char* text, size_t length)
+{
+  std::cout.write(text, length);
+}
+//----< load plugin from dllPath and create its state >-------------
+/*
+*  A table shorter than this host's leaves the functions it lacks null;
+*  a longer one, from a later version, has functions this host ignores.
+*/
+bool PluginApplication::load(const std::string& dllPath, const std::string& config)
+{
+  unload();
+  HMODULE module = ::LoadLibraryA(dllPath.c_str());
+  if (module == NULL)
+  {
+    error_ = "can't load plugin " + dllPath + ", error " + std::to_string(::GetLastError());
+    return false;
+  }
+  module_ = module;
+  DxPluginEntry entry = reinterpret_cast<DxPluginEntry>(::GetProcAddress(module, DX_PLUGIN_ENTRY));
+  const DxPlugin* table = entry ? entry() : nullptr;
+  if (table == nullptr || table->abiVersion != DX_PLUGIN_ABI_VERSION || table->size < offsetof(DxPlugin, doDir))
+  {
+    error_ = dllPath + " is not a DirExplorer plugin of version " + std::to_string(DX_PLUGIN_ABI_VERSION);
+    unload();
+    return false;
+  }
+  plugin_ = DxPlugin();
+  std::memcpy(&plugin_, table, (std::min)(table->size, sizeof(DxPlugin)));
+  state_ = plugin_.create ? plugin_.create(&host_, config.c_str()) : nullptr;
+  if (plugin_.create && state_ == nullptr)
+  {
+    error_ = dllPath + " refused to run with \"" + config + "\"";
+    unload();
+    return false;
+  }
+  return true;
+}
+//----< destroy plugin's state and free its DLL >-------------------
+
+void PluginApplication::unload()
+{
+  if (module_ == nullptr)
+    return;
+  flush();
+  if (plugin_.destroy && state_)
+    plugin_.destroy(state_);
+  state_ = nullptr;
+  plugin_ = DxPlugin();
+  ::FreeLibrary(static_cast<HMODULE>(module_));
+  module_ = nullptr;
+}
+//----< pass batch of one dir's names to plugin's doFiles >---------
+
+void PluginApplication::flush()
+{
+  if (starts_.size() == 0)
+    return;
+  std::vector<const char*> files;   // names_ doesn't move while these are used
+  files.reserve(starts_.size());
+  for (size_t start : starts_)
+    files.push_back(names_.data() + start);
+  plugin_.doFiles(state_, dir_.c_str(), files.data(), files.size());
+  names_.clear();
+  starts_.clear();
+}
+//----< count file and pass it to plugin, in a batch if it has one >-
+
+void PluginApplication::doFile(const std::string& filename)
+{
+  ++fileCount_;
+  if (!showAll_ && 0 < maxItems_ && maxItems_ < fileCount_)
+    return;
+  if (plugin_.doFiles)
+  {
+    starts_.push_back(names_.size());
+    names_.append(filename.c_str(), filename.size() + 1);
+    if (starts_.size() >= MaxBatch)
+      flush();
+  }
+  else if (plugin_.doFile)
+    plugin_.doFile(state_, filename.c_str());
+}
+//----< count dir and pass it to plugin, after last dir's files >---
+
+void PluginApplication::doDir(const std::string& dirname)
+{
+  flush();
+  ++dirCount_;
+  dir_ = dirname;
+  if (plugin_.doDir)
+    plugin_.doDir(state_, dirname.c_str());
+}
+//----< stop when maxItems is exceeded, or the plugin says so >-----
+
+bool PluginApplication::done()
+{
+  flush();
+  if (0 < maxItems_ && maxItems_ < fileCount_)
+    return true;
+  return plugin_.done && plugin_.done(state_) != 0;
+}
+//----< show final counts, then the plugin's results >---------------
+
+void PluginApplication::showStats()
+{
+  flush();
+  std::cout << "\n\n  processed " << fileCount_ << " files in " << dirCount_ << " directories";
+  if (0 < maxItems_ && maxItems_ < fileCount_)
+    std::cout << "\n  stopped because max number of files exceeded";
+  if (plugin_.showStats)
+    plugin_.showStats(state_);
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_PLUGINAPPLICATION  // only compile the following when defined
+
+#include "DirExplorerT.h"
+#include "../StringUtilities/StringUtilities.h"
+#include "../CodeUtilities/CodeUtilities.h"
+
+using namespace Utilities;
+using namespace FileSystem;
+
+std::string customUsage()
+{
+  std::string usage;
+  usage += "\n  Command Line: /P path /plugin dll [config] [/option]* [/p patterns]";
+  usage += "\n    path is relative or absolute path where processing begins";
+  usage += "\n    dll is a plugin built with PluginApi.h, e.g., SamplePlugin.dll";
+  usage += "\n    config is text passed to the plugin";
+  usage += "\n    [/option]* are one or more options of the form:";
+  usage += "\n      /s - walk directory recursively";
+  usage += "\n      /h - hide empty directories";
+  usage += "\n    patterns are pattern strings of the form:";
+  usage += "\n      *.h,*.cpp,*.cs,*.txt or *.*";
+  usage += "\n";
+  return usage;
+}
+
+int main(int argc, char *argv[])
+{
+  Title("Demonstrate DirExplorer-Template with a plugin, " + DirExplorerT<PluginApplication>::version());
+
+  ProcessCmdLine pcl(argc, argv);
+  pcl.usage(customUsage());
+  pcl.process();
+
+  std::vector<std::string> plugin = pcl.namedOption("plugin");
+  if (pcl.parseError() || plugin.size() == 0)
+  {
+    pcl.usage();
+    std::cout << "\n\n";
+    return 1;
+  }
+
+  DirExplorerT<PluginApplication> de(pcl.path());
+  if (!de.app().load(plugin[0], plugin.size() > 1 ? plugin[1] : ""))
+  {
+    std::cout << "\n  " << de.app().error() << "\n\n";
+    return 1;
+  }
+
+  for (auto patt : pcl.patterns())
+  {
+    de.addPattern(patt);
+  }
+
+  if (pcl.hasOption('s'))
+  {
+    de.recurse();
+  }
+
+  if (pcl.hasOption('h'))
+  {
+    de.hideEmptyDirectories(true);
+  }
+
+  de.search();
+  de.showStats();
+
+  std::cout << "\n\n";
+  return 0;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////
+// PluginApplication.h - DirExplorerT App running a plugin DLL       //
+// ver 1.0                                                           //
+// Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018           //
+///////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+*  -------------------
+*  PluginApplication is an App for DirExplorerT, like Application, whose
+*  doDir, doFile, done, and showStats run the functions of a plugin, a
+*  DLL with the C interface of PluginApi.h, loaded at run time.  Teams
+*  with their own per-file processing build it as a plugin, instead of
+*  piping an explorer's output to another process.
+*
+*  If the plugin has doFiles, file names are collected and passed to it
+*  in batches, one per dir, or MaxBatch names if a dir has more.  A
+*  batch is passed before the next doDir, done, or showStats, so the
+*  plugin sees calls in the order the explorer makes them.
+*
+*  Required Files:
+*  ---------------
+*  PluginApplication.h, PluginApplication.cpp, PluginApi.h
+*  DirExplorerT.h, FileSystem.h, FileSystem.cpp
+*
+*  Maintenance History:
+*  --------------------
+*  ver 1.0 : 18 Oct 2026
+*  - first release
+*/
+#include <string>
+#include <vector>
+#include "PluginApi.h"
+
+class PluginApplication
+{
+public:
+  static const size_t MaxBatch = 1024;
+
+  PluginApplication();
+  ~PluginApplication();
+  PluginApplication(const PluginApplication&) = delete;
+  PluginApplication& operator=(const PluginApplication&) = delete;
+
+  bool load(const std::string& dllPath, const std::string& config = "");
+  std::string error();
+
+  void doFile(const std::string& filename);
+  void doDir(const std::string& dirname);
+  size_t fileCount();
+  size_t dirCount();
+  bool done();
+  void showStats();
+
+  // configure application options
+
+  void showAllInCurrDir(bool showAllFilesInCurrDir);
+  bool showAllInCurrDir();
+  void maxItems(size_t maxItems);
+
+private:
+  void flush();
+  void unload();
+  static void write(void* context, const char* text, size_t length);
+
+  void* module_ = nullptr;        // HMODULE of the plugin's DLL
+  DxPlugin plugin_ = DxPlugin();  // copied, with functions the DLL lacks null
+  DxHost host_ = DxHost();
+  void* state_ = nullptr;
+  std::string dir_;               // of files in batch
+  std::string names_;             // batch of names, each ending in '\0'
+  std::vector<size_t> starts_;    // of each name in names_
+  size_t fileCount_ = 0;
+  size_t dirCount_ = 0;
+  size_t maxItems_ = 0;
+  bool showAll_ = false;
+  std::string error_;
+};
+
+inline std::string PluginApplication::error()
+{
+  return error_;
+}
+inline size_t PluginApplication::fileCount()
+{
+  return fileCount_;
+}
+inline size_t PluginApplication::dirCount()
+{
+  return dirCount_;
+}
+inline void PluginApplication::showAllInCurrDir(bool showAllFilesInCurrDir)
+{
+  showAll_ = showAllFilesInCurrDir;
+}
+inline bool PluginApplication::showAllInCurrDir()
+{
+  return showAll_;
+}
+inline void PluginApplication::maxItems(size_t maxItems)
+{
+  maxItems_ = maxItems;
+}
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////
+// SamplePlugin.cpp - plugin counting files by extension             //
+// ver 1.0                                                           //
+// Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018           //
+///////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+*  -------------------
+*  A plugin, built as its own DLL, that counts the files it's given by
+*  extension, and shows the counts in showStats.  Its config is the
+*  number of extensions to show, most files first, 10 by default.
+*
+*  It takes files in batches, through doFiles, and has no doFile.
+*  Build it with:
+*    cl /LD /EHsc /DBUILD_SAMPLE_PLUGIN SamplePlugin.cpp
+*  and run it with:
+*    DirExplorer-Template /P path /s /plugin SamplePlugin.dll 5
+*  where DirExplorer-Template is built with TEST_PLUGINAPPLICATION.
+*
+*  Required Files:
+*  ---------------
+*  SamplePlugin.cpp, PluginApi.h
+*
+*  Maintenance History:
+*  --------------------
+*  ver 1.0 : 18 Oct 2026
+*  - first release
+*/
+
+#ifdef BUILD_SAMPLE_PLUGIN  // only compile the following when defined
+
+#include "PluginApi.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+  struct Counts
+  {
+    DxHost host;
+    size_t show = 10;
+    size_t files = 0;
+    std::map<std::string, size_t> byExt;
+  };
+
+  void* create(const DxHost* host, const char* config)
+  {
+    Counts* counts = new Counts;
+    counts->host = *host;
+    if (config != nullptr && *config != '\0')
+      counts->show = std::strtoul(config, nullptr, 10);
+    return counts;
+  }
+
+  void destroy(void* state)
+  {
+    delete static_cast<Counts*>(state);
+  }
+
+  void doFiles(void* state, const char* dir, const char* const* files, size_t count)
+  {
+    Counts* counts = static_cast<Counts*>(state);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const char* dot = std::strrchr(files[i], '.');
+      ++counts->byExt[dot ? dot : "(none)"];
+    }
+    counts->files += count;
+  }
+
+  void showStats(void* state)
+  {
+    Counts* counts = static_cast<Counts*>(state);
+    std::vector<std::pair<std::string, size_t>> sorted(counts->byExt.begin(), counts->byExt.end());
+    std::stable_sort(sorted.begin(), sorted.end(),
+      [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b) { return a.second > b.second; });
+    std::string text = "\n  files by extension:";
+    for (size_t i = 0; i < sorted.size() && i < counts->show; ++i)
+      text += "\n    " + sorted[i].first + std::string(sorted[i].first.size() < 12 ? 12 - sorted[i].first.size() : 1, ' ')
+        + std::to_string(sorted[i].second);
+    counts->host.write(counts->host.context, text.data(), text.size());
+  }
+}
+
+extern "C" DX_PLUGIN_EXPORT const DxPlugin* DirExplorerPlugin(void)
+{
+  static DxPlugin plugin = {
+    DX_PLUGIN_ABI_VERSION, sizeof(DxPlugin), create, destroy, nullptr, nullptr, doFiles, nullptr, showStats
+  };
+  return &plugin;
+}
+
+#endif
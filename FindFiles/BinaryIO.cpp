@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////////////////////////
+// BinaryIO.cpp - compact binary encoding for FindFiles index files  //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "BinaryIO.h"
+
+#ifdef TEST_BINARYIO
+
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Testing BinaryIO";
+  std::cout << "\n ==================";
+
+  std::string buffer;
+  BinaryIO::Writer wr(buffer);
+  wr.u32(0x46464e58);
+  wr.u64(1234567890123ULL);
+  wr.varint(300);
+  wr.str("FindFiles");
+  std::cout << "\n  encoded " << buffer.size() << " bytes";
+
+  BinaryIO::Reader rd(buffer);
+  std::cout << "\n  u32    = " << std::hex << rd.u32() << std::dec;
+  std::cout << "\n  u64    = " << rd.u64();
+  std::cout << "\n  varint = " << rd.varint();
+  std::cout << "\n  str    = " << rd.str();
+  std::cout << "\n  good   = " << std::boolalpha << rd.good();
+  rd.u32();
+  std::cout << "\n  after reading past end, good = " << rd.good();
+
+  std::string fileSpec = "BinaryIO.test";
+  if (BinaryIO::writeFile(fileSpec, buffer))
+  {
+    std::string copy;
+    BinaryIO::readFile(fileSpec, copy);
+    std::cout << "\n  round trip through " << fileSpec << ": " << (copy == buffer ? "same" : "different");
+    FileSystem::File::remove(fileSpec);
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,274 @@
+#ifndef BINARYIO_H
+#define BINARYIO_H
+///////////////////////////////////////////////////////////////////////
+// BinaryIO.h - compact binary encoding for FindFiles index files    //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Provides the small set of encoding helpers shared by the FindFiles
+ * index packages:
+ * - Writer appends little-endian integers, varints, and length-prefixed
+ *   strings to a std::string buffer.
+ * - Reader decodes the same values from a byte range, e.g., a file
+ *   loaded into memory or a memory-mapped view, without copying.
+ * - readFile and writeFile move whole buffers to and from disk.
+ *   writeFile writes a temporary and renames it over the target, so
+ *   readers never see a partly written file.
+ * - fnv1a hashes bytes, for cache keys, tokens, and checksums, and
+ *   hexHash names files by the hash of their text.
+ *
+ * Required Files:
+ * ---------------
+ * BinaryIO.h, BinaryIO.cpp (needed only for testing)
+ * FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.2 : 18 Oct 2026
+ * - added fnv1a and hexHash, shared by the packages that each had
+ *   a copy of them
+ * Ver 1.1 : 18 Oct 2026
+ * - added u16, for compressed bitmap containers
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ *
+ * Notes:
+ * ------
+ * - Designed to provide all functionality in header file.
+ * - Implementation file only needed for test and demo.
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include "FileSystem.h"
+
+namespace BinaryIO
+{
+  /////////////////////////////////////////////////////////////////////
+  // Writer class
+  // - appends encoded values to a byte buffer
+
+  class Writer
+  {
+  public:
+    Writer(std::string& buffer) : buf_(buffer) {}
+    void u8(uint8_t v) { buf_.push_back(static_cast<char>(v)); }
+    void u16(uint16_t v);
+    void u32(uint32_t v);
+    void u64(uint64_t v);
+    void varint(uint64_t v);
+    void str(const std::string& s);
+    void bytes(const char* p, size_t n) { buf_.append(p, n); }
+    size_t size() const { return buf_.size(); }
+  private:
+    std::string& buf_;
+  };
+
+  inline void Writer::u16(uint16_t v)
+  {
+    buf_.push_back(static_cast<char>(v & 0xff));
+    buf_.push_back(static_cast<char>(v >> 8));
+  }
+
+  inline void Writer::u32(uint32_t v)
+  {
+    for (int i = 0; i < 4; ++i)
+      buf_.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+  }
+
+  inline void Writer::u64(uint64_t v)
+  {
+    for (int i = 0; i < 8; ++i)
+      buf_.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+  }
+  //----< seven bits per byte, high bit set on all but last byte >-----
+
+  inline void Writer::varint(uint64_t v)
+  {
+    while (v >= 0x80)
+    {
+      buf_.push_back(static_cast<char>((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+    buf_.push_back(static_cast<char>(v));
+  }
+
+  inline void Writer::str(const std::string& s)
+  {
+    varint(s.size());
+    buf_.append(s);
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // Reader class
+  // - decodes values from [beg, end), failing softly on truncation
+
+  class Reader
+  {
+  public:
+    Reader(const char* beg, const char* end) : pos_(beg), end_(end) {}
+    Reader(const std::string& buffer) : pos_(buffer.data()), end_(buffer.data() + buffer.size()) {}
+    uint8_t u8();
+    uint16_t u16();
+    uint32_t u32();
+    uint64_t u64();
+    uint64_t varint();
+    std::string str();
+    const char* bytes(size_t n);
+    const char* pos() const { return pos_; }
+    void skip(size_t n) { bytes(n); }
+    bool good() const { return good_; }
+    bool atEnd() const { return pos_ >= end_; }
+  private:
+    const char* pos_;
+    const char* end_;
+    bool good_ = true;
+  };
+
+  inline const char* Reader::bytes(size_t n)
+  {
+    if (static_cast<size_t>(end_ - pos_) < n)
+    {
+      good_ = false;
+      pos_ = end_;
+      return nullptr;
+    }
+    const char* p = pos_;
+    pos_ += n;
+    return p;
+  }
+
+  inline uint8_t Reader::u8()
+  {
+    const char* p = bytes(1);
+    return p ? static_cast<uint8_t>(*p) : 0;
+  }
+
+  inline uint16_t Reader::u16()
+  {
+    const char* p = bytes(2);
+    if (!p)
+      return 0;
+    return static_cast<uint16_t>(static_cast<uint8_t>(p[0]) | static_cast<uint8_t>(p[1]) << 8);
+  }
+
+  inline uint32_t Reader::u32()
+  {
+    const char* p = bytes(4);
+    if (!p)
+      return 0;
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i)
+      v = (v << 8) | static_cast<uint8_t>(p[i]);
+    return v;
+  }
+
+  inline uint64_t Reader::u64()
+  {
+    const char* p = bytes(8);
+    if (!p)
+      return 0;
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+      v = (v << 8) | static_cast<uint8_t>(p[i]);
+    return v;
+  }
+
+  inline uint64_t Reader::varint()
+  {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64 && pos_ < end_; shift += 7)
+    {
+      uint8_t b = static_cast<uint8_t>(*pos_++);
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0)
+        return v;
+    }
+    good_ = false;
+    return v;
+  }
+
+  inline std::string Reader::str()
+  {
+    size_t n = static_cast<size_t>(varint());
+    const char* p = bytes(n);
+    return p ? std::string(p, n) : std::string();
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // whole file helpers
+
+  inline bool readFile(const std::string& fileSpec, std::string& buffer)
+  {
+    std::ifstream in(fileSpec, std::ios::in | std::ios::binary);
+    if (!in.good())
+      return false;
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    buffer.resize(static_cast<size_t>(size));
+    in.read(&buffer[0], size);
+    return in.good() || in.eof();
+  }
+  //----< write to temporary, then rename over fileSpec >--------------
+
+  inline bool writeFile(const std::string& fileSpec, const std::string& buffer)
+  {
+    std::string temp = fileSpec + ".tmp";
+    {
+      std::ofstream out(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!out.good())
+        return false;
+      out.write(buffer.data(), buffer.size());
+      if (!out.good())
+        return false;
+    }
+    return FileSystem::File::move(temp, fileSpec);
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // hashes
+
+  const uint64_t FnvBasis = 14695981039346656037ULL;
+
+  //----< 64 bit FNV-1a of n bytes, continuing from hash h >----------
+
+  inline uint64_t fnv1a(const char* p, size_t n, uint64_t h = FnvBasis)
+  {
+    for (size_t i = 0; i < n; ++i)
+      h = (h ^ static_cast<uint8_t>(p[i])) * 1099511628211ULL;
+    return h;
+  }
+
+  inline uint64_t fnv1a(const std::string& text)
+  {
+    return fnv1a(text.data(), text.size());
+  }
+  //----< 32 bit FNV-1a, for checksums already on disk in that form >-
+
+  inline uint32_t fnv1a32(const char* p, size_t n)
+  {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i)
+      h = (h ^ static_cast<uint8_t>(p[i])) * 16777619u;
+    return h;
+  }
+  //----< fnv1a of text as 16 hex digits, e.g., for a file name >------
+
+  inline std::string hexHash(const std::string& text)
+  {
+    uint64_t h = fnv1a(text);
+    const char* digits = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (size_t i = 16; i-- > 0; h >>= 4)
+      hex[i] = digits[h & 15];
+    return hex;
+  }
+}
+#endif
@@ -0,0 +1,465 @@
+///////////////////////////////////////////////////////////////////////
+// ContentIndex.cpp - persistent trigram index of file contents      //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Index file layout, all integers little-endian:
+ *   header     : magic "FFCI", version, fileCount, trigramCount,
+ *                offsets of the four sections below
+ *   file table : per file - path, size, last write time, flags
+ *   directory  : per trigram, sorted - trigram, postings offset, count
+ *   postings   : per trigram - varint deltas of file ids
+ *   forward    : per file - count, varint deltas of its trigrams
+ * Queries read everything before the forward section.  Refreshes read
+ * the whole file.
+ */
+
+#include "ContentIndex.h"
+#include "Decompressor.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+#include <set>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace
+{
+  const uint32_t Magic = 0x49434646;   // "FFCI"
+  const uint32_t Version = 1;
+  const size_t HeaderSize = 48;
+  const size_t DirEntrySize = 16;
+
+  struct Header
+  {
+    uint32_t fileCount = 0;
+    uint32_t trigramCount = 0;
+    uint64_t fileTable = 0;
+    uint64_t directory = 0;
+    uint64_t postings = 0;
+    uint64_t forward = 0;
+  };
+
+  bool readHeader(BinaryIO::Reader& rd, Header& hdr)
+  {
+    if (rd.u32() != Magic || rd.u32() != Version)
+      return false;
+    hdr.fileCount = rd.u32();
+    hdr.trigramCount = rd.u32();
+    hdr.fileTable = rd.u64();
+    hdr.directory = rd.u64();
+    hdr.postings = rd.u64();
+    hdr.forward = rd.u64();
+    return rd.good();
+  }
+  //----< do header's counts and offsets fit a file of fileSize bytes? >
+  /*
+   *  Sections are in order and inside the file, the directory's entries
+   *  fit before the postings, and each file's record, at least a length,
+   *  size, time, and flags, fits in the file table.
+   */
+  bool validHeader(const Header& hdr, uint64_t fileSize)
+  {
+    const uint64_t MinFileRec = 18;
+    return HeaderSize <= hdr.fileTable && hdr.fileTable <= hdr.directory && hdr.directory <= hdr.postings &&
+      hdr.postings <= hdr.forward && hdr.forward <= fileSize &&
+      hdr.directory + static_cast<uint64_t>(hdr.trigramCount) * DirEntrySize <= hdr.postings &&
+      hdr.fileCount <= (hdr.directory - hdr.fileTable) / MinFileRec;
+  }
+}
+//----< construct for named index file >-----------------------------
+
+ContentIndex::ContentIndex(const Path& indexFile) : indexFile_(indexFile) {}
+
+//----< index kept at root of indexed tree, by default >-------------
+
+ContentIndex::Path ContentIndex::defaultFile(const Path& root)
+{
+  return FileSystem::Path::fileSpec(root, "FindFiles.cidx");
+}
+//----< load whole index, including per-file trigram lists >---------
+
+bool ContentIndex::load()
+{
+  files_.clear();
+  std::string buffer;
+  if (!BinaryIO::readFile(indexFile_, buffer))
+    return false;   // no index yet, refresh builds one
+
+  BinaryIO::Reader rd(buffer);
+  Header hdr;
+  if (!readHeader(rd, hdr))
+  {
+    error_ = indexFile_ + " is not a content index";
+    return false;
+  }
+  if (!validHeader(hdr, buffer.size()))
+  {
+    error_ = indexFile_ + " is damaged";
+    return false;
+  }
+  BinaryIO::Reader table(buffer.data() + hdr.fileTable, buffer.data() + hdr.directory);
+  BinaryIO::Reader fwd(buffer.data() + hdr.forward, buffer.data() + buffer.size());
+  files_.resize(hdr.fileCount);
+  for (auto& rec : files_)
+  {
+    rec.path = table.str();
+    rec.size = table.u64();
+    rec.time = table.u64();
+    rec.binary = (table.u8() & 1) != 0;
+    uint64_t count = fwd.varint();
+    uint32_t tg = 0;
+    if (count > static_cast<uint64_t>(buffer.data() + buffer.size() - fwd.pos()))
+    {
+      fwd.skip(buffer.size());   // a varint per trigram can't fit, so fwd is no longer good
+      break;
+    }
+    rec.trigrams.reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      tg += static_cast<uint32_t>(fwd.varint());
+      rec.trigrams.push_back(tg);
+    }
+  }
+  if (!table.good() || !fwd.good())
+  {
+    error_ = indexFile_ + " is truncated";
+    files_.clear();
+    return false;
+  }
+  return true;
+}
+//----< bring index up to date with the tree rooted at root >--------
+/*
+ *  A file whose size and last write time match its index entry is
+ *  assumed unchanged and is not opened.
+ */
+void ContentIndex::refresh(const Path& root, const Patterns& patterns, bool recurse)
+{
+  std::unordered_map<Path, size_t> old;
+  for (size_t i = 0; i < files_.size(); ++i)
+    old[files_[i].path] = i;
+  std::vector<FileRec> oldFiles;
+  oldFiles.swap(files_);
+
+  stats_ = Stats();
+  walk(root, patterns, recurse, old, oldFiles);
+  stats_.removed = old.size();
+  stats_.files = files_.size();
+}
+//----< depth first walk, reusing unchanged entries >----------------
+
+void ContentIndex::walk(
+  const Path& dir, const Patterns& patterns, bool recurse,
+  std::unordered_map<Path, size_t>& old, std::vector<FileRec>& oldFiles
+)
+{
+  std::set<std::string> seen;   // patterns may overlap, e.g., *.h and *.*
+  for (auto patt : patterns)
+  {
+    for (auto entry : FileSystem::Directory::getEntries(dir, patt))
+    {
+      if (entry.isDir || !seen.insert(entry.name).second)
+        continue;
+      Path path = dir + "\\" + entry.name;
+      if (path == indexFile_)
+        continue;
+      auto iter = old.find(path);
+      if (iter != old.end())
+      {
+        FileRec& prev = oldFiles[iter->second];
+        size_t index = iter->second;
+        old.erase(iter);
+        if (prev.size == entry.size && prev.time == entry.time)
+        {
+          ++stats_.reused;
+          if (prev.binary)
+            ++stats_.binary;
+          files_.push_back(std::move(oldFiles[index]));
+          continue;
+        }
+      }
+      FileRec rec;
+      rec.path = path;
+      rec.size = entry.size;
+      rec.time = entry.time;
+      rec.binary = false;
+      if (!extract(rec))
+        continue;   // unreadable, leave out of index
+      ++stats_.indexed;
+      if (rec.binary)
+        ++stats_.binary;
+      files_.push_back(std::move(rec));
+    }
+  }
+  if (!recurse)
+    return;
+  for (auto entry : FileSystem::Directory::getEntries(dir))
+  {
+    if (entry.isDir)
+      walk(dir + "\\" + entry.name, patterns, recurse, old, oldFiles);
+  }
+}
+//----< read file once, collecting its distinct trigrams >-----------
+/*
+ *  Trigrams spanning line ends are skipped, since /C matches lines.
+ *  A bitmap of all 2^24 trigrams is reused across files, and only
+ *  the bits set for this file are cleared afterwards.
+ */
+bool ContentIndex::extract(FileRec& rec)
+{
+  thread_local Decompressor dc;
+  thread_local std::vector<uint64_t> bits(1 << 18);
+  if (!dc.open(rec.path))
+    return false;
+
+  const size_t BufSize = 64 * 1024;
+  std::vector<char> buffer(BufSize + 2);
+  size_t carry = 0;   // last two bytes of previous block
+  size_t n = 0;
+  bool first = true;
+  while ((n = dc.read(buffer.data() + carry, BufSize)) > 0)
+  {
+    if (first && std::memchr(buffer.data(), '\0', n) != nullptr)
+    {
+      rec.binary = true;
+      break;
+    }
+    first = false;
+    size_t end = carry + n;
+    for (size_t i = 0; i + 2 < end; ++i)
+    {
+      const char* p = buffer.data() + i;
+      if (p[0] == '\n' || p[1] == '\n' || p[2] == '\n' || p[0] == '\r' || p[1] == '\r' || p[2] == '\r')
+        continue;
+      uint32_t tg = TrigramQuery::make(p[0], p[1], p[2]);
+      uint64_t mask = 1ULL << (tg & 63);
+      if ((bits[tg >> 6] & mask) == 0)
+      {
+        bits[tg >> 6] |= mask;
+        rec.trigrams.push_back(tg);
+      }
+    }
+    carry = (std::min)(end, static_cast<size_t>(2));
+    std::memmove(buffer.data(), buffer.data() + end - carry, carry);
+  }
+  dc.close();
+  for (auto tg : rec.trigrams)
+    bits[tg >> 6] = 0;
+  if (rec.binary)
+    rec.trigrams.clear();
+  std::sort(rec.trigrams.begin(), rec.trigrams.end());
+  return true;
+}
+//----< write index, postings rebuilt from per-file trigram lists >--
+
+bool ContentIndex::save()
+{
+  std::unordered_map<TrigramQuery::Trigram, std::vector<FileId>> postings;
+  for (FileId id = 0; id < files_.size(); ++id)
+    for (auto tg : files_[id].trigrams)
+      postings[tg].push_back(id);
+  std::vector<TrigramQuery::Trigram> keys;
+  keys.reserve(postings.size());
+  for (auto& item : postings)
+    keys.push_back(item.first);
+  std::sort(keys.begin(), keys.end());
+
+  std::string table, dir, posts, fwd;
+  BinaryIO::Writer tw(table), dw(dir), pw(posts), fw(fwd);
+  for (auto& rec : files_)
+  {
+    tw.str(rec.path);
+    tw.u64(rec.size);
+    tw.u64(rec.time);
+    tw.u8(rec.binary ? 1 : 0);
+    fw.varint(rec.trigrams.size());
+    uint32_t prev = 0;
+    for (auto tg : rec.trigrams)
+    {
+      fw.varint(tg - prev);
+      prev = tg;
+    }
+  }
+  for (auto tg : keys)
+  {
+    std::vector<FileId>& ids = postings[tg];
+    dw.u32(tg);
+    dw.u64(pw.size());
+    dw.u32(static_cast<uint32_t>(ids.size()));
+    FileId prev = 0;
+    for (auto id : ids)
+    {
+      pw.varint(id - prev);
+      prev = id;
+    }
+  }
+
+  std::string buffer;
+  BinaryIO::Writer wr(buffer);
+  wr.u32(Magic);
+  wr.u32(Version);
+  wr.u32(static_cast<uint32_t>(files_.size()));
+  wr.u32(static_cast<uint32_t>(keys.size()));
+  uint64_t offset = HeaderSize;
+  wr.u64(offset);
+  wr.u64(offset += table.size());
+  wr.u64(offset += dir.size());
+  wr.u64(offset += posts.size());
+  buffer += table;
+  buffer += dir;
+  buffer += posts;
+  buffer += fwd;
+  if (!BinaryIO::writeFile(indexFile_, buffer))
+  {
+    error_ = "can't write " + indexFile_;
+    return false;
+  }
+  return true;
+}
+//----< files that may match regex, reading only what query needs >--
+
+std::vector<ContentIndex::Path> ContentIndex::candidates(const std::string& regex)
+{
+  std::vector<Path> result;
+  std::ifstream in(indexFile_, std::ios::in | std::ios::binary | std::ios::ate);
+  uint64_t fileSize = in.good() ? static_cast<uint64_t>(in.tellg()) : 0;
+  in.seekg(0);
+  std::string buffer(HeaderSize, '\0');
+  in.read(&buffer[0], HeaderSize);
+  BinaryIO::Reader hrd(buffer);
+  Header hdr;
+  if (!in.good() || !readHeader(hrd, hdr))
+  {
+    error_ = "can't read content index " + indexFile_;
+    return result;
+  }
+  if (!validHeader(hdr, fileSize))
+  {
+    error_ = indexFile_ + " is damaged";
+    return result;
+  }
+  buffer.resize(static_cast<size_t>(hdr.forward));
+  in.read(&buffer[HeaderSize], hdr.forward - HeaderSize);
+  if (!in.good())
+  {
+    error_ = indexFile_ + " is truncated";
+    return result;
+  }
+
+  std::vector<Path> paths(hdr.fileCount);
+  std::vector<bool> binary(hdr.fileCount);
+  BinaryIO::Reader table(buffer.data() + hdr.fileTable, buffer.data() + hdr.directory);
+  for (size_t i = 0; i < paths.size(); ++i)
+  {
+    paths[i] = table.str();
+    table.skip(16);
+    binary[i] = (table.u8() & 1) != 0;
+  }
+  if (!table.good())
+  {
+    error_ = indexFile_ + " is damaged";
+    return result;
+  }
+
+  TrigramQuery query(regex);
+  if (query.matchesAll())
+  {
+    for (size_t i = 0; i < paths.size(); ++i)
+      if (!binary[i])
+        result.push_back(paths[i]);
+    return result;
+  }
+
+  const char* dirBeg = buffer.data() + hdr.directory;
+  bool damaged = false;
+  auto postings = [&](TrigramQuery::Trigram tg) {
+    TrigramQuery::Ids ids;
+    size_t lo = 0, hi = hdr.trigramCount;
+    while (lo < hi)   // binary search fixed size directory entries
+    {
+      size_t mid = (lo + hi) / 2;
+      BinaryIO::Reader ent(dirBeg + mid * DirEntrySize, dirBeg + (mid + 1) * DirEntrySize);
+      uint32_t key = ent.u32();
+      if (key < tg)
+        lo = mid + 1;
+      else if (key > tg)
+        hi = mid;
+      else
+      {
+        uint64_t offset = ent.u64();
+        uint32_t count = ent.u32();
+        if (offset > hdr.forward - hdr.postings || count > hdr.forward - hdr.postings - offset)
+        {
+          damaged = true;   // postings, a varint per id, can't fit
+          break;
+        }
+        BinaryIO::Reader prd(buffer.data() + hdr.postings + offset, buffer.data() + hdr.forward);
+        uint64_t id = 0;
+        ids.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+          id += prd.varint();
+          if (!prd.good() || id >= paths.size())
+          {
+            damaged = true;
+            ids.clear();
+            break;
+          }
+          ids.push_back(static_cast<FileId>(id));
+        }
+        break;
+      }
+    }
+    return ids;
+  };
+  TrigramQuery::Ids ids = query.candidates(postings);
+  if (damaged)
+  {
+    error_ = indexFile_ + " is damaged";
+    return result;
+  }
+  for (auto id : ids)
+    result.push_back(paths[id]);
+  return result;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_CONTENTINDEX
+
+#include <iostream>
+#include "../CppUtilities/StringUtilities/StringUtilities.h"
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing ContentIndex";
+  std::cout << "\n ======================";
+  if (argc < 3)
+  {
+    std::cout << "\n  usage: ContentIndex root patterns [regex]\n\n";
+    return 1;
+  }
+  std::string root = FileSystem::Path::getFullFileSpec(argv[1]);
+  ContentIndex ci(ContentIndex::defaultFile(root));
+  ci.load();
+  for (int pass = 1; pass <= 2; ++pass)
+  {
+    ci.refresh(root, Utilities::split(std::string(argv[2])), true);
+    ci.save();
+    ContentIndex::Stats st = ci.stats();
+    std::cout << "\n  refresh " << pass << ": " << st.files << " files, " << st.indexed << " read, "
+      << st.reused << " reused, " << st.removed << " removed, " << st.binary << " binary";
+  }
+  if (argc > 3)
+  {
+    std::vector<std::string> files = ci.candidates(argv[3]);
+    std::cout << "\n  " << files.size() << " candidates for " << argv[3];
+    for (auto file : files)
+      std::cout << "\n    " << file;
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
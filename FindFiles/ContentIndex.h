@@ -0,0 +1,120 @@
+#ifndef CONTENTINDEX_H
+#define CONTENTINDEX_H
+///////////////////////////////////////////////////////////////////////
+// ContentIndex.h - persistent trigram index of file contents        //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * ContentIndex keeps, on disk, the trigrams of every text file matched
+ * by FindFiles /p patterns, so repeated content searches, /C regex,
+ * read only the files that can possibly match.
+ * - refresh(...) walks the tree and compares each file's size and last
+ *   write time with the index.  Only new and changed files are read.
+ *   Files no longer present are dropped.
+ * - save() writes the index: a file table, a sorted trigram directory,
+ *   delta encoded posting lists, and each file's own trigram list.
+ *   The per-file lists let the next refresh rebuild postings without
+ *   re-reading unchanged files.
+ * - candidates(regex) reads only the file table and the postings the
+ *   regex needs, intersecting them with TrigramQuery.  Callers verify
+ *   candidates with TextSearcher.
+ * - Binary files, those with a NUL byte, are recorded but not indexed.
+ *   Compressed files are indexed on their uncompressed text.
+ *
+ * Public Interface:
+ * -----------------
+ * ContentIndex ci(ContentIndex::defaultFile(root));
+ * ci.load();
+ * ci.refresh(root, patterns, true);
+ * ci.save();
+ * std::vector<std::string> files = ci.candidates("threads|sockets");
+ *
+ * Required Files:
+ * ---------------
+ * ContentIndex.h, ContentIndex.cpp
+ * Trigram.h, Trigram.cpp
+ * Decompressor.h, Decompressor.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - a damaged index's offsets, counts, and file ids are rejected
+ *   instead of trusted
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Trigram.h"
+
+class ContentIndex
+{
+public:
+  using Path = std::string;
+  using Pattern = std::string;
+  using Patterns = std::vector<Pattern>;
+  using Trigrams = TrigramQuery::Trigrams;
+  using FileId = TrigramQuery::Id;
+
+  struct Stats
+  {
+    size_t files = 0;     // files in index after refresh
+    size_t reused = 0;    // unchanged, not read
+    size_t indexed = 0;   // new or changed, read
+    size_t removed = 0;   // no longer present
+    size_t binary = 0;    // present but not indexed
+  };
+
+  ContentIndex(const Path& indexFile);
+  static Path defaultFile(const Path& root);
+
+  bool load();
+  void refresh(const Path& root, const Patterns& patterns, bool recurse);
+  bool save();
+  std::vector<Path> candidates(const std::string& regex);
+
+  Path indexFile();
+  Stats stats();
+  std::string error();
+private:
+  struct FileRec
+  {
+    Path path;
+    uint64_t size;
+    uint64_t time;
+    bool binary;
+    Trigrams trigrams;
+  };
+  void walk(const Path& dir, const Patterns& patterns, bool recurse,
+            std::unordered_map<Path, size_t>& old, std::vector<FileRec>& oldFiles);
+  bool extract(FileRec& rec);
+
+  Path indexFile_;
+  std::vector<FileRec> files_;
+  Stats stats_;
+  std::string error_;
+};
+
+inline ContentIndex::Path ContentIndex::indexFile()
+{
+  return indexFile_;
+}
+
+inline ContentIndex::Stats ContentIndex::stats()
+{
+  return stats_;
+}
+
+inline std::string ContentIndex::error()
+{
+  return error_;
+}
+
+#endif
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////
+// Continuation.cpp - saves the unvisited dirs of a walk cut short   //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Continuation file layout, all integers little-endian:
+ *   magic "FFCT", version, varint length and query, varint dir count,
+ *   then per dir, in frontier order - varint length and path
+ */
+
+#include "Continuation.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+#include <chrono>
+
+namespace
+{
+  const uint32_t Magic = 0x54434646;   // "FFCT"
+  const uint32_t Version = 1;
+
+  bool isToken(const std::string& token)
+  {
+    return token.size() == 16 && token.find_first_not_of("0123456789abcdef") == std::string::npos;
+  }
+}
+//----< continuations kept in files of dir >--------------------------
+
+Continuation::Continuation(const Path& dir) : dir_(dir) {}
+
+Continuation::Path Continuation::file(const std::string& token) const
+{
+  return FileSystem::Path::fileSpec(dir_, "FindFiles-" + token + ".resume");
+}
+//----< save query's frontier; its token, or empty on failure >------
+/*
+ *  The token hashes the query with the time, so successive stops of
+ *  one query get different tokens.
+ */
+std::string Continuation::save(const std::string& query, const Frontier& frontier)
+{
+  auto now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::string token = BinaryIO::hexHash(query + "\n" + std::to_string(now));
+  std::string buffer;
+  BinaryIO::Writer wr(buffer);
+  wr.u32(Magic);
+  wr.u32(Version);
+  wr.str(query);
+  wr.varint(frontier.size());
+  for (auto& dir : frontier)
+    wr.str(dir);
+  if (!FileSystem::Directory::exists(dir_))
+    FileSystem::Directory::create(dir_);
+  if (!BinaryIO::writeFile(file(token), buffer))
+  {
+    error_ = "can't write " + file(token);
+    return "";
+  }
+  return token;
+}
+//----< frontier saved as token, if saved for query >-----------------
+
+bool Continuation::load(const std::string& token, const std::string& query, Frontier& frontier)
+{
+  frontier.clear();
+  std::string buffer;
+  if (!isToken(token) || !FileSystem::File::exists(file(token)) || !BinaryIO::readFile(file(token), buffer))
+  {
+    error_ = "no walk to resume for " + token + ", it may have been resumed already";
+    return false;
+  }
+  BinaryIO::Reader rd(buffer);
+  if (rd.u32() != Magic || rd.u32() != Version)
+  {
+    error_ = file(token) + " is damaged";
+    return false;
+  }
+  if (rd.str() != query)
+  {
+    error_ = token + " continues a different query, use it with the same path, /p, /R, /f, /d, /s, and /M";
+    return false;
+  }
+  uint64_t count = rd.varint();
+  for (uint64_t i = 0; i < count && rd.good(); ++i)
+    frontier.push_back(rd.str());
+  if (!rd.good())
+  {
+    frontier.clear();
+    error_ = file(token) + " is damaged";
+    return false;
+  }
+  FileSystem::File::remove(file(token));
+  return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_CONTINUATION
+
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Testing Continuation";
+  std::cout << "\n ======================";
+
+  Continuation cont(".");
+  Continuation::Frontier frontier{ "C:\\src\\b", "C:\\src\\a" };
+  std::string token = cont.save("c:\\src\n*.h,\n.*\nfs", frontier);
+  std::cout << "\n  saved " << frontier.size() << " dirs as " << token;
+
+  Continuation::Frontier loaded;
+  if (!cont.load(token, "c:\\other\n*.h,\n.*\nfs", loaded))
+    std::cout << "\n  " << cont.error();
+  if (cont.load(token, "c:\\src\n*.h,\n.*\nfs", loaded))
+    std::cout << "\n  loaded " << loaded.size() << " dirs, next is " << loaded.back();
+  if (!cont.load(token, "c:\\src\n*.h,\n.*\nfs", loaded))
+    std::cout << "\n  " << cont.error();
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
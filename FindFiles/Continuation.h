@@ -0,0 +1,68 @@
+#ifndef CONTINUATION_H
+#define CONTINUATION_H
+///////////////////////////////////////////////////////////////////////
+// Continuation.h - saves the unvisited dirs of a walk cut short     //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * An editor asking for files below a huge tree wants what can be found
+ * in, say, 50 ms, then the rest if the user keeps looking.  A walk
+ * stopped at its deadline has a frontier, the dirs it has yet to
+ * visit, in the order it would visit them.  Continuation saves that
+ * frontier, with the query it belongs to, and returns a token naming
+ * it.  Loading the token gives back the frontier, so a later run of
+ * the same query picks up where the stopped one left off, visiting
+ * each remaining dir once.
+ *
+ * A token is 16 hex digits.  Its frontier is kept in a file of the
+ * continuation dir named by the token, and is removed when loaded, so
+ * a token may be used once.  Loading checks that the token was saved
+ * for the same query.
+ *
+ * Public Interface:
+ * -----------------
+ * Continuation cont(QueryCache::defaultDir());
+ * std::string token = cont.save(query, frontier);
+ * ...
+ * if (!cont.load(token, query, frontier)) ... cont.error() ...
+ *
+ * Required Files:
+ * ---------------
+ * Continuation.h, Continuation.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+
+class Continuation
+{
+public:
+  using Path = std::string;
+  using Frontier = std::vector<Path>;   // last is visited first
+
+  Continuation(const Path& dir);
+  std::string save(const std::string& query, const Frontier& frontier);
+  bool load(const std::string& token, const std::string& query, Frontier& frontier);
+  std::string error() const;
+private:
+  Path file(const std::string& token) const;
+
+  Path dir_;
+  std::string error_;
+};
+
+inline std::string Continuation::error() const
+{
+  return error_;
+}
+
+#endif
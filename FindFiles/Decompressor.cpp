@@ -0,0 +1,271 @@
+///////////////////////////////////////////////////////////////////////
+// Decompressor.cpp - streams text out of plain, gzip, or zstd files //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "Decompressor.h"
+#include <cstring>
+#include <cctype>
+
+namespace
+{
+  const size_t InBufSize = 128 * 1024;
+
+  bool endsWith(const std::string& str, const std::string& tail)
+  {
+    if (str.size() < tail.size())
+      return false;
+    for (size_t i = 0; i < tail.size(); ++i)
+    {
+      if (::tolower(str[str.size() - tail.size() + i]) != tail[i])
+        return false;
+    }
+    return true;
+  }
+}
+//----< contexts are created lazily, on first file of each format >--
+
+Decompressor::Decompressor() : inBuf_(InBufSize) {}
+
+//----< release decompressor contexts >------------------------------
+
+Decompressor::~Decompressor()
+{
+  close();
+#ifdef HAVE_ZLIB
+  if (zsInit_)
+    inflateEnd(&zs_);
+#endif
+#ifdef HAVE_ZSTD
+  if (zctx_)
+    ZSTD_freeDCtx(zctx_);
+#endif
+}
+//----< select format from file extension >--------------------------
+
+Decompressor::Format Decompressor::formatOf(const std::string& fileSpec)
+{
+  if (endsWith(fileSpec, ".gz"))
+    return gzip;
+  if (endsWith(fileSpec, ".zst"))
+    return zstd;
+  return plain;
+}
+//----< was support for this format compiled in? >-------------------
+
+bool Decompressor::supports(Format fmt)
+{
+  switch (fmt)
+  {
+  case gzip:
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  case zstd:
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  default:
+    return true;
+  }
+}
+//----< open file and reset the context for its format >-------------
+
+bool Decompressor::open(const std::string& fileSpec)
+{
+  close();
+  fmt_ = formatOf(fileSpec);
+  if (!supports(fmt_))
+  {
+    error_ = fmt_ == gzip ? "built without zlib, needed for .gz files" : "built without zstd, needed for .zst files";
+    return false;
+  }
+  in_.open(fileSpec, std::ios::in | std::ios::binary);
+  if (!in_.good())
+  {
+    error_ = "can't open " + fileSpec;
+    return false;
+  }
+#ifdef HAVE_ZLIB
+  if (fmt_ == gzip)
+  {
+    if (!zsInit_)
+    {
+      std::memset(&zs_, 0, sizeof(zs_));
+      if (inflateInit2(&zs_, 15 + 32) != Z_OK)  // 15 + 32: detect gzip header
+      {
+        error_ = "can't initialize zlib";
+        return false;
+      }
+      zsInit_ = true;
+    }
+    else
+      inflateReset(&zs_);
+    zs_.next_in = nullptr;
+    zs_.avail_in = 0;
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if (fmt_ == zstd)
+  {
+    if (!zctx_)
+      zctx_ = ZSTD_createDCtx();
+    if (!zctx_)
+    {
+      error_ = "can't initialize zstd";
+      return false;
+    }
+    ZSTD_DCtx_reset(zctx_, ZSTD_reset_session_only);
+  }
+#endif
+  return true;
+}
+//----< close file, keeping contexts for reuse >---------------------
+
+void Decompressor::close()
+{
+  if (in_.is_open())
+    in_.close();
+  in_.clear();
+  inPos_ = inEnd_ = 0;
+  eof_ = false;
+  error_.clear();
+}
+//----< refill input buffer with compressed bytes >------------------
+
+bool Decompressor::fill()
+{
+  if (eof_)
+    return false;
+  in_.read(inBuf_.data(), inBuf_.size());
+  inPos_ = 0;
+  inEnd_ = static_cast<size_t>(in_.gcount());
+  if (inEnd_ < inBuf_.size())
+    eof_ = true;
+  return inEnd_ > 0;
+}
+//----< read up to size uncompressed bytes, returns 0 at end >-------
+
+size_t Decompressor::read(char* buffer, size_t size)
+{
+  if (!good() || !in_.is_open())
+    return 0;
+  if (fmt_ == gzip)
+    return readGzip(buffer, size);
+  if (fmt_ == zstd)
+    return readZstd(buffer, size);
+
+  in_.read(buffer, size);
+  return static_cast<size_t>(in_.gcount());
+}
+//----< inflate gzip members >---------------------------------------
+
+size_t Decompressor::readGzip(char* buffer, size_t size)
+{
+#ifdef HAVE_ZLIB
+  zs_.next_out = reinterpret_cast<Bytef*>(buffer);
+  zs_.avail_out = static_cast<uInt>(size);
+  while (zs_.avail_out == size)
+  {
+    if (zs_.avail_in == 0)
+    {
+      if (!fill())
+      {
+        if (zs_.total_in > 0)   // a member was begun, but not ended
+          error_ = "truncated gzip stream";
+        break;
+      }
+      zs_.next_in = reinterpret_cast<Bytef*>(inBuf_.data());
+      zs_.avail_in = static_cast<uInt>(inEnd_);
+    }
+    int rc = inflate(&zs_, Z_NO_FLUSH);
+    if (rc == Z_STREAM_END)
+    {
+      // another gzip member may follow, e.g., from cat a.gz b.gz
+      inflateReset(&zs_);
+      continue;
+    }
+    if (rc != Z_OK && rc != Z_BUF_ERROR)
+    {
+      error_ = zs_.msg ? zs_.msg : "corrupt gzip stream";
+      break;
+    }
+  }
+  return size - zs_.avail_out;
+#else
+  (void)buffer;
+  (void)size;
+  return 0;
+#endif
+}
+//----< decompress zstd frames >-------------------------------------
+
+size_t Decompressor::readZstd(char* buffer, size_t size)
+{
+#ifdef HAVE_ZSTD
+  ZSTD_outBuffer out = { buffer, size, 0 };
+  while (out.pos == 0)
+  {
+    if (inPos_ == inEnd_ && !fill())
+      break;
+    ZSTD_inBuffer in = { inBuf_.data(), inEnd_, inPos_ };
+    size_t rc = ZSTD_decompressStream(zctx_, &out, &in);
+    inPos_ = in.pos;
+    if (ZSTD_isError(rc))
+    {
+      error_ = ZSTD_getErrorName(rc);
+      break;
+    }
+  }
+  return out.pos;
+#else
+  (void)buffer;
+  (void)size;
+  return 0;
+#endif
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_DECOMPRESSOR
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing Decompressor";
+  std::cout << "\n ======================";
+  std::cout << "\n  gzip supported: " << std::boolalpha << Decompressor::supports(Decompressor::gzip);
+  std::cout << "\n  zstd supported: " << Decompressor::supports(Decompressor::zstd);
+
+  Decompressor dc;   // one context reused for every file
+  std::vector<char> buffer(64 * 1024);
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!dc.open(argv[i]))
+    {
+      std::cout << "\n  " << dc.error();
+      continue;
+    }
+    size_t bytes = 0, lines = 0, n = 0;
+    while ((n = dc.read(buffer.data(), buffer.size())) > 0)
+    {
+      bytes += n;
+      for (size_t j = 0; j < n; ++j)
+        if (buffer[j] == '\n')
+          ++lines;
+    }
+    std::cout << "\n  " << argv[i] << ": " << bytes << " bytes, " << lines << " lines";
+    if (!dc.good())
+      std::cout << " -- " << dc.error();
+    dc.close();
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
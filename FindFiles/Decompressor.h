@@ -0,0 +1,114 @@
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+///////////////////////////////////////////////////////////////////////
+// Decompressor.h - streams text out of plain, gzip, or zstd files   //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Decompressor reads a file in blocks and hands back its uncompressed
+ * bytes, so content searches can look inside rotated logs, e.g.,
+ * *.log.gz and *.log.zst, without first expanding them to disk.
+ * - Format is chosen from the file extension: .gz, .zst, or plain.
+ * - The zlib and zstd contexts are created once and reset for each
+ *   file, so one Decompressor can be reused for many files.  Content
+ *   search keeps one instance per thread.
+ * - gzip files with several concatenated members are read through.
+ *
+ * Public Interface:
+ * -----------------
+ * Decompressor dc;
+ * if (dc.open(fileSpec))
+ *   while ((n = dc.read(buffer, size)) > 0) { ... }
+ * dc.close();
+ *
+ * Build Process:
+ * --------------
+ * gzip support is compiled when HAVE_ZLIB is defined and zlib.lib is
+ * linked.  zstd support is compiled when HAVE_ZSTD is defined and
+ * zstd.lib is linked.  Both are available from vcpkg.  Without them,
+ * open(...) fails for that format, and error() says which library the
+ * build lacks, so callers can report the file as skipped.
+ *
+ * Required Files:
+ * ---------------
+ * Decompressor.h, Decompressor.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - a gzip file ending inside a member is reported as truncated
+ * - open's error for a format compiled out names the missing library
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+class Decompressor
+{
+public:
+  enum Format { plain, gzip, zstd };
+
+  Decompressor();
+  ~Decompressor();
+  Decompressor(const Decompressor&) = delete;
+  Decompressor& operator=(const Decompressor&) = delete;
+
+  static Format formatOf(const std::string& fileSpec);
+  static bool supports(Format fmt);
+
+  bool open(const std::string& fileSpec);
+  size_t read(char* buffer, size_t size);
+  bool good();
+  std::string error();
+  Format format();
+  void close();
+private:
+  bool fill();
+  size_t readGzip(char* buffer, size_t size);
+  size_t readZstd(char* buffer, size_t size);
+
+  std::ifstream in_;
+  std::vector<char> inBuf_;
+  size_t inPos_ = 0;
+  size_t inEnd_ = 0;
+  bool eof_ = false;
+  Format fmt_ = plain;
+  std::string error_;
+#ifdef HAVE_ZLIB
+  z_stream zs_;
+  bool zsInit_ = false;
+#endif
+#ifdef HAVE_ZSTD
+  ZSTD_DCtx* zctx_ = nullptr;
+#endif
+};
+
+inline bool Decompressor::good()
+{
+  return error_.size() == 0;
+}
+
+inline std::string Decompressor::error()
+{
+  return error_;
+}
+
+inline Decompressor::Format Decompressor::format()
+{
+  return fmt_;
+}
+
+#endif
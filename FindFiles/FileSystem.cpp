@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////////
 // FileSystem.cpp - Support file and directory operations                  //
-// ver 2.2                                                                 //
+// ver 2.7                                                                 //
 // ----------------------------------------------------------------------- //
 // copyright  Jim Fawcett, 2012                                           //
 // All rights granted provided that this notice is retained                //
@@ -264,6 +264,12 @@ bool File::copy(const std::string& src, const std::string& dst, bool failIfExist
 {
   return ::CopyFileA(src.c_str(), dst.c_str(), failIfExists) != 0;
 }
+//----< move file, replacing dst if it exists >------------------------
+
+bool File::move(const std::string& src, const std::string& dst)
+{
+  return ::MoveFileExA(src.c_str(), dst.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
 //----< remove file >--------------------------------------------------
 
 bool File::remove(const std::string& file)
@@ -278,7 +284,10 @@ FileInfo::FileInfo(const std::string& fileSpec)
   if(hFile == INVALID_HANDLE_VALUE)
     good_ = false;
   else
+  {
     good_ = true;
+    ::FindClose(hFile);
+  }
 }
 //----< is passed filespec valid? >------------------------------------
 
@@ -304,11 +313,19 @@ std::string FileInfo::intToString(long i)
 //----< return file date >---------------------------------------------
 
 std::string FileInfo::date(dateFormat df) const
+{
+  return dateOf(time(), df);
+}
+//----< format last write time, 100 ns ticks since 1601, UTC >---------
+
+std::string FileInfo::dateOf(unsigned long long time, dateFormat df)
 {
   std::string dateStr, timeStr;
-  FILETIME ft;
+  FILETIME utc, ft;
   SYSTEMTIME st;
-  ::FileTimeToLocalFileTime(&data.ftLastWriteTime, &ft);
+  utc.dwLowDateTime = (DWORD)(time & 0xffffffff);
+  utc.dwHighDateTime = (DWORD)(time >> 32);
+  ::FileTimeToLocalFileTime(&utc, &ft);
   ::FileTimeToSystemTime(&ft, &st);
   dateStr = intToString(st.wMonth) + '/' + intToString(st.wDay) + '/' + intToString(st.wYear);
   timeStr = intToString(st.wHour) + ':' + intToString(st.wMinute) + ':' + intToString(st.wSecond);
@@ -318,11 +335,41 @@ std::string FileInfo::date(dateFormat df) const
     return timeStr;
   return dateStr + " " + timeStr;
 }
+//----< local date and time as 100 ns ticks since 1601, UTC >--------
+
+unsigned long long FileInfo::timeOf(int year, int month, int day, int hour, int minute, int second)
+{
+  SYSTEMTIME st = { 0 };
+  FILETIME local, utc;
+  st.wYear = (WORD)year;
+  st.wMonth = (WORD)month;
+  st.wDay = (WORD)day;
+  st.wHour = (WORD)hour;
+  st.wMinute = (WORD)minute;
+  st.wSecond = (WORD)second;
+  if (!::SystemTimeToFileTime(&st, &local) || !::LocalFileTimeToFileTime(&local, &utc))
+    return 0;
+  return ((unsigned long long)utc.dwHighDateTime << 32) + utc.dwLowDateTime;
+}
+//----< current time, 100 ns ticks since 1601, UTC >------------------
+
+unsigned long long FileInfo::now()
+{
+  FILETIME utc;
+  ::GetSystemTimeAsFileTime(&utc);
+  return ((unsigned long long)utc.dwHighDateTime << 32) + utc.dwLowDateTime;
+}
+//----< return last write time, 100 ns ticks since 1601, UTC >--------
+
+unsigned long long FileInfo::time() const
+{
+  return ((unsigned long long)data.ftLastWriteTime.dwHighDateTime << 32) + data.ftLastWriteTime.dwLowDateTime;
+}
 //----< return file size >---------------------------------------------
 
 size_t FileInfo::size() const
 {
-  return (size_t)(data.nFileSizeLow + (data.nFileSizeHigh << 8));
+  return (size_t)(((unsigned long long)data.nFileSizeHigh << 32) + data.nFileSizeLow);
 }
 //----< is type archive? >---------------------------------------------
 
@@ -597,6 +644,102 @@ std::vector<std::string> Directory::getDirectories(const std::string& path, cons
   }
   return dirs;
 }
+//----< get names, sizes, and times of entries matching pattern >---------
+/*
+ *  One FindFirstFileEx enumeration returns everything an index needs,
+ *  so callers don't open each file again with FileInfo.
+ *  - skips . and ..
+ */
+std::vector<Directory::Entry> Directory::getEntries(const std::string& path, const std::string& pattern)
+{
+  std::vector<Entry> entries;
+  WIN32_FIND_DATAA data;
+  HANDLE hFind = ::FindFirstFileExA(
+    Path::fileSpec(path, pattern).c_str(), FindExInfoBasic, &data,
+    FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH
+  );
+  if(hFind == INVALID_HANDLE_VALUE)
+    return entries;
+  do
+  {
+    std::string name = data.cFileName;
+    if(name == "." || name == "..")
+      continue;
+    Entry entry;
+    entry.name = name;
+    entry.isDir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    entry.size = ((unsigned long long)data.nFileSizeHigh << 32) + data.nFileSizeLow;
+    entry.time = ((unsigned long long)data.ftLastWriteTime.dwHighDateTime << 32) + data.ftLastWriteTime.dwLowDateTime;
+    entries.push_back(entry);
+  } while(::FindNextFileA(hFind, &data));
+  ::FindClose(hFind);
+  return entries;
+}
+//----< get entries with their file ids, from one enumeration >-----------
+/*
+ *  FindFirstFile doesn't return file ids, so the dir is opened and read
+ *  with GetFileInformationByHandleEx.  Ids are NTFS's 64 bit file ids.
+ *  If the dir can't be opened that way, entries come from getEntries,
+ *  with ids of 0.
+ */
+std::vector<Directory::Entry> Directory::getIdEntries(const std::string& path)
+{
+  HANDLE hDir = ::CreateFileA(
+    path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL
+  );
+  if(hDir == INVALID_HANDLE_VALUE)
+    return getEntries(path);
+  std::vector<Entry> entries;
+  std::vector<LONGLONG> buffer(64 * 1024 / sizeof(LONGLONG));   // entries are 8 byte aligned
+  FILE_INFO_BY_HANDLE_CLASS infoClass = FileIdBothDirectoryRestartInfo;
+  while(::GetFileInformationByHandleEx(hDir, infoClass, buffer.data(), (DWORD)(buffer.size() * sizeof(LONGLONG))))
+  {
+    infoClass = FileIdBothDirectoryInfo;
+    const char* pos = reinterpret_cast<const char*>(buffer.data());
+    while(true)
+    {
+      const FILE_ID_BOTH_DIR_INFO* info = reinterpret_cast<const FILE_ID_BOTH_DIR_INFO*>(pos);
+      int count = (int)(info->FileNameLength / sizeof(WCHAR));
+      int size = ::WideCharToMultiByte(CP_ACP, 0, info->FileName, count, NULL, 0, NULL, NULL);
+      std::string name(size, '\0');
+      if(size > 0)
+        ::WideCharToMultiByte(CP_ACP, 0, info->FileName, count, &name[0], size, NULL, NULL);
+      if(name != "." && name != "..")
+      {
+        Entry entry;
+        entry.name = name;
+        entry.isDir = (info->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.size = entry.isDir ? 0 : (unsigned long long)info->EndOfFile.QuadPart;
+        entry.time = (unsigned long long)info->LastWriteTime.QuadPart;
+        entry.id = (unsigned long long)info->FileId.QuadPart;
+        entries.push_back(entry);
+      }
+      if(info->NextEntryOffset == 0)
+        break;
+      pos += info->NextEntryOffset;
+    }
+  }
+  ::CloseHandle(hDir);
+  return entries;
+}
+//----< serial number of volume holding path, 0 if unknown >---------------
+
+unsigned long Directory::volumeOf(const std::string& path)
+{
+  HANDLE hDir = ::CreateFileA(
+    path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL
+  );
+  if(hDir == INVALID_HANDLE_VALUE)
+    return 0;
+  BY_HANDLE_FILE_INFORMATION info;
+  unsigned long serial = 0;
+  if(::GetFileInformationByHandle(hDir, &info))
+    serial = info.dwVolumeSerialNumber;
+  ::CloseHandle(hDir);
+  return serial;
+}
 //----< create directory >-------------------------------------------------
 
 bool Directory::create(const std::string& path)
@@ -618,6 +761,44 @@ bool Directory::remove(const std::string& path)
 {
   return ::RemoveDirectoryA(path.c_str()) == 0;
 }
+//----< map whole file, read only >---------------------------------------
+/*
+ *  An empty file can't be mapped, but is good, with size zero.
+ */
+MappedFile::MappedFile(const std::string& fileSpec)
+{
+  hFile_ = ::CreateFileA(
+    fileSpec.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL
+  );
+  if(hFile_ == INVALID_HANDLE_VALUE)
+    return;
+  LARGE_INTEGER size;
+  if(!::GetFileSizeEx(hFile_, &size))
+    return;
+  size_ = (unsigned long long)size.QuadPart;
+  if(size_ == 0)
+  {
+    good_ = true;
+    return;
+  }
+  hMap_ = ::CreateFileMappingA(hFile_, NULL, PAGE_READONLY, 0, 0, NULL);
+  if(hMap_ == NULL)
+    return;
+  data_ = static_cast<const char*>(::MapViewOfFile(hMap_, FILE_MAP_READ, 0, 0, 0));
+  good_ = (data_ != nullptr);
+}
+//----< unmap and close >--------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+  if(data_)
+    ::UnmapViewOfFile(data_);
+  if(hMap_ != NULL)
+    ::CloseHandle(hMap_);
+  if(hFile_ != INVALID_HANDLE_VALUE)
+    ::CloseHandle(hFile_);
+}
 //----< find first file >--------------------------------------------------
 
 std::string FileSystemSearch::firstFile(const std::string& path, const std::string& pattern)
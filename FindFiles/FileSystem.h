@@ -2,7 +2,7 @@
 #define FILESYSTEM_H
 /////////////////////////////////////////////////////////////////////////////
 // FileSystem.h - Support file and directory operations                    //
-// ver 2.2                                                                 //
+// ver 2.7                                                                 //
 // ----------------------------------------------------------------------- //
 // copyright  Jim Fawcett, 2012                                           //
 // All rights granted provided that this notice is retained                //
@@ -16,8 +16,8 @@
 /*
  * Module Operations:
  * ==================
- * This module provides classes, File, FileInfo, Path, Directory, and 
- * FileSystemSearch.
+ * This module provides classes, File, FileInfo, Path, Directory, 
+ * MappedFile, and FileSystemSearch.
  *
  * The File class supports opening text and binary files for either input 
  * or output.  File objects have names, get and put lines of text, get and
@@ -38,6 +38,9 @@
  * methods.  It also provides non-static methods to get and set the current
  * directory.
  *
+ * MappedFile maps a whole file, read only, into memory, so large files
+ * can be searched in place without reading them.
+ *
  * Public Interface:
  * =================
  * File f(filespec,File::in,File::binary);
@@ -60,6 +63,12 @@
  * d.setCurrentDirectory(dir);
  * std::vector<std::string> files = Directory::getFiles(path, pattern);
  * std::vector<std::string> dirs = Directory::getDirectories(path);
+ * std::vector<Directory::Entry> entries = Directory::getEntries(path);
+ * std::vector<Directory::Entry> withIds = Directory::getIdEntries(path);
+ *
+ * MappedFile mf(fileSpec);
+ * if(mf.good())
+ *   std::string firstLine(mf.data(), mf.data() + 80);
  * 
  * Required Files:
  * ===============
@@ -71,6 +80,21 @@
  *
  * Maintenance History:
  * ====================
+ * ver 2.7 : 18 Oct 2026
+ * - added Directory::getIdEntries(...), entries with file ids, and
+ *   Directory::volumeOf(...)
+ * ver 2.6 : 18 Oct 2026
+ * - added FileInfo::timeOf(...) and FileInfo::now(), inverses of dateOf
+ * ver 2.5 : 18 Oct 2026
+ * - added FileInfo::dateOf(time), for times held in indexes
+ * ver 2.4 : 18 Oct 2026
+ * - added MappedFile
+ * ver 2.3 : 18 Oct 2026
+ * - added Directory::getEntries(...) which returns names, sizes, and
+ *   times of directory entries from one enumeration
+ * - added FileInfo::time() and File::move(...)
+ * - fixed FileInfo::size() for files larger than 4 GB
+ * - fixed FileInfo leaking its find handle
  * ver 2.2 : 23 Feb 13
  * - fixed bug in Path::getExt(...) discovered by Yang Zhou and Kevin Kong
  * ver 2.1 : 07 Jun 12
@@ -133,6 +157,7 @@ namespace FileSystem
     void close();
     static bool exists(const std::string& file);
     static bool copy(const std::string& src, const std::string& dst, bool failIfExists=false);
+    static bool move(const std::string& src, const std::string& dst);
     static bool remove(const std::string& filespec);
   private:
     std::string name_;
@@ -156,6 +181,10 @@ namespace FileSystem
     bool good();
     std::string name() const;
     std::string date(dateFormat df=fullformat) const;
+    unsigned long long time() const;
+    static std::string dateOf(unsigned long long time, dateFormat df=fullformat);
+    static unsigned long long timeOf(int year, int month, int day, int hour=0, int minute=0, int second=0);
+    static unsigned long long now();
     size_t size() const;
     
     bool isArchive() const;
@@ -203,6 +232,14 @@ namespace FileSystem
   class Directory
   {
   public:
+    struct Entry
+    {
+      std::string name;
+      bool isDir;
+      unsigned long long size;
+      unsigned long long time;   // last write, 100 ns ticks since 1601, UTC
+      unsigned long long id = 0; // file id, unique on its volume, 0 if unknown
+    };
     static bool create(const std::string& path);
     static bool remove(const std::string& path);
     static bool exists(const std::string& path);
@@ -210,10 +247,40 @@ namespace FileSystem
     static bool setCurrentDirectory(const std::string& path);
     static std::vector<std::string> getFiles(const std::string& path=".", const std::string& pattern="*.*");
     static std::vector<std::string> getDirectories(const std::string& path=".", const std::string& pattern="*.*");
+    static std::vector<Entry> getEntries(const std::string& path=".", const std::string& pattern="*.*");
+    static std::vector<Entry> getIdEntries(const std::string& path=".");
+    static unsigned long volumeOf(const std::string& path);
   private:
     //static const int BufSize = 255;
     //char buffer[BufSize];
   };
+
+  /////////////////////////////////////////////////////////
+  // MappedFile
+
+  class MappedFile
+  {
+  public:
+    MappedFile(const std::string& fileSpec);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    bool good() const;
+    const char* data() const;
+    const char* end() const;
+    unsigned long long size() const;
+  private:
+    HANDLE hFile_ = INVALID_HANDLE_VALUE;
+    HANDLE hMap_ = NULL;
+    const char* data_ = nullptr;
+    unsigned long long size_ = 0;
+    bool good_ = false;
+  };
+
+  inline bool MappedFile::good() const { return good_; }
+  inline const char* MappedFile::data() const { return data_; }
+  inline const char* MappedFile::end() const { return data_ + size_; }
+  inline unsigned long long MappedFile::size() const { return size_; }
 }
 
 #endif
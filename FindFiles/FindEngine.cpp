@@ -0,0 +1,336 @@
+///////////////////////////////////////////////////////////////////////
+// FindEngine.cpp - name search as a library, for in-process callers //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "FindEngine.h"
+#include "NameMatch.h"
+#include <algorithm>
+
+const size_t FindEngine::MaxRegexes;
+const size_t FindEngine::ReadAheadPerThread;
+
+//----< a dir of a walk's frontier, and its entries once read >-------
+
+struct FindEngine::Listing
+{
+  enum State { Waiting, Queued, Reading, Read };
+  Path dir;
+  State state = Waiting;
+  bool byPool = false;
+  Entries entries;
+};
+//----< threads read ahead of walks; 0 for one per core >------------
+
+FindEngine::FindEngine(size_t threads)
+  : threads_(threads > 0 ? threads : (std::max)(1u, std::thread::hardware_concurrency())) {}
+
+FindEngine::~FindEngine()
+{
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+    ready_.notify_all();
+  }
+  for (auto& thread : pool_)
+    thread.join();
+}
+//----< compiled regex, shared by queries with the same source >-----
+
+std::shared_ptr<const std::regex> FindEngine::regex(const std::string& source)
+{
+  std::lock_guard<std::mutex> guard(regexLock_);
+  auto iter = regexes_.find(source);
+  if (iter != regexes_.end())
+    return iter->second;
+  if (regexes_.size() >= MaxRegexes)
+    regexes_.clear();
+  auto re = std::make_shared<const std::regex>(source);
+  regexes_[source] = re;
+  return re;
+}
+//----< pass each match of query to callback, in walk order >--------
+
+FindEngine::Stats FindEngine::search(const Query& query, Callback callback)
+{
+  Stats st;
+  Walk walk(*this, query);
+  Visit visit;
+  while (!st.stopped && walk.next(visit))
+  {
+    if (visit.matched)
+    {
+      Match match;
+      match.dir = visit.dir;
+      match.isDir = true;
+      ++st.matchedDirs;
+      st.stopped = !callback(match);
+    }
+    for (size_t i = 0; i < visit.files.size() && !st.stopped; ++i)
+    {
+      const FileSystem::Directory::Entry& entry = visit.entries[visit.files[i].entry];
+      Match match;
+      match.dir = visit.dir;
+      match.name = entry.name;
+      match.size = entry.size;
+      match.time = entry.time;
+      ++st.files;
+      st.stopped = !callback(match);
+    }
+  }
+  st.dirs = walk.stats().dirs;
+  st.readAhead = walk.stats().readAhead;
+  return st;
+}
+//----< all matches of query >----------------------------------------
+
+FindEngine::Matches FindEngine::find(const Query& query)
+{
+  Matches matches;
+  search(query, [&](const Match& match) { matches.push_back(match); return true; });
+  return matches;
+}
+//----< visit's matches of query: its dir, and its files >------------
+/*
+ *  As in FindFiles, a dir's matching files are taken once per pattern,
+ *  in listing order, as FindFirstFile would return them for each
+ *  pattern.  An entry of an untimed listing has its time read only if
+ *  it matches a pattern and the regex, and the query has a time range.
+ */
+void FindEngine::match(const Query& query, const std::regex& re, Visit& visit)
+{
+  visit.matched = query.dirs && std::regex_search(visit.dir, re);
+  visit.files.clear();
+  if (!query.files)
+    return;
+  bool ranged = query.modifiedFrom > 0 || query.modifiedTo < ~0ULL;
+  for (size_t p = 0; p < query.patterns.size(); ++p)
+  {
+    const Pattern& patt = query.patterns[p];
+    bool any = (patt == "*.*" || patt == "*");
+    for (size_t i = 0; i < visit.entries.size(); ++i)
+    {
+      FileSystem::Directory::Entry& entry = visit.entries[i];
+      if (entry.isDir || !(any || NameMatcher::wildcard(patt, entry.name.data(), entry.name.size())) ||
+          !std::regex_search(entry.name, re))
+        continue;
+      if (ranged && !visit.timed && entry.time == 0)
+        entry.time = FileSystem::FileInfo(visit.dir + "\\" + entry.name).time();
+      if (ranged && (entry.time < query.modifiedFrom || entry.time > query.modifiedTo))
+        continue;
+      visit.files.push_back(Found{ i, p });
+    }
+  }
+}
+//----< start reader threads, on first search >-----------------------
+
+void FindEngine::startPool()
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  for (size_t i = pool_.size(); i < threads_; ++i)
+    pool_.push_back(std::thread([this]() { work(); }));
+}
+//----< queue the dirs to be visited next, if not queued yet >-------
+
+void FindEngine::readAhead(const std::vector<std::shared_ptr<Listing>>& frontier)
+{
+  size_t ahead = (std::min)(frontier.size(), threads_ * ReadAheadPerThread);
+  std::lock_guard<std::mutex> guard(lock_);
+  for (size_t i = 0; i < ahead; ++i)
+  {
+    const std::shared_ptr<Listing>& listing = frontier[frontier.size() - 1 - i];
+    if (listing->state != Listing::Waiting)
+      continue;
+    listing->state = Listing::Queued;
+    queue_.push_back(listing);
+  }
+  ready_.notify_all();
+}
+//----< listing's entries, read here if the pool hasn't started it >-
+
+void FindEngine::take(Listing& listing)
+{
+  std::unique_lock<std::mutex> guard(lock_);
+  if (listing.state == Listing::Waiting || listing.state == Listing::Queued)
+  {
+    listing.state = Listing::Reading;   // a reader finding it queued skips it
+    guard.unlock();
+    listing.entries = FileSystem::Directory::getEntries(listing.dir);
+    return;
+  }
+  read_.wait(guard, [&]() { return listing.state == Listing::Read; });
+}
+//----< let readers skip dirs a stopped search won't visit >---------
+
+void FindEngine::cancel(const std::vector<std::shared_ptr<Listing>>& frontier)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  for (auto& listing : frontier)
+  {
+    if (listing->state == Listing::Queued)
+      listing->state = Listing::Waiting;
+  }
+}
+//----< reader thread: read queued dirs until the engine is destroyed >
+
+void FindEngine::work()
+{
+  std::unique_lock<std::mutex> guard(lock_);
+  for (;;)
+  {
+    ready_.wait(guard, [this]() { return stopping_ || queue_.size() > 0; });
+    if (stopping_)
+      return;
+    std::shared_ptr<Listing> listing = queue_.front();
+    queue_.pop_front();
+    if (listing->state != Listing::Queued)
+      continue;
+    listing->state = Listing::Reading;
+    listing->byPool = true;
+    guard.unlock();
+    Entries entries = FileSystem::Directory::getEntries(listing->dir);
+    guard.lock();
+    listing->entries.swap(entries);
+    listing->state = Listing::Read;
+    read_.notify_all();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////
+// FindEngine::Walk
+
+//----< walk below query's root; lister, if any, lists each dir >---
+
+FindEngine::Walk::Walk(FindEngine& engine, const Query& query, Lister lister)
+  : engine_(engine), query_(query), re_(engine.regex(query.regex)), lister_(lister)
+{
+  if (!lister_)
+    engine_.startPool();
+  push(FileSystem::Path::getFullFileSpec(query.root));
+}
+//----< let readers skip dirs this walk won't visit >----------------
+
+FindEngine::Walk::~Walk()
+{
+  engine_.cancel(frontier_);
+}
+//----< visit next dir: list it, match it, and queue its subdirs >---
+/*
+ *  Subdirs are pushed last to first, so they are visited in listing
+ *  order, each subtree before the next, as a recursive walk would.
+ */
+bool FindEngine::Walk::next(Visit& visit)
+{
+  if (frontier_.empty())
+    return false;
+  std::shared_ptr<Listing> listing = frontier_.back();
+  frontier_.pop_back();
+  frontierBytes_ -= listing->dir.size();
+  if (lister_)
+  {
+    listing->entries.clear();
+    visit.timed = lister_(listing->dir, listing->entries);
+  }
+  else
+  {
+    engine_.readAhead(frontier_);
+    engine_.take(*listing);
+    visit.timed = true;
+    if (listing->byPool)
+      ++stats_.readAhead;
+  }
+  ++stats_.dirs;
+  visit.dir = std::move(listing->dir);
+  visit.entries = std::move(listing->entries);
+  match(query_, *re_, visit);
+  stats_.files += visit.files.size();
+  if (visit.matched)
+    ++stats_.matchedDirs;
+  if (query_.recursive)
+  {
+    for (auto iter = visit.entries.rbegin(); iter != visit.entries.rend(); ++iter)
+    {
+      if (iter->isDir)
+        push(visit.dir + "\\" + iter->name);
+    }
+  }
+  return true;
+}
+//----< dirs left to visit, the next last, e.g., to save them >------
+
+std::vector<FindEngine::Path> FindEngine::Walk::frontier() const
+{
+  std::vector<Path> dirs;
+  for (auto& listing : frontier_)
+    dirs.push_back(listing->dir);
+  return dirs;
+}
+//----< visit frontier's dirs, the last first, instead of what's left >
+
+void FindEngine::Walk::resume(const std::vector<Path>& frontier)
+{
+  engine_.cancel(frontier_);
+  frontier_.clear();
+  frontierBytes_ = 0;
+  for (auto& dir : frontier)
+    push(dir);
+}
+
+size_t FindEngine::Walk::memory() const
+{
+  return frontierBytes_ + frontier_.size() * (sizeof(Listing) + sizeof(std::shared_ptr<Listing>));
+}
+
+void FindEngine::Walk::push(const Path& dir)
+{
+  frontier_.push_back(std::make_shared<Listing>());
+  frontier_.back()->dir = dir;
+  frontierBytes_ += dir.size();
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_FINDENGINE
+
+#include <iostream>
+#include <chrono>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing FindEngine";
+  std::cout << "\n ====================";
+
+  FindEngine::Query query;
+  query.root = argc > 1 ? argv[1] : "..";
+  query.patterns = { "*.h", "*.cpp" };
+  query.regex = "^File";
+  query.recursive = true;
+  size_t counts[2] = { 0, 0 };
+  for (size_t threads : { 1, 8 })
+  {
+    FindEngine engine(threads);
+    for (int run = 0; run < 2; ++run)
+    {
+      auto start = std::chrono::steady_clock::now();
+      FindEngine::Stats st = engine.search(query, [](const FindEngine::Match&) { return true; });
+      auto took = std::chrono::steady_clock::now() - start;
+      std::cout << "\n  " << threads << " threads: " << st.files << " files in " << st.dirs << " dirs, "
+        << st.readAhead << " read ahead, " << std::chrono::duration_cast<std::chrono::microseconds>(took).count() << " us";
+      counts[threads > 1] = st.files;
+    }
+  }
+  std::cout << "\n  same matches: " << (counts[0] == counts[1] ? "yes" : "no");
+
+  FindEngine engine;
+  FindEngine::Matches firstTen;
+  engine.search(query, [&](const FindEngine::Match& match) {
+    firstTen.push_back(match);
+    return firstTen.size() < 10;
+  });
+  for (auto& match : firstTen)
+    std::cout << "\n    " << match.dir << "\\" << match.name;
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,219 @@
+#ifndef FINDENGINE_H
+#define FINDENGINE_H
+///////////////////////////////////////////////////////////////////////
+// FindEngine.h - name search as a library, for in-process callers   //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Tools that run FindFiles as a process pay for a process start per
+ * query and parse its text output.  FindEngine answers the same name
+ * queries in process: a Query struct replaces the command line, and
+ * each match is passed to a callback as a Match struct, or collected
+ * into a vector, with nothing written to std::cout.
+ *
+ * An engine is meant to live as long as its tool.  It keeps:
+ * - compiled regexes, so a query repeating an earlier regex doesn't
+ *   compile it again
+ * - a pool of threads that read dirs ahead of the walk.  The caller's
+ *   thread takes the dirs in walk order, the order FindFiles shows
+ *   them, and reads a dir itself only if no reader has got to it, so
+ *   matches come in the same order however many threads there are.
+ *
+ * A query matches as FindFiles /P root [/s] [/f] [/d] /p patterns /R
+ * regex [/M from..to] does.  search may be called from several threads
+ * at once; their walks share the pool.  A bad regex throws
+ * std::regex_error.
+ *
+ * A Walk is a search taken a dir at a time: each call of next visits
+ * one dir, giving its listing and which of its entries matched, and
+ * the dirs left can be saved and resumed.  FileMgr shows its walks'
+ * visits, and QueryBatch and SearchSession consume them, so all of
+ * them find the same matches in the same order.  A Walk may be given
+ * a Lister that lists dirs in place of reading them, e.g., from a
+ * cache; then nothing is read ahead.  match finds the matches of a
+ * query in a listing, for callers with listings of their own.
+ *
+ * Public Interface:
+ * -----------------
+ * FindEngine engine;                       // threads default to cores
+ * FindEngine::Query query;
+ * query.root = "C:\\src";
+ * query.patterns = { "*.h", "*.cpp" };
+ * query.regex = "^File";
+ * query.recursive = true;
+ * engine.search(query, [](const FindEngine::Match& m) { ... m.dir, m.name ...; return true; });
+ * for (auto& match : engine.find(query)) ...
+ * FindEngine::Walk walk(engine, query);
+ * FindEngine::Visit visit;
+ * while (walk.next(visit))
+ *   for (auto& found : visit.files) ... visit.entries[found.entry].name ...
+ *
+ * Required Files:
+ * ---------------
+ * FindEngine.h, FindEngine.cpp
+ * NameMatch.h, NameMatch.cpp, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - added Walk, a search taken a dir at a time, and match, so FileMgr,
+ *   QueryBatch, and SearchSession share one walker and one matcher
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <functional>
+#include <regex>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "FileSystem.h"
+
+class FindEngine
+{
+public:
+  using Path = std::string;
+  using Pattern = std::string;
+  using Patterns = std::vector<Pattern>;
+
+  struct Query
+  {
+    Path root;                          // absolute, or relative to the current dir
+    Patterns patterns{ "*.*" };
+    std::string regex = ".*";           // searched for in file names, and dir paths
+    bool recursive = false;
+    bool files = true;
+    bool dirs = false;                  // dirs whose path matches regex
+    uint64_t modifiedFrom = 0;          // files last written in range, 100 ns ticks, UTC
+    uint64_t modifiedTo = ~0ULL;
+  };
+
+  struct Match
+  {
+    Path dir;
+    std::string name;                   // empty for a dir
+    bool isDir = false;
+    uint64_t size = 0;
+    uint64_t time = 0;                  // last write, 100 ns ticks since 1601, UTC
+  };
+  using Callback = std::function<bool(const Match& match)>;   // false stops the search
+  using Matches = std::vector<Match>;
+  using Entries = std::vector<FileSystem::Directory::Entry>;
+  using Lister = std::function<bool(const Path& dir, Entries& entries)>;   // false if entries have no sizes and times
+
+  struct Found
+  {
+    size_t entry;                       // index in Visit::entries
+    size_t pattern;                     // index in Query::patterns of the pattern that found it
+  };
+
+  struct Visit
+  {
+    Path dir;
+    Entries entries;                    // in listing order
+    bool timed = true;                  // entries have sizes and times
+    bool matched = false;               // with Query::dirs, dir's path matches the regex
+    std::vector<Found> files;           // once per pattern, in listing order
+  };
+
+  struct Stats
+  {
+    size_t dirs = 0;
+    size_t files = 0;                   // matching
+    size_t matchedDirs = 0;
+    size_t readAhead = 0;               // dirs read by the pool
+    bool stopped = false;               // by the callback
+  };
+
+  static const size_t MaxRegexes = 64;
+  static const size_t ReadAheadPerThread = 4;
+
+  class Walk;
+
+  FindEngine(size_t threads = 0);
+  ~FindEngine();
+  FindEngine(const FindEngine&) = delete;
+  FindEngine& operator=(const FindEngine&) = delete;
+
+  Stats search(const Query& query, Callback callback);
+  Matches find(const Query& query);
+  std::shared_ptr<const std::regex> regex(const std::string& source);
+  size_t threads() const;
+
+  static void match(const Query& query, const std::regex& re, Visit& visit);
+private:
+  struct Listing;
+
+  void startPool();
+  void readAhead(const std::vector<std::shared_ptr<Listing>>& frontier);
+  void take(Listing& listing);
+  void cancel(const std::vector<std::shared_ptr<Listing>>& frontier);
+  void work();
+
+  size_t threads_;
+  std::vector<std::thread> pool_;
+  std::mutex lock_;
+  std::condition_variable ready_;               // queue_ has dirs, or stopping_
+  std::condition_variable read_;                // the pool has read a dir
+  std::deque<std::shared_ptr<Listing>> queue_;   // dirs for the pool to read
+  bool stopping_ = false;
+  std::mutex regexLock_;
+  std::map<std::string, std::shared_ptr<const std::regex>> regexes_;
+};
+
+inline size_t FindEngine::threads() const
+{
+  return threads_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// FindEngine::Walk class
+// - a search visiting a dir at each call of next, resumable from the
+//   dirs it has yet to visit
+
+class FindEngine::Walk
+{
+public:
+  Walk(FindEngine& engine, const Query& query, Lister lister = nullptr);
+  ~Walk();
+  Walk(const Walk&) = delete;
+  Walk& operator=(const Walk&) = delete;
+
+  bool next(Visit& visit);                        // false when no dirs are left
+  std::vector<Path> frontier() const;             // dirs left, the next last
+  void resume(const std::vector<Path>& frontier); // visit these instead of what's left
+  size_t pending() const;
+  size_t memory() const;                          // of the frontier, the part that grows
+  Stats stats() const;
+private:
+  void push(const Path& dir);
+
+  FindEngine& engine_;
+  Query query_;
+  std::shared_ptr<const std::regex> re_;
+  Lister lister_;
+  std::vector<std::shared_ptr<Listing>> frontier_;
+  size_t frontierBytes_ = 0;
+  Stats stats_;
+};
+
+inline size_t FindEngine::Walk::pending() const
+{
+  return frontier_.size();
+}
+
+inline FindEngine::Stats FindEngine::Walk::stats() const
+{
+  return stats_;
+}
+
+#endif
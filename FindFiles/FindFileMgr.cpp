@@ -1,11 +1,24 @@
 ///////////////////////////////////////////////////////////////////////
 // FindFileMgr.cpp - Find names of files or dirs matching regex      //
-// Ver 1.3                                                           //
+// Ver 1.28                                                          //
 // Jim Fawcett, https://github.com/JimFawcett/FindFiles, Summer 2019 //
 ///////////////////////////////////////////////////////////////////////
 
 #include "FindFileMgr.h"
 #include "FileSystem.h"
+#include "ContentIndex.h"
+#include "Decompressor.h"
+#include "NameIndex.h"
+#include "IndexWatch.h"
+#include "Snapshot.h"
+#include "Continuation.h"
+#include "FindEngine.h"
+#include "QueryServer.h"
+#include "QueryBatch.h"
+#include "QueryScheduler.h"
+#include "SearchSession.h"
+#include "ResultRing.h"
+#include "OutputSink.h"
 #include "../CppUtilities/CodeUtilities/CodeUtilities.h"
 //#include "../Utilities/CodeUtilities/CodeUtilities.h"
 //#define STATIC_LIB
@@ -17,13 +30,14 @@
 #include <sstream>
 #include <algorithm>
 #include <regex>
+#include <chrono>
 
 std::string usageMsg()
 {
   std::ostringstream out;
-  out << "\n  FindFiles version 1.3, 24 Jun 2019";
+  out << "\n  FindFiles version 1.28, 18 Oct 2026";
   out << "\n  Finds files or directories with name matching a regex\n";
-  out << "\n  usage: FindFiles /P path [/f] [/D] [/d] [/s] [/v] [/h] [/p pattern]* [/R regex]";
+  out << "\n  usage: FindFiles /P path [/f] [/D] [/d] [/s] [/v] [/h] [/p pattern]* [/R regex] [/C regex] [/T from..to] [/M from..to]";
   out << "\n    path = relative or absolute path of starting directory";
   out << "\n    /f for finding files";
   out << "\n    /D for showing file dates";
@@ -32,9 +46,74 @@ std::string usageMsg()
   out << "\n    /v for verbose output - shows commandline processing results";
   out << "\n    /h show this message and exit";
   out << "\n    pattern is a pattern string of the form *.h,*.log, etc. with no spaces";
-  out << "\n    regex is a regular expression specifying targets, e.g., files or dirs\n";
+  out << "\n    regex is a regular expression specifying targets, e.g., files or dirs";
+  out << "\n    /C regex shows lines of matching files that match regex, searching";
+  out << "\n       inside *.gz and *.zst files without decompressing them to disk";
+  out << "\n    /T from..to shows entries of timestamped logs in the time range,";
+  out << "\n       with from and to like yyyy/mm/dd [hh:mm[:ss]], either may be empty";
+  out << "\n    /M from..to keeps files last written in the range, with from and to";
+  out << "\n       like /T's, or from like 7d for the last 7 days";
+  out << "\n    /index-content [build|query] [indexFile]";
+  out << "\n       build - creates or refreshes a trigram index of files matching /p,";
+  out << "\n               reading only new and changed files, then answers /C, if present";
+  out << "\n       query - answers /C from the index without refreshing it";
+  out << "\n       indexFile defaults to FindFiles.cidx in the starting directory";
+  out << "\n    /index [build|query|watch|facets|merge] [indexFile] [/suffixes] [/threads n]";
+  out << "\n       build - saves names, sizes, and dates of all files below path;";
+  out << "\n               /suffixes adds a suffix array for fast *fragment* queries;";
+  out << "\n               /threads sets walkers, 1 to 64, default one per core";
+  out << "\n       query - applies /p, /R, /s, /d, /D, /C, and /T to the saved names";
+  out << "\n               instead of walking the tree; the default command";
+  out << "\n       watch - keeps the index current from change notifications, until Ctrl-C";
+  out << "\n       facets - counts files matching /p, /R, and /M by extension and subdir";
+  out << "\n       merge - adds copies of other hosts' indexes, listed after indexFile";
+  out << "\n               as [host=]file, to the global indexFile; host defaults to";
+  out << "\n               file's name up to its first dot.  Queries of a global index";
+  out << "\n               return \\\\host\\ paths, and start at path only if it is one";
+  out << "\n       indexFile defaults to FindFiles.fidx in the starting directory";
+  out << "\n    /cache [dir] reuses the names found by the last run of the same query in";
+  out << "\n       dirs whose last write time hasn't changed; dir defaults to %TEMP%\\FindFiles";
+  out << "\n    /shared shares dir listings with other FindFiles processes running at";
+  out << "\n       the same time, through shared memory, so each dir is read once";
+  out << "\n    /snapshot file saves path, file id, size, and date of all files below path";
+  out << "\n       matching /p and /R, sorted by path";
+  out << "\n    /diff before after lists files added, removed, modified, and renamed";
+  out << "\n       between two snapshots";
+  out << "\n    /timeout ms stops a walk after ms milliseconds, showing what it found and";
+  out << "\n       a token; the same query with /resume token visits the dirs it didn't";
+  out << "\n    /union a b [out], /intersect a b [out], /minus a b [out] combine the files";
+  out << "\n       of two snapshots of the same path, saving the result as snapshot out,";
+  out << "\n       or listing it if out is absent";
+  out << "\n    /Q name.txt runs each line of name.txt as a query with its own /p, /R, /f,";
+  out << "\n       /d, and /D, all in one walk below path; line n's results go to name.n.txt";
+  out << "\n    /serve name answers queries sent with /via name, until stopped, keeping";
+  out << "\n       regexes, indexes, and /shared listings ready between queries.  It";
+  out << "\n       runs walks, /Q, and /index query and facets; /index build, watch, and";
+  out << "\n       merge, /index with /C or /T, /index-content, /snapshot, /diff, /union,";
+  out << "\n       /intersect, /minus, and /ring must be run without /via";
+  out << "\n    /via name sends the rest of the command line to the /serve name server";
+  out << "\n       and shows its results.  The server runs queries a dir at a time, in";
+  out << "\n       turn, interactive ones first; /priority batch marks a long query that";
+  out << "\n       should yield to them";
+  out << "\n    /session id, with /via, answers a query that narrows the session's last";
+  out << "\n       one, e.g., with a longer /R, from the last one's matches, without";
+  out << "\n       reading dirs; for /f queries with /p, /R, /s, and /D only";
+  out << "\n    /ring name writes matches as fixed size records to the shared memory ring";
+  out << "\n       created by a consumer linking ResultRingReader, instead of showing them\n";
   out << "\n  Example #1: FindFiles /P ../.. /s /f /D /R \"^File|^Util\" /p *.h,*.cpp,*.cs,*.html,*.md";
   out << "\n  Example #2: FindFiles /P ../.. /s /d /R \"FindFiles$|Utilities$\" /p *.h,*.cpp,*.cs,*.html,*.md";
+  out << "\n  Example #3: FindFiles /P ../logs /s /f /p *.log,*.log.gz,*.log.zst /C \"timeout|refused\"";
+  out << "\n  Example #4: FindFiles /P ../.. /s /p *.h,*.cpp /index-content /C \"ProcessCmdLine\"";
+  out << "\n  Example #5: FindFiles /P ../logs /f /p *.log /T \"2026/10/18 12:00..2026/10/18 12:10\"";
+  out << "\n  Example #6: FindFiles /P ../.. /index build, then FindFiles /P ../.. /s /R \"^File\" /index";
+  out << "\n  Example #7: FindFiles /P ../.. /s /p *.h,*.cpp /M 7d /index facets";
+  out << "\n  Example #8: FindFiles /P C:/app /snapshot mon.snap, then FindFiles /diff mon.snap tue.snap";
+  out << "\n  Example #9: FindFiles /index merge all.fidx node1.fidx node2.fidx, then FindFiles /s /R \"^core\" /index query all.fidx";
+  out << "\n  Example #10: FindFiles /serve ed, then FindFiles /via ed /P ../.. /s /f /R \"^File\" /index";
+  out << "\n  Example #11: FindFiles /P ../.. /s /Q nightly.txt, with lines like /p *.h,*.cpp /R \"^File\" /D";
+  out << "\n  Example #12: FindFiles /P C:/app /p *.dll /snapshot dlls.snap, then FindFiles /minus dlls.snap signed.snap";
+  out << "\n  Example #13: FindFiles /P ../.. /s /R \"^File\" /timeout 50, then the same with /resume token";
+  out << "\n  Example #14: FindFiles /P C:/src /s /f /p *.h,*.cpp /ring build42, with build42 created by its consumer";
   out << "\n";
   return out.str();
 }
@@ -43,6 +122,62 @@ void usage()
   std::cout << usageMsg();
 }
 
+namespace
+{
+  const unsigned long MaxThreads = 64;   // for /threads
+  const size_t MaxViews = 16;            // index views a server keeps mapped
+
+  //----< \\host\share path, the form of paths in a global index >-----
+
+  bool isNetworkPath(const std::string& path)
+  {
+    return path.size() > 2 && (path[0] == '\\' || path[0] == '/') && (path[1] == '\\' || path[1] == '/');
+  }
+  //----< engine walking and matching for all queries >---------------
+  /*
+   *  A /serve process answers many queries, and most repeat a few
+   *  regexes, so compiling each once saves its cost on every query.
+   *  The engine keeps them, and its readers read ahead of every walk
+   *  not listed from a cache.
+   */
+  FindEngine& engine()
+  {
+    static FindEngine engine;
+    return engine;
+  }
+  //----< view of name index, kept open while its segment is unchanged >
+  /*
+   *  A /serve process answers /index queries of the same few indexes
+   *  over and over, so views stay mapped for later queries, up to
+   *  MaxViews of them.  Rebuilding or merging an index writes a new
+   *  segment, so a view opened by an earlier query is reused only if
+   *  indexFile's segment is the same file with the same last write time.
+   */
+  std::shared_ptr<NameIndexView> openView(const std::string& indexFile)
+  {
+    struct Open
+    {
+      std::string segment;
+      unsigned long long time = 0;
+      std::shared_ptr<NameIndexView> view;
+    };
+    static std::map<std::string, Open> views;
+    std::string key = FileSystem::Path::toLower(FileSystem::Path::getFullFileSpec(indexFile));
+    std::string segment = NameIndex::segmentFile(indexFile);
+    unsigned long long time = FileSystem::File::exists(segment) ? FileSystem::FileInfo(segment).time() : 0;
+    if (views.size() >= MaxViews && views.count(key) == 0)
+      views.clear();
+    Open& open = views[key];
+    if (open.view && open.view->good() && time != 0 && open.segment == segment && open.time == time)
+      return open.view;
+    open.view.reset();   // unmap before mapping again
+    open.view = std::make_shared<NameIndexView>(indexFile);
+    open.segment = segment;
+    open.time = time;
+    return open.view;
+  }
+}
+
 bool FileMgr::processCmdLine(int argc, char** argv)
 {
   pcl_.process(argc, argv);
@@ -56,7 +191,8 @@ bool FileMgr::processCmdLine(int argc, char** argv)
   }
 
   path_ = FileSystem::Path::getFullFileSpec(pcl_.path());
-  if (!FileSystem::Directory::exists(path_))
+  bool otherHost = pcl_.hasNamedOption("index") && isNetworkPath(path_);   // needn't be reachable
+  if (!otherHost && !FileSystem::Directory::exists(path_))
   {
     std::cout << "\n  " << path_ << " does not exist\n";
     return false;
@@ -64,6 +200,56 @@ bool FileMgr::processCmdLine(int argc, char** argv)
 
   regex_ = pcl_.regex();
 
+  if (pcl_.hasOption('C'))
+  {
+    if (pcl_.options()['C'] == "")
+    {
+      std::cout << "\n  /C requires a regex\n";
+      return false;
+    }
+    textSearcher_.regex(pcl_.options()['C']);
+  }
+
+  if (pcl_.hasOption('T'))
+  {
+    if (!logSlicer_.range(pcl_.options()['T']))
+    {
+      std::cout << "\n  /T " << logSlicer_.error() << "\n";
+      return false;
+    }
+  }
+
+  if (pcl_.hasOption('M'))
+  {
+    if (!modifiedRange(pcl_.options()['M']))
+      return false;
+  }
+
+  if (pcl_.hasNamedOption("timeout"))
+  {
+    std::vector<std::string> args = pcl_.namedOption("timeout");
+    if (args.size() != 1 || args[0].size() == 0 || args[0].size() > 9 ||
+        args[0].find_first_not_of("0123456789") != std::string::npos)
+    {
+      std::cout << "\n  /timeout requires milliseconds, e.g., /timeout 50\n";
+      return false;
+    }
+    timeoutMillis_ = std::stoul(args[0]);
+  }
+
+  if (pcl_.hasNamedOption("threads"))
+  {
+    std::vector<std::string> args = pcl_.namedOption("threads");
+    if (args.size() != 1 || args[0].size() == 0 || args[0].size() > 3 ||
+        args[0].find_first_not_of("0123456789") != std::string::npos ||
+        std::stoul(args[0]) == 0 || std::stoul(args[0]) > MaxThreads)
+    {
+      std::cout << "\n  /threads requires a count from 1 to " << MaxThreads << ", e.g., /threads 8\n";
+      return false;
+    }
+    threads_ = std::stoul(args[0]);
+  }
+
   if (pcl_.hasOption('s'))
   {
     recursive_ = true;
@@ -88,6 +274,8 @@ FileMgr::FileMgr()
   pcl_.setUsageMessage(usageMsg());
 }
 
+FileMgr::~FileMgr() {}
+
 void FileMgr::addPattern(const std::string& patt)
 {
   if (patterns_.size() == 1 && patterns_[0] == "*.*")
@@ -120,119 +308,1023 @@ FileMgr::Date FileMgr::reformatDate(const Date& datetime)
   return reformattedDateTime;
 }
 
-void FileMgr::search()
+//----< format lines of file matching content regex, if any >--------
+/*
+ *  Compressed files, *.gz and *.zst, are decompressed as they are
+ *  read, so reported line numbers are uncompressed line numbers.  A
+ *  file that can't be read, e.g., a *.zst in a build without zstd, is
+ *  shown as skipped, with the reason, rather than quietly left out.
+ */
+std::string FileMgr::contentMatches(const File& fileSpec)
 {
-  std::string fullPath = FileSystem::Path::getFullFileSpec(path_);
+  std::ostringstream out;
+  TextSearcher::Matches matches = textSearcher_.search(fileSpec);
+  for (auto match : matches)
+  {
+    out << "\n      " << std::setw(6) << match.line << ": " << match.text;
+  }
+  if (textSearcher_.error().size() > 0)
+    out << "\n      skipped " << (matches.size() > 0 ? "rest of " : "") << fileSpec << ": " << textSearcher_.error();
+  return out.str();
+}
 
-  if (pcl_.hasOption('s'))
-    find(fullPath);
+//----< format log entries of file in /T's time range, if any >------
+/*
+ *  The file is mapped, not read, so only the pages near each probe of
+ *  the binary search, and the slice itself, are brought into memory.
+ *  Compressed logs can't be probed at random offsets and are skipped.
+ */
+std::string FileMgr::timeSlice(const File& fileSpec)
+{
+  if (Decompressor::formatOf(fileSpec) != Decompressor::plain)
+    return "";
+  FileSystem::MappedFile log(fileSpec);
+  if (!log.good() || log.size() == 0)
+    return "";
+  LogSlicer::Slice slice = logSlicer_.slice(log.data(), log.end());
+  std::ostringstream out;
+  const char* line = slice.beg;
+  while (line < slice.end)
+  {
+    const char* eol = std::find(line, slice.end, '\n');
+    const char* last = (eol > line && eol[-1] == '\r') ? eol - 1 : eol;
+    out << "\n      " << std::string(line, last);
+    line = eol + 1;
+  }
+  return out.str();
+}
+//----< lines shown below a matched file; false if file is excluded >
+/*
+ *  With /T or /C, files with nothing in range, or no matching line,
+ *  are not reported.  /T takes precedence when both are given.
+ */
+bool FileMgr::fileContents(const File& fileSpec, std::string& lines)
+{
+  if (pcl_.hasOption('T'))
+    lines = timeSlice(fileSpec);
+  else if (pcl_.hasOption('C'))
+    lines = contentMatches(fileSpec);
   else
+    return true;
+  return lines.size() > 0;
+}
+
+//----< parse /M range into times; "7d" means the last 7 days >------
+
+bool FileMgr::modifiedRange(const std::string& fromTo)
+{
+  const unsigned long long TicksPerDay = 864000000000ULL;
+  size_t digits = fromTo.find_first_not_of("0123456789");
+  if (digits > 0 && digits != std::string::npos && fromTo.substr(digits) == "d")
   {
-    ++processedDirs_;
-    std::cout << "\n  " << fullPath;
+    if (digits > 9)
+    {
+      std::cout << "\n  /M " << fromTo << " is too many days\n";
+      return false;
+    }
+    unsigned long long days = std::stoull(fromTo.substr(0, digits));
+    unsigned long long now = FileSystem::FileInfo::now();
+    modifiedFrom_ = (days >= now / TicksPerDay) ? 0 : now - days * TicksPerDay;   // all files, if before 1601
+    return true;
+  }
+  LogSlicer range;
+  if (!range.range(fromTo))
+  {
+    std::cout << "\n  /M " << range.error() << "\n";
+    return false;
+  }
+  auto timeOf = [](LogSlicer::Stamp st) {
+    return FileSystem::FileInfo::timeOf(
+      static_cast<int>(st / 10000000000ULL), static_cast<int>(st / 100000000 % 100), static_cast<int>(st / 1000000 % 100),
+      static_cast<int>(st / 10000 % 100), static_cast<int>(st / 100 % 100), static_cast<int>(st % 100));
+  };
+  if (range.from() != 0)
+    modifiedFrom_ = timeOf(range.from());
+  if (range.to() != ~0ULL)
+    modifiedTo_ = timeOf(range.to()) + 9999999;   // through the last second
+  return true;
+}
 
-    std::vector<std::string> fileMatches;
+//----< run the search chosen by the command line >-----------------
 
-    for (auto patt : pcl_.patterns())
+void FileMgr::search()
+{
+  if (!start())
+    return;
+  while (step())
+    ;
+  finish();
+}
+//----< begin search; false if it's done, i.e., isn't a tree walk >--
+/*
+ *  Index, snapshot, and ring searches run to completion here.  A walk,
+ *  including a /Q batch's, is left to step(), one dir at a time, so a
+ *  caller may interleave several walks, or stop one early.
+ */
+bool FileMgr::start()
+{
+  if (pcl_.hasNamedOption("index-content"))
+  {
+    searchContentIndex();
+    return false;
+  }
+  if (pcl_.hasNamedOption("index"))
+  {
+    searchNameIndex();
+    return false;
+  }
+  if (pcl_.hasNamedOption("snapshot"))
+  {
+    takeSnapshot();
+    return false;
+  }
+  if (pcl_.hasNamedOption("diff"))
+  {
+    diffSnapshots();
+    return false;
+  }
+  const char* setOps[] = { "union", "intersect", "minus" };
+  for (auto op : setOps)
+  {
+    if (pcl_.hasNamedOption(op))
     {
-      std::vector<std::string> files = FileSystem::Directory::getFiles(fullPath, patt);
-      for (auto f : files)
-      {
-        if (pcl_.hasOption('f'))
-        {
-          static std::regex re(regex_);
-          if (std::regex_search(f, re))
-          {
-            if (pcl_.hasOption('D'))
-            {
-              std::string file = fullPath + "\\" + f;
-              FileSystem::FileInfo fi(file);
-              std::string date = fi.date();
-              date = reformatDate(date);
-              fileMatches.push_back(date + " -- " + f);
-            }
-            else
-            {
-              fileMatches.push_back(f);
-            }
-            ++processedFiles_;
-          }
-        }
-      }
+      combineSnapshots(op);
+      return false;
+    }
+  }
+  if (pcl_.hasOption('Q'))
+    return startBatch();
+  if (pcl_.hasNamedOption("ring"))
+  {
+    streamToRing();
+    return false;
+  }
+  sessionWalk_ = false;
+  if (session_ && pcl_.hasNamedOption("session") && sessionQuery())
+  {
+    if (searchSession())
+      return false;
+    sessionWalk_ = true;   // the walk's visits go to session_ too
+  }
+
+  std::string fullPath = FileSystem::Path::getFullFileSpec(path_);
+  root_ = fullPath;   // path_ may be relative, and a server's cwd changes
+  if (pcl_.hasNamedOption("cache"))
+  {
+    std::vector<std::string> args = pcl_.namedOption("cache");
+    Path cacheDir = args.size() > 0 ? FileSystem::Path::getFullFileSpec(args[0]) : QueryCache::defaultDir();
+    cache_.reset(new QueryCache(cacheDir, queryKey(fullPath)));
+    if (!cache_->load() && cache_->error().size() > 0)
+      std::cout << "\n  " << cache_->error();
+  }
+  if (pcl_.hasNamedOption("shared"))
+  {
+    dirCache_.reset(new SharedDirCache());
+    if (!dirCache_->good())
+    {
+      std::cout << "\n  " << dirCache_->error();
+      dirCache_.reset();
     }
-    if (fileMatches.size() > 0)
+  }
+  stopped_ = false;
+  FindEngine::Lister lister;
+  if (cache_ || dirCache_)
+    lister = [this](const Path& dir, FindEngine::Entries& entries) { return listDir(dir, entries); };
+  walk_.reset(new FindEngine::Walk(engine(), engineQuery(fullPath), lister));
+  if (pcl_.hasNamedOption("resume") && !resume(fullPath))
+  {
+    walk_.reset();
+    return false;
+  }
+  if (timeoutMillis_ > 0)
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillis_);
+  return true;
+}
+//----< frontier of a walk stopped by /timeout, named by /resume >---
+
+bool FileMgr::resume(const Path& fullPath)
+{
+  std::vector<std::string> args = pcl_.namedOption("resume");
+  if (args.size() != 1)
+  {
+    std::cout << "\n  /resume requires the token shown by a walk stopped by /timeout";
+    return false;
+  }
+  Continuation cont(QueryCache::defaultDir());
+  std::vector<Path> frontier;
+  if (!cont.load(args[0], continuationKey(fullPath), frontier))
+  {
+    std::cout << "\n  " << cont.error();
+    return false;
+  }
+  walk_->resume(frontier);
+  return true;
+}
+//----< option of a query start() runs to its end; empty for walks >
+/*
+ *  Such a query can't be run a dir at a time, so a server, which
+ *  slices queries by steps, refuses it.  /index query and facets also
+ *  run to their end, but read only the mapped index, which a server
+ *  keeps open, so they are one short step and are left to run.
+ */
+std::string FileMgr::unstepped()
+{
+  if (pcl_.hasNamedOption("index") && !pcl_.hasNamedOption("index-content"))
+  {
+    std::vector<std::string> args = pcl_.namedOption("index");
+    std::string verb = args.size() > 0 ? args[0] : "query";
+    if (verb != "query" && verb != "facets")
+      return "index " + verb;
+    if (pcl_.hasOption('C') || pcl_.hasOption('T'))
+      return "index with /C or /T";   // reads files, not just the index
+    return "";
+  }
+  const char* whole[] = { "index-content", "index", "snapshot", "diff", "union", "intersect", "minus", "ring" };
+  for (auto opt : whole)
+  {
+    if (pcl_.hasNamedOption(opt))
+      return opt;
+  }
+  return "";
+}
+//----< visit next dir of the walk; false when none are left >-------
+
+bool FileMgr::step()
+{
+  FindEngine::Visit visit;
+  if (!walk_ || !walk_->next(visit))
+    return false;
+  if (batch_)
+  {
+    ++processedDirs_;
+    batch_->visit(visit);
+  }
+  else
+  {
+    if (sessionWalk_)
+      session_->add(visit);
+    show(visit);
+  }
+  bool more = walk_->pending() > 0;
+  if (more && timeoutMillis_ > 0 && !batch_ && std::chrono::steady_clock::now() >= deadline_)
+    stopped_ = true;
+  return more && !stopped_ && std::cout.good();   // not good if output's pipe is closed
+}
+//----< end the walk, saving /cache and showing cache stats >--------
+
+void FileMgr::finish()
+{
+  if (stopped_)
+    suspend();
+  if (sessionWalk_ && walk_ && walk_->pending() == 0)
+    session_->end();
+  sessionWalk_ = false;
+  walk_.reset();
+  if (batch_)
+    endBatch();
+  if (cache_)
+  {
+    if (!cache_->save())
+      std::cout << "\n  " << cache_->error();
+    QueryCache::Stats st = cache_->stats();
+    std::cout << "\n  cache reused " << st.reused << " of " << st.dirs << " dirs";
+    cache_.reset();
+  }
+  if (dirCache_)
+  {
+    SharedDirCache::Stats st = dirCache_->stats();
+    std::cout << "\n  shared listings used for " << st.hits << " dirs, shared " << st.stores << " of " << st.misses << " read";
+    dirCache_.reset();
+  }
+}
+//----< save the frontier of a walk stopped by /timeout >-----------
+/*
+ *  Results so far have been shown; the token lets a later run of the
+ *  same query visit the rest.  The query's key uses the root start()
+ *  resolved, as a server has left the client's dir by now.
+ */
+void FileMgr::suspend()
+{
+  std::vector<Path> frontier = walk_->frontier();
+  std::cout << "\n\n  partial results: stopped after /timeout " << timeoutMillis_ << " ms, "
+    << frontier.size() << " dirs left to visit";
+  Continuation cont(QueryCache::defaultDir());
+  std::string token = cont.save(continuationKey(root_), frontier);
+  if (token.size() == 0)
+    std::cout << "\n  " << cont.error();
+  else
+    std::cout << "\n  continue with /resume " << token;
+}
+//----< the query FindEngine walks, from the command line >---------
+
+FindEngine::Query FileMgr::engineQuery(const Path& root)
+{
+  FindEngine::Query query;
+  query.root = root;
+  query.patterns = pcl_.patterns();
+  query.regex = regex_;
+  query.recursive = recursive_;
+  query.files = pcl_.hasOption('f');
+  query.dirs = pcl_.hasOption('d');
+  query.modifiedFrom = modifiedFrom_;
+  query.modifiedTo = modifiedTo_;
+  return query;
+}
+//----< query as a cache key: what decides the names listed >--------
+
+std::string FileMgr::queryKey(const Path& fullPath)
+{
+  std::string key = FileSystem::Path::toLower(fullPath);
+  std::replace(key.begin(), key.end(), '/', '\\');
+  key += "\n";
+  for (auto patt : pcl_.patterns())
+    key += patt + ",";
+  key += "\n" + regex_ + "\n" + (pcl_.hasOption('f') ? "f" : "") + (recursive_ ? "s" : "");
+  return key;
+}
+//----< query as a continuation key: what decides the results shown >
+/*
+ *  Unlike a cache, which keeps listings, a continuation's walk must go
+ *  on showing what the stopped one did, so /d and /M are part of it.
+ *  /M is kept as given, so 7d resumes as 7d.
+ */
+std::string FileMgr::continuationKey(const Path& fullPath)
+{
+  std::string key = queryKey(fullPath) + "\n" + (pcl_.hasOption('d') ? "d" : "");
+  if (pcl_.hasOption('M'))
+    key += "\n" + pcl_.options()['M'];
+  return key;
+}
+//----< dir's listing from /cache or /shared; false if it's untimed >
+/*
+ *  With /cache, an unchanged dir's names come from the cache, so the
+ *  dir is not enumerated.  Adding, removing, or renaming an entry
+ *  changes a dir's last write time.  With /shared, a listing read by
+ *  another process is used, and one read here is shared.  Neither
+ *  keeps sizes and times, so FindEngine reads times it needs.
+ */
+bool FileMgr::listDir(const Path& dir, FindEngine::Entries& entries)
+{
+  unsigned long long time = FileSystem::FileInfo(dir).time();
+  std::vector<File> files, subdirs;
+  if (cache_ && cache_->lookup(dir, time, files, subdirs))
+  {
+    for (auto& file : files)
+      entries.push_back(FileSystem::Directory::Entry{ file, false, 0, 0 });
+    for (auto& subdir : subdirs)
+      entries.push_back(FileSystem::Directory::Entry{ subdir, true, 0, 0 });
+    return false;
+  }
+  bool timed = true;
+  SharedDirCache::Entries shared;
+  if (dirCache_ && dirCache_->lookup(dir, time, shared))
+  {
+    for (auto& entry : shared)
+      entries.push_back(FileSystem::Directory::Entry{ entry.name, entry.isDir, 0, 0 });
+    timed = false;
+  }
+  else
+  {
+    entries = FileSystem::Directory::getEntries(dir);
+    if (dirCache_)
     {
-      for (auto file : fileMatches)
-      {
-        std::cout << "\n    " << file;
-      }
+      for (auto& entry : entries)
+        shared.push_back(SharedDirCache::Entry{ entry.name, entry.isDir });
+      dirCache_->store(dir, time, shared);
     }
   }
+  if (cache_)
+  {
+    for (auto& entry : entries)
+      (entry.isDir ? subdirs : files).push_back(entry.name);
+    cache_->store(dir, time, files, subdirs);
+  }
+  return timed;
 }
+//----< whole walk below path >--------------------------------------
 
 void FileMgr::find(const Path& path)
+{
+  walk_.reset(new FindEngine::Walk(engine(), engineQuery(path)));
+  while (step())
+    ;
+  walk_.reset();
+}
+//----< show a dir the walk visited, with its files that match >-----
+/*
+ *  With /s, a dir is shown before its files only if it's shown without
+ *  /H, or it matches with /d and /H; then again, as the heading of its
+ *  files, if any match.  A session's walk shows only headings, as with
+ *  /H.  /C and /T drop files whose contents don't match.
+ */
+void FileMgr::show(FindEngine::Visit& visit)
 {
   ++processedDirs_;
-
-  if(!pcl_.hasOption('H'))
+  const Path& path = visit.dir;
+  bool heading = recursive_ || sessionWalk_;
+  bool every = !sessionWalk_ && (!recursive_ || !pcl_.hasOption('H'));
+  if (every || visit.matched)
     std::cout << "\n  " << path;
 
-  if (pcl_.hasOption('d'))
+  std::vector<std::string> fileMatches;
+  for (auto& found : visit.files)
+  {
+    const FileSystem::Directory::Entry& entry = visit.entries[found.entry];
+    std::string file = path + "\\" + entry.name;
+    std::string lines;
+    if (!fileContents(file, lines))
+      continue;
+    if (pcl_.hasOption('D'))
+    {
+      unsigned long long time = (visit.timed || entry.time != 0) ? entry.time : FileSystem::FileInfo(file).time();
+      std::string date = reformatDate(FileSystem::FileInfo::dateOf(time));
+      fileMatches.push_back(date + " -- " + entry.name + lines);
+    }
+    else
+    {
+      fileMatches.push_back(entry.name + lines);
+    }
+    ++processedFiles_;
+  }
+  if (fileMatches.size() > 0)
   {
-    static std::regex re(regex_);
-    if (std::regex_search(path, re))
+    if (heading)
+      std::cout << "\n  " << path;
+    for (auto file : fileMatches)
     {
-      if(pcl_.hasOption('H'))
-        std::cout << "\n  " << path;
+      std::cout << "\n    " << file;
     }
   }
+}
 
-  std::vector<std::string> fileMatches;
+//----< content search using, and optionally refreshing, an index >--
+/*
+ *  The index supplies candidate files; each candidate is then checked
+ *  against path, and /s, and the name regex, and searched with /C's
+ *  regex, as in find.  An index of a parent tree holds files outside
+ *  path, and an index built with /s holds files below it.
+ */
+void FileMgr::searchContentIndex()
+{
+  std::vector<std::string> args = pcl_.namedOption("index-content");
+  std::string verb = args.size() > 0 ? args[0] : "build";
+  if (verb != "build" && verb != "query")
+  {
+    std::cout << "\n  unknown /index-content command " << verb;
+    return;
+  }
+  std::string fullPath = FileSystem::Path::getFullFileSpec(path_);
+  std::string indexFile = ContentIndex::defaultFile(fullPath);
+  if (args.size() > 1)
+    indexFile = FileSystem::Path::getFullFileSpec(args[1]);
+  ContentIndex ci(indexFile);
 
-  for (auto patt : pcl_.patterns())
+  if (verb == "build")
   {
-    std::vector<std::string> files = FileSystem::Directory::getFiles(path, patt);
+    if (!ci.load() && ci.error().size() > 0)
+      std::cout << "\n  " << ci.error() << ", rebuilding";
+    ci.refresh(fullPath, pcl_.patterns(), recursive_);
+    if (!ci.save())
+    {
+      std::cout << "\n  " << ci.error();
+      return;
+    }
+    ContentIndex::Stats st = ci.stats();
+    std::cout << "\n  " << indexFile << ": " << st.files << " files";
+    std::cout << "\n    read " << st.indexed << ", unchanged " << st.reused;
+    std::cout << ", removed " << st.removed << ", binary " << st.binary;
+  }
+  if (!pcl_.hasOption('C'))
+    return;
 
-    for (auto f : files)
+  // the index may cover more than the query: keep path's dir, or subtree with /s
+  auto normal = [](std::string path) {
+    path = FileSystem::Path::toLower(path);
+    std::replace(path.begin(), path.end(), '/', '\\');
+    return path;
+  };
+  std::string root = normal(fullPath);
+  std::regex re(regex_);
+  std::string currDir;
+  for (auto file : ci.candidates(textSearcher_.regex()))
+  {
+    std::string dir = file.substr(0, file.find_last_of('\\'));
+    std::string name = file.substr(dir.size() + 1);
+    std::string key = normal(dir);
+    bool below = key.size() > root.size() && key.compare(0, root.size(), root) == 0 && key[root.size()] == '\\';
+    if (key != root && !(recursive_ && below))
+      continue;
+    if (!std::regex_search(name, re))
+      continue;
+    std::string lines = contentMatches(file);
+    if (lines.size() == 0)
+      continue;
+    if (dir != currDir)
     {
-      if (pcl_.hasOption('f'))
+      currDir = dir;
+      ++processedDirs_;
+      std::cout << "\n  " << dir;
+    }
+    if (pcl_.hasOption('D'))
+    {
+      FileSystem::FileInfo fi(file);
+      std::cout << "\n    " << reformatDate(fi.date()) << " -- " << name << lines;
+    }
+    else
+      std::cout << "\n    " << name << lines;
+    ++processedFiles_;
+  }
+  if (ci.error().size() > 0)
+    std::cout << "\n  " << ci.error();
+}
+
+//----< build name index, or answer search from it >----------------
+/*
+ *  A query may start below the index root: the index is looked up
+ *  in path's own dir first, so an index of a parent tree must be
+ *  named explicitly.
+ */
+void FileMgr::searchNameIndex()
+{
+  std::vector<std::string> args = pcl_.namedOption("index");
+  std::string verb = args.size() > 0 ? args[0] : "query";
+  if (verb != "build" && verb != "query" && verb != "watch" && verb != "facets" && verb != "merge")
+  {
+    std::cout << "\n  unknown /index command " << verb;
+    return;
+  }
+  std::string fullPath = FileSystem::Path::getFullFileSpec(path_);
+  std::string indexFile = NameIndex::defaultFile(fullPath);
+  if (args.size() > 1)
+    indexFile = FileSystem::Path::getFullFileSpec(args[1]);
+
+  if (verb == "build")
+  {
+    NameIndex ni(indexFile);
+    ni.suffixArray(pcl_.hasNamedOption("suffixes"));
+    ni.threads(threads_);
+    auto start = std::chrono::steady_clock::now();
+    auto rate = [&](size_t files) {
+      double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return static_cast<size_t>(secs > 0 ? files / secs : 0);
+    };
+    ni.progress([&](size_t dirs, size_t files) {
+      std::cout << "\r  walked " << dirs << " dirs, " << files << " files, " << rate(files) << " files/sec   ";
+      std::cout.flush();
+    });
+    ni.build(fullPath);
+    if (!ni.save())
+    {
+      std::cout << "\n  " << ni.error();
+      return;
+    }
+    NameIndex::Stats st = ni.stats();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\n  " << indexFile << ": " << st.dirs << " dirs, " << st.files << " files, " << st.bytes << " bytes";
+    std::cout << "\n  built in " << std::fixed << std::setprecision(2) << secs << " sec, " << rate(st.files) << " files/sec";
+    return;
+  }
+  if (verb == "watch")
+  {
+    watchNameIndex(indexFile);
+    return;
+  }
+  if (verb == "facets")
+  {
+    countFacets(indexFile);
+    return;
+  }
+  if (verb == "merge")
+  {
+    mergeNameIndexes(indexFile, std::vector<std::string>(args.begin() + (std::min)(args.size(), size_t(2)), args.end()));
+    return;
+  }
+
+  std::shared_ptr<NameIndexView> opened = openView(indexFile);
+  NameIndexView& view = *opened;
+  if (!view.good())
+  {
+    std::cout << "\n  " << view.error();
+    return;
+  }
+  fullPath = indexPath(view);
+  NameIndex::DirId start = view.findDir(fullPath);
+  if (start == NameIndex::NoDir)
+  {
+    std::cout << "\n  " << fullPath << " is not in index of " << view.root();
+    return;
+  }
+  NameIndex::DirId end = recursive_ ? view.dir(start).subtreeEnd : start + 1;
+  processedDirs_ += end - start;
+
+  if (pcl_.hasOption('d'))
+  {
+    for (auto d : view.matchDirs(start, recursive_, regex_))
+      std::cout << "\n  " << view.dirPath(d);
+  }
+  if (!pcl_.hasOption('f'))
+    return;
+
+  NameIndex::DirId currDir = NameIndex::NoDir;
+  std::string dirPath;
+  NameMatcher matcher(pcl_.patterns(), regex_);
+  view.scan(start, recursive_, matcher, modifiedFrom_, modifiedTo_,
+    [&](NameIndex::DirId d, NameIndex::FileId f, const std::string& name) {
+      if (d != currDir)
+        dirPath = view.dirPath(d);
+      std::string lines;
+      if (!fileContents(dirPath + "\\" + name, lines))
+        return;
+      if (d != currDir)
       {
-        static std::regex re(regex_);
-        if (std::regex_search(f, re))
-        {
-          if (pcl_.hasOption('D'))
-          {
-            std::string file = path + "\\" + f;
-            FileSystem::FileInfo fi(file);
-            std::string date = fi.date();
-            date = reformatDate(date);
-            fileMatches.push_back(date + " -- " + f);
-          }
-          else
-          {
-            fileMatches.push_back(f);
-          }
-          ++processedFiles_;
-        }
+        currDir = d;
+        std::cout << "\n  " << dirPath;
       }
+      if (pcl_.hasOption('D'))
+        std::cout << "\n    " << reformatDate(FileSystem::FileInfo::dateOf(view.fileTime(f))) << " -- " << name << lines;
+      else
+        std::cout << "\n    " << name << lines;
+      ++processedFiles_;
     }
+  );
+}
+
+//----< count indexed matches by extension and by subdir >----------
+/*
+ *  Counts come from bitmap intersections of the matching files with
+ *  each facet, so only the matches themselves are decoded.
+ */
+void FileMgr::countFacets(const Path& indexFile)
+{
+  std::shared_ptr<NameIndexView> opened = openView(indexFile);
+  NameIndexView& view = *opened;
+  if (!view.good())
+  {
+    std::cout << "\n  " << view.error();
+    return;
   }
-  if (fileMatches.size() > 0)
+  std::string fullPath = indexPath(view);
+  NameIndex::DirId start = view.findDir(fullPath);
+  if (start == NameIndex::NoDir)
   {
-    std::cout << "\n  " << path;
-    for (auto file : fileMatches)
+    std::cout << "\n  " << fullPath << " is not in index of " << view.root();
+    return;
+  }
+  if (!view.hasFacets())
+  {
+    std::cout << "\n  " << indexFile << " has no facets, rebuild it with /index build";
+    return;
+  }
+  Roaring matched;
+  view.scan(start, recursive_, NameMatcher(pcl_.patterns(), regex_), modifiedFrom_, modifiedTo_,
+    [&](NameIndex::DirId, NameIndex::FileId f, const std::string&) { matched.add(f); }
+  );
+  processedFiles_ = static_cast<size_t>(matched.count());
+  processedDirs_ = recursive_ ? view.dir(start).subtreeEnd - start : 1;
+  std::cout << "\n  " << matched.count() << " matching files";
+  std::cout << "\n  by extension:";
+  for (auto& item : view.extCounts(matched))
+    std::cout << "\n    " << std::setw(8) << item.second << "  " << (item.first.size() > 0 ? "*." + item.first : "(none)");
+  std::cout << "\n  by dir:";
+  for (auto& item : view.dirCounts(start, matched))
+  {
+    if (item.second > 0)
+      std::cout << "\n    " << std::setw(8) << item.second << "  " << view.dirPath(item.first);
+  }
+}
+//----< path a query of view starts at >----------------------------
+/*
+ *  A global index holds other hosts' trees, so a local path can't be
+ *  in it.  Its queries start at path only if path is a host's network
+ *  path, and otherwise search every host.
+ */
+FileMgr::Path FileMgr::indexPath(const NameIndexView& view)
+{
+  if (view.hosts().size() == 0)
+    return FileSystem::Path::getFullFileSpec(path_);
+  return isNetworkPath(path_) ? path_ : view.root();
+}
+//----< merge copies of hosts' indexes into global index >-----------
+/*
+ *  Each input is [host=]file.  An existing global index is loaded
+ *  first, so merging a newer copy from a host replaces only its tree.
+ */
+void FileMgr::mergeNameIndexes(const Path& indexFile, const std::vector<std::string>& inputs)
+{
+  if (inputs.size() == 0)
+  {
+    std::cout << "\n  /index merge needs an indexFile and the indexes to merge into it";
+    return;
+  }
+  NameIndex ni(indexFile);
+  if (FileSystem::File::exists(indexFile) && !ni.load())
+  {
+    std::cout << "\n  " << ni.error();
+    return;
+  }
+  for (auto input : inputs)
+  {
+    size_t pos = input.find('=');
+    std::string file = FileSystem::Path::getFullFileSpec(pos == std::string::npos ? input : input.substr(pos + 1));
+    std::string name = FileSystem::Path::getName(file);
+    std::string host = (pos == std::string::npos) ? name.substr(0, name.find('.')) : input.substr(0, pos);
+    if (!ni.merge(host, file))
     {
-      std::cout << "\n    " << file;
+      std::cout << "\n  " << ni.error();
+      return;
     }
   }
-  std::vector<std::string> subdirs = FileSystem::Directory::getDirectories(path);
-  for (auto d : subdirs)
+  if (!ni.save())
+  {
+    std::cout << "\n  " << ni.error();
+    return;
+  }
+  NameIndex::Stats st = ni.stats();
+  std::cout << "\n  " << indexFile << ": " << ni.hosts().size() << " hosts, " << st.dirs << " dirs, " << st.files << " files, " << st.bytes << " bytes";
+  for (auto& host : ni.hosts())
+    std::cout << "\n    " << host.path << "  (" << host.name << " " << host.root << ")";
+}
+//----< apply change notifications to index until Ctrl-C >----------
+
+namespace
+{
+  IndexWatcher* pWatcher = nullptr;
+
+  BOOL WINAPI stopWatching(DWORD)
+  {
+    if (pWatcher != nullptr)
+      pWatcher->stop();
+    return TRUE;
+  }
+}
+
+void FileMgr::watchNameIndex(const Path& indexFile)
+{
+  NameIndex ni(indexFile);
+  if (!ni.load())
   {
-    if (d != "." && d != "..")
+    std::cout << "\n  " << ni.error() << ", building";
+    ni.build(FileSystem::Path::getFullFileSpec(path_));
+    if (!ni.save())
     {
-      find(path + "\\" + d);
+      std::cout << "\n  " << ni.error();
+      return;
     }
   }
+  else if (ni.hosts().size() > 0)
+  {
+    std::cout << "\n  " << indexFile << " is a global index, refresh it with /index merge";
+    return;
+  }
+  else if (ni.stats().replayed > 0)
+    std::cout << "\n  replayed " << ni.stats().replayed << " logged changes";
+  IndexWatcher iw(ni);
+  if (!iw.start())
+  {
+    std::cout << "\n  " << iw.error();
+    return;
+  }
+  pWatcher = &iw;
+  ::SetConsoleCtrlHandler(stopWatching, TRUE);
+  std::cout << "\n  watching " << ni.root() << ", Ctrl-C to stop";
+  std::cout.flush();
+  iw.run(std::cout);
+  ::SetConsoleCtrlHandler(stopWatching, FALSE);
+  pWatcher = nullptr;
+
+  IndexWatcher::Stats st = iw.stats();
+  std::cout << "\n  " << st.events << " changes, " << st.rescans << " rescans, " << st.saves << " saves";
+}
+
+//----< save snapshot of files below path >-------------------------
+
+void FileMgr::takeSnapshot()
+{
+  std::vector<std::string> args = pcl_.namedOption("snapshot");
+  if (args.size() == 0)
+  {
+    std::cout << "\n  /snapshot needs a file name";
+    return;
+  }
+  std::string file = FileSystem::Path::getFullFileSpec(args[0]);
+  Snapshot snap(file);
+  if (!snap.take(FileSystem::Path::getFullFileSpec(path_), NameMatcher(pcl_.patterns(), regex_)))
+  {
+    std::cout << "\n  " << snap.error();
+    return;
+  }
+  Snapshot::Stats st = snap.stats();
+  processedDirs_ = st.dirs;
+  processedFiles_ = st.files;
+  std::cout << "\n  " << file << ": " << st.files << " files, " << st.bytes << " bytes";
+}
+//----< list changes between two snapshots >------------------------
+
+void FileMgr::diffSnapshots()
+{
+  std::vector<std::string> args = pcl_.namedOption("diff");
+  if (args.size() != 2)
+  {
+    std::cout << "\n  /diff needs two snapshot files";
+    return;
+  }
+  SnapshotDiff diff(args[0], args[1]);
+  bool ok = diff.run([](const SnapshotDiff::Change& change) {
+    switch (change.kind)
+    {
+    case SnapshotDiff::Added:
+      std::cout << "\n    added     " << change.after.path;
+      break;
+    case SnapshotDiff::Removed:
+      std::cout << "\n    removed   " << change.before.path;
+      break;
+    case SnapshotDiff::Modified:
+      std::cout << "\n    modified  " << change.after.path;
+      break;
+    case SnapshotDiff::Renamed:
+      std::cout << "\n    renamed   " << change.before.path << " -> " << change.after.path;
+      break;
+    }
+  });
+  if (!ok)
+  {
+    std::cout << "\n  " << diff.error();
+    return;
+  }
+  SnapshotDiff::Counts n = diff.counts();
+  processedFiles_ = n.added + n.removed + n.modified + n.renamed + n.unchanged;
+  std::cout << "\n\n  " << n.added << " added, " << n.removed << " removed, " << n.modified << " modified, "
+    << n.renamed << " renamed, " << n.unchanged << " unchanged";
+}
+//----< save or list union, intersection, or difference of snapshots >
+/*
+ *  op is the option's name, "union", "intersect", or "minus".  Both
+ *  snapshots are streamed, so lists of millions of files combine in
+ *  one pass, without loading either.
+ */
+void FileMgr::combineSnapshots(const std::string& op)
+{
+  std::vector<std::string> args = pcl_.namedOption(op);
+  if (args.size() != 2 && args.size() != 3)
+  {
+    std::cout << "\n  /" << op << " needs two snapshot files, and optionally an output file";
+    return;
+  }
+  SnapshotSet::Op setOp = (op == "union") ? SnapshotSet::Union : (op == "intersect") ? SnapshotSet::Intersect : SnapshotSet::Minus;
+  SnapshotSet set(setOp, args[0], args[1]);
+  bool ok = false;
+  if (args.size() == 3)
+    ok = set.save(FileSystem::Path::getFullFileSpec(args[2]));
+  else
+  {
+    ok = set.run([&](const Snapshot::Entry& entry) {
+      std::cout << "\n    " << FileSystem::Path::fileSpec(set.root(), entry.path);
+    });
+  }
+  if (!ok)
+  {
+    std::cout << "\n  " << set.error();
+    return;
+  }
+  SnapshotSet::Counts n = set.counts();
+  processedFiles_ = n.result;
+  std::cout << "\n\n  " << n.result << " files";
+  if (args.size() == 3)
+    std::cout << " saved to " << FileSystem::Path::getFullFileSpec(args[2]);
+}
+//----< write matches to the ring named by /ring, for a consumer >--
+/*
+ *  The consumer created the ring and reads records in place, so paths
+ *  and sizes are never formatted as text.  Each dir's records are
+ *  published when the walk leaves it, so the consumer isn't kept
+ *  waiting by a dir's batch that is yet to fill.
+ */
+void FileMgr::streamToRing()
+{
+  std::vector<std::string> args = pcl_.namedOption("ring");
+  if (args.size() != 1)
+  {
+    std::cout << "\n  /ring needs the name of a ring its consumer has created";
+    return;
+  }
+  if (pcl_.hasOption('C') || pcl_.hasOption('T'))
+  {
+    std::cout << "\n  /ring streams names, so /C and /T can't be used with it";
+    return;
+  }
+  ResultRing ring(args[0]);
+  if (!ring.good())
+  {
+    std::cout << "\n  " << ring.error();
+    return;
+  }
+  FindEngine::Walk walk(engine(), engineQuery(FileSystem::Path::getFullFileSpec(path_)));
+  FindEngine::Visit visit;
+  bool readerGone = false;
+  while (!readerGone && walk.next(visit))
+  {
+    ++processedDirs_;
+    if (visit.matched)
+      readerGone = !ring.write(visit.dir, 0, 0, ResultRing::IsDir);
+    for (size_t i = 0; i < visit.files.size() && !readerGone; ++i)
+    {
+      const FileSystem::Directory::Entry& entry = visit.entries[visit.files[i].entry];
+      readerGone = !ring.write(visit.dir + "\\" + entry.name, entry.size, entry.time, 0);
+      ++processedFiles_;
+    }
+    if (!readerGone && (visit.matched || visit.files.size() > 0))
+      ring.flush();
+  }
+  ring.close();
+  ResultRing::Stats rs = ring.stats();
+  std::cout << "\n  " << rs.records << " results to ring " << args[0] << ", waited for its reader " << rs.waits << " times";
+  if (readerGone)
+    std::cout << "\n  stopped: " << (ring.error().size() > 0 ? ring.error() : "the ring's reader has gone");
+}
+//----< can a session answer this query? >--------------------------
+/*
+ *  A session keeps only names and dates, so queries for dirs, or that
+ *  look at contents or dir caches, are run as usual, as are resumed
+ *  walks, which don't visit all of the query's dirs.
+ */
+bool FileMgr::sessionQuery()
+{
+  for (char opt : std::string("dCTMQ"))
+  {
+    if (pcl_.hasOption(opt))
+      return false;
+  }
+  return !pcl_.hasNamedOption("cache") && !pcl_.hasNamedOption("shared") && !pcl_.hasNamedOption("resume");
+}
+//----< answer query from session_ if it narrows the last; false to walk >
+/*
+ *  Only dirs with matches are shown, as with /H, since a narrowed
+ *  query doesn't visit dirs.  A query that doesn't narrow is walked by
+ *  step(), a dir at a time, adding each visit to the session.
+ */
+bool FileMgr::searchSession()
+{
+  SearchSession::Query query;
+  query.root = FileSystem::Path::getFullFileSpec(path_);
+  query.patterns = pcl_.patterns();
+  query.regex = regex_;
+  query.recursive = recursive_;
+  if (!session_->begin(query))
+    return false;
+  const SearchSession::Matches& matches = session_->matches();
+  const Path* dir = nullptr;
+  for (auto& match : matches)
+  {
+    if (!dir || *dir != match.dir)
+    {
+      dir = &match.dir;
+      std::cout << "\n  " << match.dir;
+    }
+    if (pcl_.hasOption('D'))
+      std::cout << "\n    " << reformatDate(FileSystem::FileInfo::dateOf(match.time)) << " -- " << match.name;
+    else
+      std::cout << "\n    " << match.name;
+  }
+  processedFiles_ = matches.size();
+  std::cout << "\n  session narrowed its last matches, reading no dirs";
+  return true;
+}
+//----< load /Q's queries, to be answered from one walk below path >
+/*
+ *  The walk reads each dir once, for all queries, and matches no files
+ *  itself, since each query matches its own.  step() gives each visit
+ *  to the batch, and finish() closes its results.
+ */
+bool FileMgr::startBatch()
+{
+  batch_.reset(new QueryBatch([this](unsigned long long time) {
+    return reformatDate(FileSystem::FileInfo::dateOf(time));
+  }));
+  if (!batch_->load(FileSystem::Path::getFullFileSpec(pcl_.options()['Q'])))
+  {
+    std::cout << "\n  " << batch_->error();
+    batch_.reset();
+    return false;
+  }
+  FindEngine::Query query;
+  query.root = FileSystem::Path::getFullFileSpec(path_);
+  query.recursive = recursive_;
+  query.files = false;
+  walk_.reset(new FindEngine::Walk(engine(), query));
+  return true;
+}
+//----< close /Q's results, showing each query's counts >------------
+
+void FileMgr::endBatch()
+{
+  if (!batch_->close())
+    std::cout << "\n  " << batch_->error();
+  for (auto& query : batch_->queries())
+  {
+    std::cout << "\n  " << query.outFile << ": " << query.files << " files, " << query.dirs << " dirs -- " << query.text;
+    processedFiles_ += query.files;
+  }
+  batch_.reset();
 }
 
 void FileMgr::showProcessed()
@@ -246,6 +1338,7 @@ void FileMgr::showProcessed()
 #include <map>
 #include <iostream>
 #include <functional>
+#include <thread>
 #include "../CppUtilities/CodeUtilities/CodeUtilities.h"
 #include "../CppUtilities/StringUtilities/StringUtilities.h"
 //#include "../Utilities/StringUtilities/StringUtilities.h"
@@ -253,60 +1346,282 @@ void FileMgr::showProcessed()
 using Path = std::string;
 using File = std::string;
 
-int main(int argc, char* argv[])
+namespace
 {
-  FileMgr fm;
+  //----< set up fm for a query; false if there is nothing to search >
 
-  if (!fm.processCmdLine(argc, argv))
+  bool prepare(FileMgr& fm, int argc, char* argv[])
   {
-    return 1;
+    if (!fm.processCmdLine(argc, argv))
+    {
+      return false;
+    }
+    Utilities::ProcessCmdLine& pcl = fm.pcl();
+
+    std::cout << "\n  FindFiles";
+
+    if (fm.pcl().hasOption('v'))
+    {
+      fm.pcl().showCmdLine(argc, argv, true);
+
+      std::cout << "\n    path  = " << fm.path();
+      if (fm.pcl().patterns().size() > 0)
+      {
+        std::cout << "\n    patts = ";
+        for (auto patt : fm.pcl().patterns())
+        {
+          std::cout << patt << " ";
+        }
+      }
+      if (fm.pcl().options().size() > 0)
+      {
+        std::cout << "\n    optns = ";
+        for (auto opt : fm.pcl().options())
+        {
+          std::cout << '/' << opt.first << " " << opt.second << " ";
+        }
+        fm.pcl().showNamedOptions();
+      }
+      std::cout << "\n    regex = " << fm.regex() << "\n";
+    }
+
+    fm.path(fm.pcl().path());
+    for (auto patt : fm.pcl().patterns())
+      fm.addPattern(patt);
+
+    if (pcl.hasOption('s'))
+      fm.recursive(true);
+
+    if(pcl.parseError())
+    {
+      std::cout << "\n    command line parsing failed\n\n";
+      return false;
+    }
+    return true;
+  }
+  /////////////////////////////////////////////////////////////////////
+  // Redirect class
+  // - sends std::cout to another stream, or streambuf, while in scope
+
+  class Redirect
+  {
+  public:
+    Redirect(std::ostream& to) : saved_(std::cout.rdbuf(to.rdbuf())) {}
+    Redirect(std::streambuf* to) : saved_(std::cout.rdbuf(to)) {}
+    ~Redirect()
+    {
+      std::cout.flush();
+      std::cout.rdbuf(saved_);
+    }
+  private:
+    std::streambuf* saved_;
+  };
+
+  //----< one query, as run from the command line >-------------------
+  /*
+   *  Results go to stdout through an OutputSink, written a large block
+   *  at a time.  A walk stops when the sink's pipe has been closed.
+   */
+  int findFiles(int argc, char* argv[])
+  {
+    OutputSink sink;
+    Redirect toSink(&sink);
+    FileMgr fm;
+    if (!prepare(fm, argc, argv))
+      return 1;
+    fm.search();
+    fm.showProcessed();
+    std::cout << "\n\n";
+    return sink.broken() ? 1 : 0;
   }
-  Utilities::ProcessCmdLine& pcl = fm.pcl();
 
-  std::cout << "\n  FindFiles";
 
-  if (fm.pcl().hasOption('v'))
+  /////////////////////////////////////////////////////////////////////
+  // FindJob class
+  // - a client's query, run by the server's scheduler a dir at a time
+  // - the first step parses the query in the client's dir and starts
+  //   it; index queries and facets complete in that step, from the
+  //   kept index; index builds, snapshot, and ring queries, which
+  //   would hold up every other query for as long, are refused
+
+  using Sessions = std::map<std::string, std::unique_ptr<SearchSession>>;
+  const size_t MaxSessions = 64;
+
+  class FindJob : public QueryScheduler::Job
+  {
+  public:
+    FindJob(const QueryServer::Args& args, std::shared_ptr<QueryServer::Reply> reply, Sessions& sessions)
+      : args_(args), reply_(reply), sessions_(sessions) {}
+    bool step() override;
+    size_t memory() const override { return fm_.memory(); }
+    size_t unsent() const override { return reply_->unsent(); }
+    void done(const QueryScheduler::Times& times) override;
+    QueryScheduler::Class priority() const;
+  private:
+    bool begin();
+    QueryServer::Args args_;
+    std::shared_ptr<QueryServer::Reply> reply_;
+    Sessions& sessions_;
+    FileMgr fm_;
+    bool started_ = false;
+    bool walking_ = false;
+  };
+
+  //----< class named by /priority, interactive by default >-----------
+
+  QueryScheduler::Class FindJob::priority() const
   {
-    fm.pcl().showCmdLine(argc, argv, true);
+    auto iter = std::find(args_.begin(), args_.end(), "/priority");
+    if (iter != args_.end() && iter + 1 != args_.end() && *(iter + 1) == "batch")
+      return QueryScheduler::Batch;
+    return QueryScheduler::Interactive;
+  }
+  //----< parse and start query, as from the client's dir >------------
 
-    std::cout << "\n    path  = " << fm.path();
-    if (fm.pcl().patterns().size() > 0)
+  bool FindJob::begin()
+  {
+    std::vector<char*> argv{ const_cast<char*>("FindFiles") };
+    for (auto& arg : args_)
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    std::string home = FileSystem::Directory::getCurrentDirectory();
+    FileSystem::Directory::setCurrentDirectory(reply_->cwd());
+    bool ok = prepare(fm_, static_cast<int>(argv.size()), argv.data());
+    std::string whole = ok ? fm_.unstepped() : "";
+    if (whole.size() > 0)
     {
-      std::cout << "\n    patts = ";
-      for (auto patt : fm.pcl().patterns())
-      {
-        std::cout << patt << " ";
-      }
+      std::cout << "\n  /" << whole << " can't be run a dir at a time, so isn't served; run it without /via\n\n";
+      ok = false;
     }
-    if (fm.pcl().options().size() > 0)
+    std::vector<std::string> id = fm_.pcl().namedOption("session");
+    if (ok && id.size() > 0)
     {
-      std::cout << "\n    optns = ";
-      for (auto opt : fm.pcl().options())
+      if (sessions_.size() >= MaxSessions && sessions_.count(id[0]) == 0)
+        sessions_.clear();
+      std::unique_ptr<SearchSession>& session = sessions_[id[0]];
+      if (!session)
+        session.reset(new SearchSession());
+      fm_.session(session.get());
+    }
+    walking_ = ok && fm_.start();
+    FileSystem::Directory::setCurrentDirectory(home);
+    return ok;
+  }
+  //----< next dir of query; false when done or the client is gone >--
+
+  bool FindJob::step()
+  {
+    if (reply_->broken())
+      return false;
+    Redirect redirect(reply_->out());
+    try
+    {
+      if (!started_)
       {
-        std::cout << '/' << opt.first << " " << opt.second << " ";
+        started_ = true;
+        if (!begin())
+          return false;
       }
+      if (walking_ && fm_.step())
+        return true;
+      if (walking_)
+        fm_.finish();
+      walking_ = false;
+      fm_.showProcessed();
+      std::cout << "\n\n";
+    }
+    catch (std::exception& ex)
+    {
+      std::cout << "\n  query failed: " << ex.what() << "\n\n";
+    }
+    catch (...)
+    {
+      std::cout << "\n  query failed\n\n";
     }
-    std::cout << "\n    regex = " << fm.regex() << "\n";
+    return false;
   }
+  //----< end reply, logging query's waits on the server's console >---
 
-  fm.path(fm.pcl().path());
-  for (auto patt : fm.pcl().patterns())
-    fm.addPattern(patt);
-  
-  if (pcl.hasOption('s'))
-    fm.recursive(true);
-
-  if(pcl.parseError())
+  void FindJob::done(const QueryScheduler::Times& times)
+  {
+    if (times.stopped.size() > 0)
+    {
+      Redirect redirect(reply_->out());
+      fm_.finish();
+      std::cout << "\n  query stopped, it " << times.stopped;
+      fm_.showProcessed();
+      std::cout << "\n\n";
+    }
+    std::ostringstream log;
+    log << "\n  " << QueryScheduler::name(priority()) << " query waited " << std::fixed << std::setprecision(2)
+      << times.waitMillis << " ms, ran " << times.runMillis << " ms in " << times.slices << " slices --";
+    for (auto& arg : args_)
+      log << " " << arg;
+    if (times.stopped.size() > 0)
+      log << "\n    stopped, it " << times.stopped;
+    std::cout << log.str() << std::flush;
+    reply_.reset();
+  }
+  //----< answer queries sent to pipe name, until the server fails >---
+  /*
+   *  Requests are accepted on other threads and queued with the
+   *  scheduler, which runs all queries on this thread, so FileMgr, its
+   *  caches, and std::cout are used by one thread only.  The shared dir
+   *  cache is kept open so listings read for one query stay available
+   *  to the next, which only has it open while running.  Sessions are
+   *  used only by queries, so on the same thread.
+   */
+  int serve(const std::string& name)
   {
-    std::cout << "\n    command line parsing failed\n\n";
+    SharedDirCache dirCache;
+    Sessions sessions;
+    QueryScheduler scheduler;
+    QueryServer server(name);
+    std::cout << "\n  FindFiles serving " << QueryServer::pipeName(name) << std::flush;
+    std::thread accept([&]() {
+      server.run([&](const QueryServer::Args& args, std::shared_ptr<QueryServer::Reply> reply) {
+        std::shared_ptr<FindJob> job = std::make_shared<FindJob>(args, reply, sessions);
+        scheduler.submit(job, job->priority());
+      });
+      scheduler.shutdown();
+    });
+    scheduler.run();
+    accept.join();
+    std::cout << "\n  " << server.error() << "\n\n";
     return 1;
   }
+  //----< send args to server name and show its results >--------------
 
-  fm.search();
-  fm.showProcessed();
+  int via(const std::string& name, const QueryServer::Args& args)
+  {
+    OutputSink sink;
+    Redirect toSink(&sink);
+    std::string error;
+    if (!QueryClient::ask(name, args, std::cout, error))
+    {
+      std::cout << "\n  " << error << "\n\n";
+      return 1;
+    }
+    return 0;
+  }
+}
 
-  std::cout << "\n\n";
-  return 0;
+int main(int argc, char* argv[])
+{
+  QueryServer::Args args;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if ((arg == "/serve" || arg == "/via") && i + 1 < argc)
+    {
+      std::string name = argv[++i];
+      if (arg == "/serve")
+        return serve(name);
+      args.insert(args.end(), argv + i + 1, argv + argc);
+      return via(name, args);
+    }
+    args.push_back(arg);
+  }
+  return findFiles(argc, argv);
 }
 
 #endif
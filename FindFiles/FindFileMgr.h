@@ -2,7 +2,7 @@
 #define FINDFILEMGR_H
 ///////////////////////////////////////////////////////////////////////
 // FindFileMgr.h - Find dates of files matching specified patterns   //
-// Ver 1.3                                                           //
+// Ver 1.28                                                          //
 // Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018           //
 ///////////////////////////////////////////////////////////////////////
 /*
@@ -11,16 +11,134 @@
  * FindFileMgr uses the services of FileSystem to find files.
  * - Finds all files, matching a regular expression, along with their paths.
  * - Filters files by pattern before searching for regex match.
+ * - Optionally searches contents of matching files, including gzip
+ *   and zstd compressed files, reporting matching lines.
+ * - Optionally keeps a persistent trigram index of file contents so
+ *   repeated content searches read only candidate files.
+ * - Optionally builds a memory-mapped index of all file names and
+ *   answers later queries from it without walking the tree, and
+ *   optionally keeps that index current from change notifications.
+ *   Copies of other hosts' indexes can be merged into one global index.
+ * - Optionally shows the entries of timestamped logs that fall in a
+ *   time range, found by binary search of the memory-mapped file.
+ * - Optionally keeps only files last written in a time range, and
+ *   counts indexed matches by extension and by subdir.
+ * - Optionally caches a query's results per dir, so a repeat run
+ *   enumerates only dirs changed since the last, and optionally shares
+ *   dir listings with other FindFiles processes through shared memory.
+ * - Optionally saves a snapshot of a tree's files, or reports files
+ *   added, removed, modified, and renamed between two snapshots, or
+ *   combines two snapshots into their union, intersection, or difference.
+ * - Optionally answers a file of queries from one walk of the tree.
+ * - Optionally runs as a server answering queries sent over a named
+ *   pipe, keeping compiled regexes and opened indexes between them,
+ *   and time slicing concurrent queries by priority.  A client's
+ *   session answers queries narrowing its last from the last's matches.
+ *   Index builds, snapshot, and ring queries, which can't be sliced,
+ *   aren't served; index queries, one short step, are.
+ * - A walk may be run a dir at a time, with start(), step(), and
+ *   finish(), instead of all at once with search().
+ * - Walks and name matching are FindEngine's: FileMgr shows the visits
+ *   of a FindEngine::Walk, /Q batches and sessions consume them, and
+ *   tools wanting name searches in process use FindEngine directly,
+ *   with matches passed to a callback.
+ * - Optionally stops a walk at a deadline, showing partial results and
+ *   a token from which a later run resumes the walk.
+ * - Optionally writes matches to a ring in shared memory, from which a
+ *   consumer process takes them in place, without parsing text.
  *
  * Required Files:
  * ---------------
  * FindFileMgr.h, FindFileMgr.cpp
  * FileSystem.h, FileSystem.cpp,
+ * TextSearch.h, TextSearch.cpp,
+ * Decompressor.h, Decompressor.cpp,
+ * ContentIndex.h, ContentIndex.cpp,
+ * Trigram.h, Trigram.cpp, BinaryIO.h
+ * LogSlice.h, LogSlice.cpp
+ * NameIndex.h, NameIndex.cpp, NameMatch.h, NameMatch.cpp, Roaring.h, Roaring.cpp
+ * IndexLog.h, IndexLog.cpp, Snapshot.h, Snapshot.cpp
+ * IndexWatch.h, IndexWatch.cpp, QueryCache.h, QueryCache.cpp
+ * SharedDirCache.h, SharedDirCache.cpp, QueryServer.h, QueryServer.cpp
+ * QueryBatch.h, QueryBatch.cpp, QueryScheduler.h, QueryScheduler.cpp
+ * SearchSession.h, SearchSession.cpp, Continuation.h, Continuation.cpp
+ * FindEngine.h, FindEngine.cpp, ResultRing.h, ResultRing.cpp
+ * OutputSink.h, OutputSink.cpp
  * CodeUtilities.h, 
  * StringUtilities.h
  *
  * Maintenance History:
  * --------------------
+ * Ver 1.28 : 18 Oct 2026
+ * - /Q batches are walked a dir at a time by step(), like other walks
+ * - unstepped() names the option of a query start() runs to its end,
+ *   which the server refuses rather than run in one slice, except for
+ *   /index query and facets, answered from the index kept mapped
+ * - /C reports files it couldn't read, e.g., compressed files of a
+ *   format the build lacks, as skipped, instead of leaving them out
+ * Ver 1.27 : 18 Oct 2026
+ * - walks are FindEngine Walks, which list, match, and read dirs ahead,
+ *   so FileMgr keeps only showing matches, /C, /T, and scheduling;
+ *   /cache and /shared supply listings to the walk
+ * Ver 1.26 : 18 Oct 2026
+ * - output is written a large block at a time, through OutputSink, and
+ *   a walk stops when its output pipe is closed
+ * Ver 1.25 : 18 Oct 2026
+ * - added /ring name, streaming matches to a consumer through shared memory
+ * Ver 1.24 : 18 Oct 2026
+ * - regexes are compiled and kept by FindEngine, the library form of
+ *   name searches
+ * Ver 1.23 : 18 Oct 2026
+ * - added /timeout ms and /resume token
+ * Ver 1.22 : 18 Oct 2026
+ * - added /union, /intersect, and /minus of snapshots
+ * Ver 1.21 : 18 Oct 2026
+ * - added /session id, for search as you type through /serve
+ * Ver 1.20 : 18 Oct 2026
+ * - walks keep a frontier of dirs to visit instead of recursing, so
+ *   they can be run a dir at a time
+ * - /serve answers clients concurrently, scheduling their queries by
+ *   /priority interactive|batch
+ * Ver 1.19 : 18 Oct 2026
+ * - added /Q file, answering many queries from one walk
+ * Ver 1.18 : 18 Oct 2026
+ * - added /serve name and /via name, a resident server and its client
+ * - regexes are compiled per query, not once per process, and reused
+ *   by later queries with the same regex
+ * Ver 1.17 : 18 Oct 2026
+ * - added /shared, sharing dir listings between concurrent processes
+ * Ver 1.16 : 18 Oct 2026
+ * - added /cache, reusing a query's names in unchanged dirs
+ * Ver 1.15 : 18 Oct 2026
+ * - added /index merge of other hosts' indexes into a global index
+ * Ver 1.14 : 18 Oct 2026
+ * - added /snapshot file and /diff before after
+ * Ver 1.13 : 18 Oct 2026
+ * - /index build walks on several threads, with /threads n, and shows
+ *   progress and throughput
+ * Ver 1.12 : 18 Oct 2026
+ * - /index watch reports changes replayed from the index's log
+ * Ver 1.11 : 18 Oct 2026
+ * - added /M from..to, which keeps files last written in the range,
+ *   and /index facets, which counts matches by extension and subdir
+ * Ver 1.10 : 18 Oct 2026
+ * - /index build /suffixes adds a suffix array of names to the index
+ * Ver 1.9 : 18 Oct 2026
+ * - /index query /d matches dirs through the index's dir name trigrams
+ * Ver 1.8 : 18 Oct 2026
+ * - added /index watch, which applies file system changes to the
+ *   index until stopped with Ctrl-C
+ * Ver 1.7 : 18 Oct 2026
+ * - added /index [build|query] [indexFile] for name searches answered
+ *   from a persistent index
+ * Ver 1.6 : 18 Oct 2026
+ * - added /T from..to for showing log entries in a time range
+ * Ver 1.5 : 18 Oct 2026
+ * - added /index-content [build|query] [indexFile] for content search
+ *   backed by an incrementally updated trigram index
+ * Ver 1.4 : 18 Oct 2026
+ * - added /C option for searching file contents, with transparent
+ *   decompression of *.gz and *.zst files
  * Ver 1.3 : 24 Jun 2019
  * - fixed bug in non-recursive operation
  * - fixed bugs in options processing
@@ -37,9 +155,21 @@
 #include <vector>
 #include <map>
 #include <functional>
+#include <memory>
+#include <regex>
+#include <chrono>
+#include "TextSearch.h"
+#include "LogSlice.h"
+#include "QueryCache.h"
+#include "SharedDirCache.h"
+#include "FindEngine.h"
 //#include "../Utilities/CodeUtilities/CodeUtilities.h"
 #include "../CppUtilities/CodeUtilities/CodeUtilities.h"
 
+class NameIndexView;
+class QueryBatch;
+class SearchSession;
+
 class FileMgr
 {
 public:
@@ -55,6 +185,7 @@ public:
   using const_reverse_iterator = DataStore::const_reverse_iterator;
 
   FileMgr();
+  ~FileMgr();
   bool processCmdLine(int argc, char** argv);
   Utilities::ProcessCmdLine& pcl();
   void path(const Path& path);
@@ -67,18 +198,65 @@ public:
   size_t numFiles();
   void addPattern(const std::string& patt);
   void search();
+  bool start();
+  bool step();
+  void finish();
+  size_t pending() const;
+  std::string unstepped();
+  size_t memory() const;
+  void searchContentIndex();
+  void searchNameIndex();
+  void watchNameIndex(const Path& indexFile);
+  void countFacets(const Path& indexFile);
+  void mergeNameIndexes(const Path& indexFile, const std::vector<std::string>& inputs);
+  Path indexPath(const NameIndexView& view);
+  void takeSnapshot();
+  void diffSnapshots();
+  void combineSnapshots(const std::string& op);
+  bool startBatch();
+  void session(SearchSession* session);
+  bool searchSession();
+  void streamToRing();
   void find(const Path& path);
   void showProcessed();
 private:
   Date reformatDate(const Date& date);
+  std::string contentMatches(const File& fileSpec);
+  std::string timeSlice(const File& fileSpec);
+  bool fileContents(const File& fileSpec, std::string& lines);
+  bool modifiedRange(const std::string& fromTo);
+  std::string queryKey(const Path& fullPath);
+  std::string continuationKey(const Path& fullPath);
+  FindEngine::Query engineQuery(const Path& root);
+  bool listDir(const Path& dir, FindEngine::Entries& entries);
+  void endBatch();
+  bool sessionQuery();
+  bool resume(const Path& fullPath);
+  void suspend();
+  void show(FindEngine::Visit& visit);
   Utilities::ProcessCmdLine pcl_;
   Path path_;
   Patterns patterns_;
   Regex regex_ = ".*";
+  TextSearcher textSearcher_;
+  LogSlicer logSlicer_;
+  unsigned long long modifiedFrom_ = 0;     // /M range, 100 ns ticks, UTC
+  unsigned long long modifiedTo_ = ~0ULL;
   bool recursive_ = false;
   size_t numFiles_ = 0;
   size_t processedFiles_ = 0;
   size_t processedDirs_ = 0;
+  std::unique_ptr<QueryCache> cache_;           // with /cache
+  std::unique_ptr<SharedDirCache> dirCache_;    // with /shared
+  std::unique_ptr<FindEngine::Walk> walk_;      // matches of the query, a dir at a time
+  Path root_;                                   // full path of walk_'s root, as start() found it
+  std::unique_ptr<QueryBatch> batch_;           // with /Q, answered from walk_'s visits
+  SearchSession* session_ = nullptr;            // with /session, kept by server
+  bool sessionWalk_ = false;                    // session_'s query didn't narrow, so is walked
+  size_t threads_ = 0;                          // with /index build /threads, 0 is one per core
+  unsigned long timeoutMillis_ = 0;             // with /timeout
+  std::chrono::steady_clock::time_point deadline_;
+  bool stopped_ = false;                        // at deadline_, with dirs left
 };
 
 inline Utilities::ProcessCmdLine& FileMgr::pcl()
@@ -105,6 +283,21 @@ inline void FileMgr::regex(const Regex& rx)
   regex_ = rx;
 }
 
+inline void FileMgr::session(SearchSession* session)
+{
+  session_ = session;
+}
+
+inline size_t FileMgr::pending() const
+{
+  return walk_ ? walk_->pending() : 0;
+}
+
+inline size_t FileMgr::memory() const
+{
+  return walk_ ? walk_->memory() : 0;
+}
+
 inline void FileMgr::numFiles(size_t num) 
 { 
   numFiles_ = num; 
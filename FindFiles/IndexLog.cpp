@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////
+// IndexLog.cpp - write-ahead log of changes to a name index         //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Log file layout, all integers little-endian:
+ *   per record - u32 payload size, u32 FNV-1a checksum of payload,
+ *   then payload - u8 op, varint path length, path
+ */
+
+#include "IndexLog.h"
+#include "BinaryIO.h"
+
+namespace
+{
+  const uint32_t MaxPayload = 64 * 1024;   // longer is a damaged size field
+}
+//----< log appends to logFile, which need not exist yet >-----------
+
+IndexLog::IndexLog(const Path& logFile) : file_(logFile) {}
+
+//----< close log; appended records stay on disk >-------------------
+
+IndexLog::~IndexLog()
+{
+  if (hFile_ != INVALID_HANDLE_VALUE)
+    ::CloseHandle(hFile_);
+}
+//----< append one record, opening or creating log if needed >-------
+/*
+ *  The record goes to the file in one write, so a crash leaves at
+ *  most the last record torn.
+ */
+bool IndexLog::append(Op op, const Path& path)
+{
+  if (hFile_ == INVALID_HANDLE_VALUE)
+  {
+    hFile_ = ::CreateFileA(
+      file_.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE,
+      NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL
+    );
+    if (hFile_ == INVALID_HANDLE_VALUE)
+    {
+      error_ = "can't open log " + file_;
+      return false;
+    }
+  }
+  std::string payload;
+  BinaryIO::Writer pw(payload);
+  pw.u8(static_cast<uint8_t>(op));
+  pw.str(path);
+  std::string record;
+  BinaryIO::Writer wr(record);
+  wr.u32(static_cast<uint32_t>(payload.size()));
+  wr.u32(BinaryIO::fnv1a32(payload.data(), payload.size()));
+  record += payload;
+  DWORD written = 0;
+  if (!::WriteFile(hFile_, record.data(), static_cast<DWORD>(record.size()), &written, NULL) || written != record.size())
+  {
+    error_ = "can't append to log " + file_;
+    return false;
+  }
+  ++appended_;
+  return true;
+}
+//----< flush records appended since last sync to disk >------------
+
+bool IndexLog::sync()
+{
+  if (hFile_ == INVALID_HANDLE_VALUE || synced_ == appended_)
+    return true;
+  if (!::FlushFileBuffers(hFile_))
+  {
+    error_ = "can't flush log " + file_;
+    return false;
+  }
+  synced_ = appended_;
+  return true;
+}
+//----< read intact records, truncating a torn tail >----------------
+/*
+ *  Returns false if there is no log.  Must not be called while the
+ *  log is open for appending.
+ */
+bool IndexLog::read(const Path& logFile, Records& records)
+{
+  records.clear();
+  std::string buffer;
+  if (!FileSystem::File::exists(logFile) || !BinaryIO::readFile(logFile, buffer))
+    return false;
+  BinaryIO::Reader rd(buffer);
+  size_t good = 0;
+  while (!rd.atEnd())
+  {
+    uint32_t size = rd.u32();
+    uint32_t sum = rd.u32();
+    const char* payload = (size <= MaxPayload) ? rd.bytes(size) : nullptr;
+    if (!rd.good() || payload == nullptr || BinaryIO::fnv1a32(payload, size) != sum)
+      break;
+    BinaryIO::Reader prd(payload, payload + size);
+    uint8_t op = prd.u8();
+    Path path = prd.str();
+    if (!prd.good() || !prd.atEnd() || op < Update || op > Refresh)
+      break;
+    records.push_back(Record{ static_cast<Op>(op), path });
+    good = rd.pos() - buffer.data();
+  }
+  if (good < buffer.size())
+    BinaryIO::writeFile(logFile, buffer.substr(0, good));
+  return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_INDEXLOG
+
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Testing IndexLog";
+  std::cout << "\n ==================";
+
+  std::string file = "IndexLog.test";
+  FileSystem::File::remove(file);
+  {
+    IndexLog log(file);
+    log.append(IndexLog::Update, "C:\\su\\FindFiles\\NameIndex.h");
+    log.append(IndexLog::Remove, "C:\\su\\FindFiles\\Old.cpp");
+    log.append(IndexLog::Rescan, "C:\\su\\CppUtilities");
+    log.sync();
+    std::cout << "\n  appended " << log.appended() << " records";
+  }
+  std::string buffer;
+  BinaryIO::readFile(file, buffer);
+  buffer.resize(buffer.size() - 5);   // tear last record, as a crash might
+  BinaryIO::writeFile(file, buffer);
+
+  IndexLog::Records records;
+  IndexLog::read(file, records);
+  std::cout << "\n  read " << records.size() << " intact records:";
+  for (auto& rec : records)
+    std::cout << "\n    " << rec.op << "  " << rec.path;
+  {
+    IndexLog log(file);
+    log.append(IndexLog::Refresh, "C:\\su\\FindFiles");
+  }
+  IndexLog::read(file, records);
+  std::cout << "\n  after append, read " << records.size() << " records";
+  FileSystem::File::remove(file);
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,99 @@
+#ifndef INDEXLOG_H
+#define INDEXLOG_H
+///////////////////////////////////////////////////////////////////////
+// IndexLog.h - write-ahead log of changes to a name index           //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Saving a name index rewrites the whole file, which is too slow to do
+ * after every change on a busy tree.  IndexLog lets a watcher record
+ * each change cheaply instead.  Every record is appended to the log
+ * before it is applied to the loaded index, and a batch is flushed to
+ * disk with sync().  If the process dies, loading the index replays
+ * the log, so no change seen since the last save is lost.
+ *
+ * Records hold the change, e.g., update or remove, and the path it was
+ * reported for.  Replay re-reads each path, as the watcher did, so
+ * replaying a record twice does no harm.
+ *
+ * Each record carries its length and a checksum.  A crash in the middle
+ * of an append leaves a torn last record.  read(...) stops there and
+ * truncates the file to the records before it, so later appends are
+ * not hidden behind it.
+ *
+ * Public Interface:
+ * -----------------
+ * IndexLog log(NameIndex::logFile(indexFile, generation));
+ * log.append(IndexLog::Update, path);
+ * log.sync();
+ * IndexLog::Records records;
+ * if (IndexLog::read(log.file(), records)) ...
+ *
+ * Required Files:
+ * ---------------
+ * IndexLog.h, IndexLog.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <windows.h>
+
+class IndexLog
+{
+public:
+  using Path = std::string;
+  enum Op { Update = 1, Remove = 2, Rescan = 3, Refresh = 4 };
+
+  struct Record
+  {
+    Op op;
+    Path path;
+  };
+  using Records = std::vector<Record>;
+
+  IndexLog(const Path& logFile);
+  ~IndexLog();
+  IndexLog(const IndexLog&) = delete;
+  IndexLog& operator=(const IndexLog&) = delete;
+
+  bool append(Op op, const Path& path);
+  bool sync();
+  size_t appended() const;
+  Path file() const;
+  std::string error() const;
+
+  static bool read(const Path& logFile, Records& records);
+private:
+  Path file_;
+  HANDLE hFile_ = INVALID_HANDLE_VALUE;   // opened by first append
+  size_t appended_ = 0;
+  size_t synced_ = 0;
+  std::string error_;
+};
+
+inline size_t IndexLog::appended() const
+{
+  return appended_;
+}
+
+inline IndexLog::Path IndexLog::file() const
+{
+  return file_;
+}
+
+inline std::string IndexLog::error() const
+{
+  return error_;
+}
+
+#endif
@@ -0,0 +1,341 @@
+///////////////////////////////////////////////////////////////////////
+// IndexWatch.cpp - keeps a name index current from change notices   //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "IndexWatch.h"
+#include <cstring>
+
+namespace
+{
+  const ULONG_PTR StopKey = ~static_cast<ULONG_PTR>(0);
+  const DWORD BufferBytes = 64 * 1024;   // largest that works on network shares
+  const DWORD Filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                       FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+  //----< notices carry UTF-16 names, the index holds ANSI names >---
+
+  std::string narrow(const WCHAR* name, int count)
+  {
+    int size = ::WideCharToMultiByte(CP_ACP, 0, name, count, NULL, 0, NULL, NULL);
+    std::string result(size, '\0');
+    if (size > 0)
+      ::WideCharToMultiByte(CP_ACP, 0, name, count, &result[0], size, NULL, NULL);
+    return result;
+  }
+}
+
+const DWORD IndexWatcher::QuietMillis;
+const DWORD IndexWatcher::MaxDelayMillis;
+const DWORD IndexWatcher::PollMillis;
+
+//----< watch tree of a loaded index >-------------------------------
+
+IndexWatcher::IndexWatcher(NameIndex& index) : index_(index), done_(false) {}
+
+//----< cancel outstanding reads and close handles >-----------------
+
+IndexWatcher::~IndexWatcher()
+{
+  if (compactor_.joinable())
+    compactor_.join();
+  for (auto& w : watches_)
+    close(*w);
+  if (port_ != NULL)
+    ::CloseHandle(port_);
+}
+//----< open completion port and watches >---------------------------
+
+bool IndexWatcher::start()
+{
+  port_ = ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+  if (port_ == NULL)
+  {
+    error_ = "can't create completion port";
+    return false;
+  }
+  index_.logChanges(true);
+  stats_.replayed = index_.stats().replayed;
+  savedFiles_ = index_.stats().files;
+  Path root = index_.root();
+  addWatch(root, false);
+  for (auto entry : FileSystem::Directory::getEntries(root))
+  {
+    if (entry.isDir)
+      addWatch(root + "\\" + entry.name, true);
+  }
+  return true;
+}
+//----< watch dir, or poll it if it can't be watched >---------------
+
+void IndexWatcher::addWatch(const Path& dir, bool recursive)
+{
+  watches_.push_back(std::unique_ptr<Watch>(new Watch));
+  Watch& w = *watches_.back();
+  w.dir = dir;
+  w.recursive = recursive;
+  w.buffer.resize(BufferBytes / sizeof(DWORD));
+  w.hDir = ::CreateFileA(
+    dir.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL
+  );
+  ULONG_PTR key = watches_.size() - 1;
+  if (w.hDir == INVALID_HANDLE_VALUE || ::CreateIoCompletionPort(w.hDir, port_, key, 0) == NULL || !arm(w))
+  {
+    close(w);
+    w.closed = false;
+    w.polling = true;
+    w.nextPoll = ::GetTickCount64() + PollMillis;
+  }
+}
+//----< start next asynchronous read of change notices >-------------
+
+bool IndexWatcher::arm(Watch& w)
+{
+  std::memset(&w.ov, 0, sizeof(w.ov));
+  return ::ReadDirectoryChangesW(
+    w.hDir, w.buffer.data(), BufferBytes, w.recursive ? TRUE : FALSE, Filter, NULL, &w.ov, NULL
+  ) != FALSE;
+}
+//----< stop watching; a cancelled read still completes, ignored >---
+
+void IndexWatcher::close(Watch& w)
+{
+  if (w.hDir != INVALID_HANDLE_VALUE)
+  {
+    ::CancelIoEx(w.hDir, &w.ov);
+    ::CloseHandle(w.hDir);
+    w.hDir = INVALID_HANDLE_VALUE;
+  }
+  w.closed = true;
+  w.polling = false;
+}
+//----< open watch on dir, if any >----------------------------------
+
+IndexWatcher::Watch* IndexWatcher::find(const Path& dir)
+{
+  for (auto& w : watches_)
+  {
+    if (!w->closed && w->dir == dir)
+      return w.get();
+  }
+  return nullptr;
+}
+//----< apply a buffer of change notices to the index >--------------
+/*
+ *  The root watch is not recursive, so top level dirs that arrive or
+ *  leave also gain or lose their own watches.
+ */
+void IndexWatcher::apply(Watch& w, DWORD bytes)
+{
+  const char* pos = reinterpret_cast<const char*>(w.buffer.data());
+  const char* end = pos + bytes;
+  while (pos < end)
+  {
+    const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(pos);
+    Path path = w.dir + "\\" + narrow(info->FileName, static_cast<int>(info->FileNameLength / sizeof(WCHAR)));
+    switch (info->Action)
+    {
+    case FILE_ACTION_ADDED:
+    case FILE_ACTION_RENAMED_NEW_NAME:
+      index_.change(IndexLog::Update, path);
+      if (!w.recursive && FileSystem::Directory::exists(path) && find(path) == nullptr)
+        addWatch(path, true);
+      break;
+    case FILE_ACTION_MODIFIED:
+      index_.change(IndexLog::Update, path);
+      break;
+    case FILE_ACTION_REMOVED:
+    case FILE_ACTION_RENAMED_OLD_NAME:
+      index_.change(IndexLog::Remove, path);
+      if (!w.recursive)
+      {
+        Watch* top = find(path);
+        if (top != nullptr)
+          close(*top);
+      }
+      break;
+    }
+    ++stats_.events;
+    if (info->NextEntryOffset == 0)
+      break;
+    pos += info->NextEntryOffset;
+  }
+}
+//----< notices were lost, so rescan just this watch's dirs >--------
+
+void IndexWatcher::rescan(Watch& w, std::ostream& out)
+{
+  index_.change(w.recursive ? IndexLog::Rescan : IndexLog::Refresh, w.dir);
+  ++stats_.rescans;
+  out << "\n  rescanned " << w.dir;
+}
+//----< read failed: dir is gone, or can no longer be watched >------
+
+void IndexWatcher::lost(Watch& w, std::ostream& out)
+{
+  close(w);
+  if (!FileSystem::Directory::exists(w.dir))
+  {
+    index_.change(IndexLog::Remove, w.dir);
+    return;
+  }
+  out << "\n  can't watch " << w.dir << ", polling";
+  w.closed = false;
+  w.polling = true;
+  rescan(w, out);
+  w.nextPoll = ::GetTickCount64() + PollMillis;
+}
+//----< rescan unwatchable subtrees that are due >-------------------
+
+void IndexWatcher::poll(ULONGLONG now, std::ostream& out)
+{
+  for (auto& w : watches_)
+  {
+    if (!w->polling || now < w->nextPoll)
+      continue;
+    rescan(*w, out);
+    w->nextPoll = now + PollMillis;
+  }
+}
+//----< write index; a failed save is retried with the next batch >--
+
+void IndexWatcher::save(std::ostream& out)
+{
+  report(index_.save(), index_, out);
+}
+//----< save snapshot of index on compactor thread >-----------------
+
+void IndexWatcher::compact()
+{
+  snapshot_.reset(new NameIndex(index_.snapshot()));
+  done_ = false;
+  compactor_ = std::thread([this]() {
+    saved_ = snapshot_->save();
+    done_ = true;
+  });
+}
+//----< report finished snapshot save, waiting for it if asked >-----
+/*
+ *  A failed save loses nothing, since its changes are still in logs
+ *  it didn't delete, but it isn't tried again until the next change.
+ */
+void IndexWatcher::compacted(std::ostream& out, bool wait)
+{
+  if (!compactor_.joinable() || (!wait && !done_))
+    return;
+  compactor_.join();
+  report(saved_, *snapshot_, out);
+  snapshot_.reset();
+}
+
+void IndexWatcher::report(bool ok, NameIndex& saved, std::ostream& out)
+{
+  if (!ok)
+  {
+    out << "\n  " << saved.error();
+    return;
+  }
+  ++stats_.saves;
+  NameIndex::Stats after = saved.stats();
+  out << "\n  saved " << after.dirs << " dirs, " << after.files << " files";
+  if (stats_.saves > 1)
+  {
+    long long delta = static_cast<long long>(after.files) - static_cast<long long>(savedFiles_);
+    out << " (" << (delta >= 0 ? "+" : "") << delta << ")";
+  }
+  savedFiles_ = after.files;
+  out.flush();
+}
+//----< wait for notices and apply them until stop() >--------------
+
+void IndexWatcher::run(std::ostream& out)
+{
+  ULONGLONG firstChange = 0;
+  ULONGLONG lastChange = 0;
+  while (true)
+  {
+    DWORD bytes = 0;
+    ULONG_PTR key = 0;
+    LPOVERLAPPED pov = NULL;
+    BOOL ok = ::GetQueuedCompletionStatus(port_, &bytes, &key, &pov, QuietMillis);
+    ULONGLONG now = ::GetTickCount64();
+    if (ok && key == StopKey)
+      break;
+    if (pov != NULL && key < watches_.size() && !watches_[key]->closed)
+    {
+      Watch& w = *watches_[key];
+      if (!ok)
+        lost(w, out);
+      else
+      {
+        if (bytes == 0)
+          rescan(w, out);   // buffer overflowed
+        else
+          apply(w, bytes);
+        if (!arm(w))
+          lost(w, out);
+      }
+      lastChange = now;
+    }
+    poll(now, out);
+    if (!index_.syncLog())
+      out << "\n  " << index_.error();
+    compacted(out, false);
+    if (!index_.dirty())
+      continue;
+    if (firstChange == 0)
+      firstChange = now;
+    if (!compactor_.joinable() && (now - lastChange >= QuietMillis || now - firstChange >= MaxDelayMillis))
+    {
+      compact();
+      firstChange = 0;
+    }
+  }
+  compacted(out, true);
+  if (index_.dirty())
+    save(out);
+}
+//----< ask run() to save and return, safe from any thread >---------
+
+void IndexWatcher::stop()
+{
+  if (port_ != NULL)
+    ::PostQueuedCompletionStatus(port_, 0, StopKey, NULL);
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_INDEXWATCH
+
+#include <thread>
+#include <chrono>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing IndexWatcher";
+  std::cout << "\n ======================";
+  std::string root = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : ".");
+  NameIndex ni(NameIndex::defaultFile(root));
+  if (!ni.load())
+  {
+    ni.build(root);
+    ni.save();
+  }
+  IndexWatcher iw(ni);
+  if (!iw.start())
+  {
+    std::cout << "\n  " << iw.error() << "\n\n";
+    return 1;
+  }
+  std::cout << "\n  watching " << root << " for 20 seconds";
+  std::thread timer([&]() { std::this_thread::sleep_for(std::chrono::seconds(20)); iw.stop(); });
+  iw.run(std::cout);
+  timer.join();
+  IndexWatcher::Stats st = iw.stats();
+  std::cout << "\n  " << st.events << " events, " << st.rescans << " rescans, " << st.saves << " saves, "
+    << st.replayed << " replayed\n\n";
+  return 0;
+}
+#endif
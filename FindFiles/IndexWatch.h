@@ -0,0 +1,141 @@
+#ifndef INDEXWATCH_H
+#define INDEXWATCH_H
+///////////////////////////////////////////////////////////////////////
+// IndexWatch.h - keeps a name index current from change notices     //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * IndexWatcher supports FindFiles /index watch.  It asks Windows for
+ * change notifications, with ReadDirectoryChangesW, and applies each
+ * create, delete, rename, and modify to a loaded NameIndex as a small
+ * update.  Each change is appended to the index's write-ahead log
+ * first, and each batch is flushed, so a crash loses nothing: the next
+ * load replays the log.
+ *
+ * Once changes stop for a second, or at least every ten seconds while
+ * they keep coming, a snapshot of the index is saved as a new segment
+ * on a background thread, and notices are applied meanwhile.  Readers
+ * switch to the new segment when it is complete.
+ *
+ * There is one watch for the files and dirs directly in the root and
+ * one recursive watch for each top level dir.  All complete on one
+ * I/O completion port, so there is no limit of 64 handles.
+ * - When a watch's buffer overflows, Windows reports that changes were
+ *   lost but not which.  Only that watch's subtree is rescanned.
+ * - A subtree that can't be watched, e.g., a share whose server
+ *   doesn't support notifications, is rescanned every minute instead.
+ * - A dir moved into the tree is walked when it arrives, since it
+ *   brings its contents without separate notices.
+ *
+ * Changes made while no watcher runs are not seen; /index build picks
+ * them up.
+ *
+ * Public Interface:
+ * -----------------
+ * NameIndex ni(indexFile);
+ * ni.load();
+ * IndexWatcher iw(ni);
+ * if (iw.start())
+ *   iw.run(std::cout);   // returns after iw.stop(), e.g., from Ctrl-C handler
+ *
+ * Required Files:
+ * ---------------
+ * IndexWatch.h, IndexWatch.cpp
+ * NameIndex.h, NameIndex.cpp, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - logs changes to the index's write-ahead log, and saves snapshots
+ *   on a background thread
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <windows.h>
+#include "NameIndex.h"
+
+class IndexWatcher
+{
+public:
+  using Path = std::string;
+
+  struct Stats
+  {
+    size_t events = 0;    // change notices applied
+    size_t rescans = 0;   // subtrees rescanned after overflow or while polling
+    size_t saves = 0;
+    size_t replayed = 0;   // logged changes applied when index was loaded
+  };
+
+  static const DWORD QuietMillis = 1000;       // save after this long without changes
+  static const DWORD MaxDelayMillis = 10000;   // or this long after first unsaved change
+  static const DWORD PollMillis = 60000;       // rescan interval of unwatchable subtrees
+
+  IndexWatcher(NameIndex& index);
+  ~IndexWatcher();
+  IndexWatcher(const IndexWatcher&) = delete;
+  IndexWatcher& operator=(const IndexWatcher&) = delete;
+
+  bool start();
+  void run(std::ostream& out);
+  void stop();
+  Stats stats();
+  std::string error();
+private:
+  struct Watch
+  {
+    Path dir;
+    bool recursive = true;
+    HANDLE hDir = INVALID_HANDLE_VALUE;
+    OVERLAPPED ov;
+    std::vector<DWORD> buffer;   // notices must be DWORD aligned
+    bool polling = false;
+    bool closed = false;
+    ULONGLONG nextPoll = 0;
+  };
+  void addWatch(const Path& dir, bool recursive);
+  bool arm(Watch& w);
+  void close(Watch& w);
+  void apply(Watch& w, DWORD bytes);
+  void rescan(Watch& w, std::ostream& out);
+  void lost(Watch& w, std::ostream& out);
+  void poll(ULONGLONG now, std::ostream& out);
+  void save(std::ostream& out);
+  void compact();
+  void compacted(std::ostream& out, bool wait);
+  void report(bool ok, NameIndex& saved, std::ostream& out);
+  Watch* find(const Path& dir);
+
+  NameIndex& index_;
+  HANDLE port_ = NULL;
+  std::vector<std::unique_ptr<Watch>> watches_;   // index is completion key
+  std::unique_ptr<NameIndex> snapshot_;            // saved by compactor_
+  std::thread compactor_;
+  std::atomic<bool> done_;
+  bool saved_ = false;
+  size_t savedFiles_ = 0;
+  Stats stats_;
+  std::string error_;
+};
+
+inline IndexWatcher::Stats IndexWatcher::stats()
+{
+  return stats_;
+}
+
+inline std::string IndexWatcher::error()
+{
+  return error_;
+}
+
+#endif
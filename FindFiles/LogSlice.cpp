@@ -0,0 +1,284 @@
+///////////////////////////////////////////////////////////////////////
+// LogSlice.cpp - find time range in a timestamped log by bisection //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "LogSlice.h"
+#include <cstring>
+#include <cctype>
+
+namespace
+{
+  using Stamp = LogSlicer::Stamp;
+
+  bool isDigit(char c)
+  {
+    return std::isdigit(static_cast<unsigned char>(c)) != 0;
+  }
+  //----< read exactly n digits at p, advancing p >------------------
+
+  bool digits(const char*& p, const char* end, size_t n, unsigned& value)
+  {
+    if (static_cast<size_t>(end - p) < n)
+      return false;
+    value = 0;
+    for (size_t i = 0; i < n; ++i, ++p)
+    {
+      if (!isDigit(*p))
+        return false;
+      value = 10 * value + (*p - '0');
+    }
+    return true;
+  }
+  //----< expect character c at p, advancing p >---------------------
+
+  bool expect(const char*& p, const char* end, char c)
+  {
+    if (p == end || *p != c)
+      return false;
+    ++p;
+    return true;
+  }
+  //----< pack fields so that later times compare greater >----------
+
+  Stamp pack(unsigned yr, unsigned mo, unsigned dy, unsigned hr, unsigned mn, unsigned sc)
+  {
+    return ((((yr * 100ULL + mo) * 100 + dy) * 100 + hr) * 100 + mn) * 100 + sc;
+  }
+  //----< hh:mm:ss >-------------------------------------------------
+
+  bool timeOfDay(const char*& p, const char* end, unsigned& hr, unsigned& mn, unsigned& sc)
+  {
+    return digits(p, end, 2, hr) && expect(p, end, ':') &&
+           digits(p, end, 2, mn) && expect(p, end, ':') &&
+           digits(p, end, 2, sc);
+  }
+  //----< yyyy-mm-dd or yyyy/mm/dd >---------------------------------
+
+  bool date(const char*& p, const char* end, unsigned& yr, unsigned& mo, unsigned& dy)
+  {
+    if (!digits(p, end, 4, yr) || p == end || (*p != '-' && *p != '/'))
+      return false;
+    char sep = *p++;
+    return digits(p, end, 2, mo) && expect(p, end, sep) && digits(p, end, 2, dy);
+  }
+  //----< Sun Oct 18 12:12:50 2026, as written by DateTime::now() >--
+
+  bool ctimeStamp(const char* p, const char* end, Stamp& stamp)
+  {
+    static const char* months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    if (end - p < 24 || p[3] != ' ' || p[7] != ' ')
+      return false;
+    const char* m = std::strstr(months, std::string(p + 4, 3).c_str());
+    if (m == nullptr || (m - months) % 3 != 0)
+      return false;
+    unsigned mo = static_cast<unsigned>(m - months) / 3 + 1;
+    p += 8;
+    unsigned dy = 0, hr, mn, sc, yr;
+    if (*p == ' ')
+      ++p;
+    if (!isDigit(*p))
+      return false;
+    while (p < end && isDigit(*p))
+      dy = 10 * dy + (*p++ - '0');
+    if (!expect(p, end, ' ') || !timeOfDay(p, end, hr, mn, sc) ||
+        !expect(p, end, ' ') || !digits(p, end, 4, yr))
+      return false;
+    stamp = pack(yr, mo, dy, hr, mn, sc);
+    return true;
+  }
+  //----< one end of a range; the time of day may be omitted >-------
+
+  bool rangeEnd(std::string text, bool isTo, Stamp& stamp, std::string& error)
+  {
+    size_t first = text.find_first_not_of(" \t");
+    size_t last = text.find_last_not_of(" \t");
+    text = (first == std::string::npos) ? "" : text.substr(first, last - first + 1);
+    if (text.size() == 0)
+    {
+      stamp = isTo ? ~0ULL : 0;
+      return true;
+    }
+    const char* p = text.data();
+    const char* end = p + text.size();
+    unsigned yr, mo, dy, hr = isTo ? 23 : 0, mn = isTo ? 59 : 0, sc = isTo ? 59 : 0;
+    bool ok = date(p, end, yr, mo, dy);
+    if (ok && p != end)
+    {
+      ok = (*p == ' ' || *p == 'T') && digits(++p, end, 2, hr) && expect(p, end, ':') && digits(p, end, 2, mn);
+      if (ok && p != end)
+        ok = expect(p, end, ':') && digits(p, end, 2, sc);
+      ok = ok && p == end;
+    }
+    if (!ok)
+    {
+      error = "bad time \"" + text + "\", expected yyyy/mm/dd [hh:mm[:ss]]";
+      return false;
+    }
+    stamp = pack(yr, mo, dy, hr, mn, sc);
+    return true;
+  }
+}
+//----< timestamp at start of line [beg, end) >----------------------
+
+bool LogSlicer::parseStamp(const char* beg, const char* end, Stamp& stamp)
+{
+  const char* p = beg;
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '['))
+    ++p;
+  if (p == end)
+    return false;
+  if (!isDigit(*p))
+    return ctimeStamp(p, end, stamp);
+
+  unsigned yr, mo, dy, hr, mn, sc;
+  if (!date(p, end, yr, mo, dy) || p == end || (*p != ' ' && *p != 'T'))
+    return false;
+  ++p;
+  if (!timeOfDay(p, end, hr, mn, sc))
+    return false;
+  stamp = pack(yr, mo, dy, hr, mn, sc);
+  return true;
+}
+//----< accept "from..to", either end may be empty >-----------------
+
+bool LogSlicer::range(const std::string& fromTo)
+{
+  error_.clear();
+  size_t dots = fromTo.find("..");
+  if (dots == std::string::npos)
+  {
+    error_ = "time range \"" + fromTo + "\" needs from..to";
+    return false;
+  }
+  if (!rangeEnd(fromTo.substr(0, dots), false, from_, error_))
+    return false;
+  if (!rangeEnd(fromTo.substr(dots + 2), true, to_, error_))
+    return false;
+  if (from_ > to_)
+  {
+    error_ = "time range \"" + fromTo + "\" ends before it starts";
+    return false;
+  }
+  return true;
+}
+//----< first entry starting at or after pos, end if none >----------
+/*
+ *  pos may be anywhere in a line.  A partial line is skipped, since
+ *  the entry it belongs to started before pos.
+ */
+const char* LogSlicer::nextEntry(const char* pos, const char* beg, const char* end, Stamp& stamp) const
+{
+  const char* line = pos;
+  if (line != beg && line[-1] != '\n')
+  {
+    line = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    line = (line == nullptr) ? end : line + 1;
+  }
+  while (line < end)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if (eol == nullptr)
+      eol = end;
+    if (parseStamp(line, eol, stamp))
+      return line;
+    line = eol + 1;
+  }
+  return end;
+}
+//----< first entry with stamp >= key, or > key if after >-----------
+/*
+ *  Invariant: every entry starting before lo is below the key, and
+ *  the first entry at or after hi is not, or there is none.  Each probe
+ *  reads forward from mid to the next entry, so continuation lines
+ *  and unstamped headers are never mistaken for entries.
+ */
+const char* LogSlicer::lowerBound(Stamp key, bool after, const char* beg, const char* end) const
+{
+  const char* lo = beg;
+  const char* hi = end;
+  Stamp stamp = 0;
+  while (lo < hi)
+  {
+    const char* mid = lo + (hi - lo) / 2;
+    const char* entry = nextEntry(mid, beg, end, stamp);
+    if (entry == end || (after ? stamp > key : stamp >= key))
+      hi = mid;
+    else
+      lo = entry + 1;
+  }
+  return nextEntry(lo, beg, end, stamp);
+}
+//----< entries of [beg, end) whose stamps lie in the range >--------
+
+LogSlicer::Slice LogSlicer::slice(const char* beg, const char* end) const
+{
+  Slice s;
+  s.beg = lowerBound(from_, false, beg, end);
+  s.end = (to_ == ~0ULL) ? end : lowerBound(to_, true, s.beg, end);
+  return s;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_LOGSLICE
+
+#include "FileSystem.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+
+int main()
+{
+  std::cout << "\n  Testing LogSlicer";
+  std::cout << "\n ===================";
+
+  std::string logFile = "LogSlice.test.log";
+  {
+    std::ofstream out(logFile, std::ios::binary);
+    out << "log header without a time\n";
+    for (int mn = 0; mn < 60; ++mn)
+      for (int sc = 0; sc < 60; sc += 15)
+      {
+        out << "2026-10-18 12:" << std::setfill('0') << std::setw(2) << mn << ":"
+            << std::setw(2) << sc << " entry " << mn << "." << sc << "\n";
+        if (sc == 30)
+          out << "    continuation of entry " << mn << "." << sc << "\n";
+      }
+  }
+
+  std::vector<std::string> ranges = {
+    "2026/10/18 12:10..2026/10/18 12:11", "2026-10-18 12:58:30..", "..2026-10-18 12:00:15",
+    "2026/10/19..", "2026/10/18 13:00..2026/10/18 12:00", "12:00..12:10"
+  };
+  {
+    FileSystem::MappedFile mf(logFile);
+    for (auto r : ranges)
+    {
+      LogSlicer ls;
+      std::cout << "\n\n  /T \"" << r << "\"";
+      if (!ls.range(r))
+      {
+        std::cout << "\n    error: " << ls.error();
+        continue;
+      }
+      LogSlicer::Slice s = ls.slice(mf.data(), mf.end());
+      std::istringstream lines(std::string(s.beg, s.end));
+      std::string line;
+      while (std::getline(lines, line))
+        std::cout << "\n    " << line;
+    }
+  }
+
+  LogSlicer::Stamp stamp = 0;
+  std::string ctime = "Sun Oct 18 12:12:50 2026 : SingletonLogger entry";
+  LogSlicer::parseStamp(ctime.data(), ctime.data() + ctime.size(), stamp);
+  std::cout << "\n\n  " << ctime << "\n    => " << stamp;
+  std::cout << "\n\n";
+  std::remove(logFile.c_str());
+  return 0;
+}
+#endif
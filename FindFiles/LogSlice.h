@@ -0,0 +1,89 @@
+#ifndef LOGSLICE_H
+#define LOGSLICE_H
+///////////////////////////////////////////////////////////////////////
+// LogSlice.h - find time range in a timestamped log by bisection   //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * LogSlicer supports FindFiles /T from..to.  Append-only logs are
+ * ordered by time, so the first entry at or after "from" and the first
+ * entry after "to" can be found by binary search over byte offsets of
+ * the memory-mapped file.  Only the lines near each probe are touched,
+ * so cost grows with log2 of the file size, not the file size.
+ *
+ * A line is an entry if it starts, after optional blanks or '[', with
+ * one of these timestamps:
+ *   Sun Oct 18 12:12:50 2026    DateTime::now(), used by SingletonLogger
+ *   2026-10-18 12:12:50         also with 'T' separator
+ *   2026/10/18 12:12:50         FindFiles /D format
+ * Lines without a timestamp belong to the entry above them.
+ *
+ * Range ends use the last two formats, and may omit the time, e.g.,
+ *   /T "2026/10/18 12:00..2026/10/18 12:10"   /T "2026-10-18.."
+ * An omitted "from" or "to" leaves that end of the range open.
+ *
+ * Public Interface:
+ * -----------------
+ * LogSlicer ls;
+ * if (ls.range("2026/10/18 12:00..2026/10/18 12:10"))
+ *   LogSlicer::Slice s = ls.slice(mf.data(), mf.end());
+ *
+ * Required Files:
+ * ---------------
+ * LogSlice.h, LogSlice.cpp
+ * FileSystem.h, FileSystem.cpp   // FileSystem::MappedFile, test stub only
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+
+class LogSlicer
+{
+public:
+  using Stamp = unsigned long long;   // yyyymmddhhmmss as a number
+
+  struct Slice
+  {
+    const char* beg;
+    const char* end;
+    size_t size() const { return static_cast<size_t>(end - beg); }
+  };
+
+  bool range(const std::string& fromTo);
+  Slice slice(const char* beg, const char* end) const;
+  Stamp from() const;
+  Stamp to() const;
+  std::string error() const;
+
+  static bool parseStamp(const char* beg, const char* end, Stamp& stamp);
+private:
+  const char* nextEntry(const char* pos, const char* beg, const char* end, Stamp& stamp) const;
+  const char* lowerBound(Stamp key, bool after, const char* beg, const char* end) const;
+  Stamp from_ = 0;
+  Stamp to_ = ~0ULL;
+  std::string error_;
+};
+
+inline LogSlicer::Stamp LogSlicer::from() const
+{
+  return from_;
+}
+
+inline LogSlicer::Stamp LogSlicer::to() const
+{
+  return to_;
+}
+
+inline std::string LogSlicer::error() const
+{
+  return error_;
+}
+
+#endif
@@ -0,0 +1,2311 @@
+///////////////////////////////////////////////////////////////////////
+// NameIndex.cpp - persistent, memory-mapped index of file names     //
+// Ver 1.9                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Pointer file layout, all integers little-endian:
+ *   magic "FFNS", version, u64 generation N of current segment, which
+ *   is the index file named by appending ".N"
+ *
+ * Index file layout, all integers little-endian:
+ *   header   : magic "FFNI", version, section count, reserved
+ *   sections : per section - tag, reserved, offset, size
+ *   then the sections, each starting on an 8 byte boundary:
+ *   META : root path, dir count, file count
+ *   DIRS : per dir, 24 bytes - parent, name offset in DNAM, first file,
+ *          file count, subtree end, reserved
+ *   DNAM : dir names, each varint length and bytes
+ *   NBLK : per block of 16 names - u64 offset of block in NAME
+ *   NAME : per name - varint shared prefix, varint suffix length, suffix
+ *   FATR : per file, 16 bytes - size, last write time
+ *   NTRG : trigrams of file names, DTRG : trigrams of dir names, each
+ *          trigram count, reserved, then per trigram, sorted, 16 bytes -
+ *          trigram, postings offset, count, then postings - varint
+ *          deltas of file or dir ids
+ *   BLOM : per dir, 8 bytes - offset of its filter in u64 words, filter
+ *          bits, 0 for none, then the filters, Bloom filters of keys of
+ *          the extensions and name trigrams of files in the dir's subtree
+ *   FACT : extension count, day count, per extension - varint length and
+ *          lower cased extension, u64 bitmap offset, per day since 1601,
+ *          UTC - u32 day, u64 bitmap offset, then Roaring bitmaps of the
+ *          file ids of each extension and day
+ *   HOST : only in global indexes - host count, reserved, then per host,
+ *          varint length and bytes of its name, its root, and the path
+ *          of its root in the global index
+ *   SUFX : optional - name count, reserved, text size, suffix count, then
+ *          text, file names lower cased, each ending with '\n', padded
+ *          to 8 bytes, u32 offset in text of each name, and u32 offset
+ *          of each suffix, sorted by suffix up to its name's end
+ * Dirs are in depth first preorder and files are ordered by dir, then
+ * by name, so file ids of a subtree are contiguous.
+ */
+
+#include "NameIndex.h"
+#include "BinaryIO.h"
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <queue>
+#include <unordered_map>
+#include <regex>
+#include <map>
+#include <fstream>
+#include <cstring>
+#include <cctype>
+
+namespace
+{
+  const uint32_t Magic = 0x494e4646;   // "FFNI"
+  const uint32_t Version = 1;
+  const uint32_t PointerMagic = 0x534e4646;   // "FFNS"
+  const size_t PointerSize = 16;
+  const size_t HeaderSize = 16;
+  const size_t SectionEntrySize = 24;
+  const size_t DirRecSize = 24;
+  const size_t AttribSize = 16;
+  const size_t TrigramEntrySize = 16;
+  const size_t BloomEntrySize = 8;
+  const size_t BloomBitsPerKey = 8;    // about 3% false positives with 3 hashes
+  const size_t BloomMaxKeys = 2048;    // more distinct keys than this, no filter
+  const uint32_t BloomHashes = 3;
+  const uint64_t TicksPerDay = 864000000000ULL;   // 100 ns ticks
+
+  //----< four character section tag >-------------------------------
+
+  uint32_t tag(const char* fourcc)
+  {
+    return static_cast<uint32_t>(static_cast<uint8_t>(fourcc[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(fourcc[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(fourcc[2])) << 16 |
+           static_cast<uint32_t>(static_cast<uint8_t>(fourcc[3])) << 24;
+  }
+  //----< fixed width little-endian fields of mapped sections >------
+
+  uint32_t le32(const char* p)
+  {
+    BinaryIO::Reader rd(p, p + 4);
+    return rd.u32();
+  }
+
+  uint64_t le64(const char* p)
+  {
+    BinaryIO::Reader rd(p, p + 8);
+    return rd.u64();
+  }
+
+  struct Section
+  {
+    uint32_t tag;
+    std::string bytes;
+  };
+  //----< header, section table, and 8 byte aligned sections >-------
+
+  std::string assemble(std::vector<Section>& sections)
+  {
+    std::string buffer;
+    BinaryIO::Writer wr(buffer);
+    wr.u32(Magic);
+    wr.u32(Version);
+    wr.u32(static_cast<uint32_t>(sections.size()));
+    wr.u32(0);
+    uint64_t offset = HeaderSize + SectionEntrySize * sections.size();
+    for (auto& sec : sections)
+    {
+      offset = (offset + 7) & ~7ULL;
+      wr.u32(sec.tag);
+      wr.u32(0);
+      wr.u64(offset);
+      wr.u64(sec.bytes.size());
+      offset += sec.bytes.size();
+    }
+    for (auto& sec : sections)
+    {
+      buffer.resize((buffer.size() + 7) & ~static_cast<size_t>(7), '\0');
+      buffer += sec.bytes;
+      std::string().swap(sec.bytes);
+    }
+    return buffer;
+  }
+
+  //----< trigram posting lists, ids added in increasing order >------
+
+  using Postings = std::unordered_map<TrigramQuery::Trigram, std::vector<uint32_t>>;
+
+  void addTrigrams(Postings& postings, const std::string& name, uint32_t id)
+  {
+    for (auto tg : TrigramQuery::trigramsOf(name.data(), name.data() + name.size()))
+      postings[tg].push_back(id);
+  }
+  //----< NTRG or DTRG section: sorted directory, then postings >----
+
+  std::string trigramSection(Postings& postings)
+  {
+    std::vector<TrigramQuery::Trigram> keys;
+    keys.reserve(postings.size());
+    for (auto& item : postings)
+      keys.push_back(item.first);
+    std::sort(keys.begin(), keys.end());
+
+    std::string dir, posts;
+    BinaryIO::Writer dw(dir), pw(posts);
+    dw.u32(static_cast<uint32_t>(keys.size()));
+    dw.u32(0);
+    for (auto tg : keys)
+    {
+      std::vector<uint32_t>& ids = postings[tg];
+      dw.u32(tg);
+      dw.u64(pw.size());
+      dw.u32(static_cast<uint32_t>(ids.size()));
+      uint32_t prev = 0;
+      for (auto id : ids)
+      {
+        pw.varint(id - prev);
+        prev = id;
+      }
+      std::vector<uint32_t>().swap(ids);
+    }
+    return dir + posts;
+  }
+
+  //----< Bloom filter key: FNV-1a of kind and text, then mixed >----
+
+  uint64_t bloomKey(char kind, const char* p, size_t n)
+  {
+    uint64_t h = BinaryIO::fnv1a(p, n, BinaryIO::fnv1a(&kind, 1));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+  }
+  //----< key of extension, lower case, "" for none >----------------
+
+  uint64_t extKey(const std::string& ext)
+  {
+    std::string lower(ext);
+    for (auto& c : lower)
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return bloomKey('e', lower.data(), lower.size());
+  }
+
+  uint64_t trigramKey(TrigramQuery::Trigram tg)
+  {
+    char text[3] = { static_cast<char>(tg >> 16), static_cast<char>(tg >> 8), static_cast<char>(tg) };
+    return bloomKey('t', text, 3);
+  }
+  //----< text after last dot, "" for none >-------------------------
+
+  std::string extOf(const std::string& name)
+  {
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? "" : name.substr(dot + 1);
+  }
+  //----< keys of a file name: its extension and its trigrams >------
+
+  void nameKeys(const std::string& name, std::vector<uint64_t>& keys)
+  {
+    keys.push_back(extKey(extOf(name)));
+    for (auto tg : TrigramQuery::trigramsOf(name.data(), name.data() + name.size()))
+      keys.push_back(trigramKey(tg));
+  }
+  //----< extension every name matching a /p pattern has, if fixed >-
+  /*
+   *  "*.cs" has "cs", "Makefile" has "", but "*.c*" and "File*" can
+   *  match any extension.
+   */
+  bool patternExt(const std::string& pattern, std::string& ext)
+  {
+    size_t dot = pattern.find_last_of('.');
+    ext = (dot == std::string::npos) ? pattern : pattern.substr(dot + 1);
+    if (ext.find_first_of("*?") != std::string::npos)
+      return false;
+    if (dot == std::string::npos)
+      ext.clear();
+    return true;
+  }
+  //----< Bloom filter bits of a key, by double hashing >------------
+
+  uint32_t bloomBit(uint64_t key, uint32_t i, uint32_t bits)
+  {
+    uint64_t step = (key >> 32) | 1;
+    return static_cast<uint32_t>((key + i * step) & (bits - 1));
+  }
+  //----< filter of sorted, unique keys, bits a power of 2 >---------
+
+  std::vector<uint64_t> bloomFilter(const std::vector<uint64_t>& keys)
+  {
+    uint32_t bits = 64;
+    while (bits < keys.size() * BloomBitsPerKey)
+      bits *= 2;
+    std::vector<uint64_t> words(bits / 64, 0);
+    for (auto key : keys)
+    {
+      for (uint32_t i = 0; i < BloomHashes; ++i)
+      {
+        uint32_t bit = bloomBit(key, i, bits);
+        words[bit / 64] |= 1ULL << (bit % 64);
+      }
+    }
+    return words;
+  }
+  //----< lower case copy, for suffix array text and fragments >-----
+
+  std::string lowerCase(std::string text)
+  {
+    for (auto& c : text)
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+  }
+  //----< longest run of a /p pattern without wildcards >------------
+
+  std::string patternFragment(const std::string& pattern)
+  {
+    std::string longest;
+    size_t pos = 0;
+    while (pos <= pattern.size())
+    {
+      size_t next = (std::min)(pattern.find_first_of("*?", pos), pattern.size());
+      if (next - pos > longest.size())
+        longest = pattern.substr(pos, next - pos);
+      pos = next + 1;
+    }
+    return longest;
+  }
+  //----< FACT section: facet dictionaries, then bitmaps >-----------
+
+  std::string facetSection(const std::map<std::string, Roaring>& exts, const std::map<uint32_t, Roaring>& days)
+  {
+    std::string dict, bitmaps;
+    BinaryIO::Writer dw(dict), bw(bitmaps);
+    dw.u32(static_cast<uint32_t>(exts.size()));
+    dw.u32(static_cast<uint32_t>(days.size()));
+    for (auto& item : exts)
+    {
+      dw.str(item.first);
+      dw.u64(bw.size());
+      item.second.write(bw);
+    }
+    for (auto& item : days)
+    {
+      dw.u32(item.first);
+      dw.u64(bw.size());
+      item.second.write(bw);
+    }
+    return dict + bitmaps;
+  }
+  //----< intersect sorted lists of disjoint [first, last) ranges >--
+
+  using Range = std::pair<uint32_t, uint32_t>;
+
+  std::vector<Range> intersectRanges(const std::vector<Range>& a, const std::vector<Range>& b)
+  {
+    std::vector<Range> result;
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size())
+    {
+      uint32_t lo = (std::max)(a[i].first, b[j].first);
+      uint32_t hi = (std::min)(a[i].second, b[j].second);
+      if (lo < hi)
+        result.push_back(Range(lo, hi));
+      if (a[i].second < b[j].second)
+        ++i;
+      else
+        ++j;
+    }
+    return result;
+  }
+  //----< sort ranges and merge those that overlap or touch >--------
+
+  void mergeRanges(std::vector<Range>& ranges)
+  {
+    std::sort(ranges.begin(), ranges.end());
+    size_t out = 0;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+      if (out > 0 && ranges[i].first <= ranges[out - 1].second)
+        ranges[out - 1].second = (std::max)(ranges[out - 1].second, ranges[i].second);
+      else
+        ranges[out++] = ranges[i];
+    }
+    ranges.resize(out);
+  }
+
+  bool lessName(const std::string& a, const std::string& b)
+  {
+    return a < b;
+  }
+
+  bool sameName(const std::string& a, const char* b, size_t len)
+  {
+    if (a.size() != len)
+      return false;
+    for (size_t i = 0; i < len; ++i)
+    {
+      if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+        return false;
+    }
+    return true;
+  }
+  //----< names of dirs from root down to spec, false if not below >
+
+  bool components(std::string root, std::string spec, std::vector<std::string>& names)
+  {
+    std::replace(root.begin(), root.end(), '/', '\\');
+    std::replace(spec.begin(), spec.end(), '/', '\\');
+    names.clear();
+    if (sameName(root, spec.data(), spec.size()))
+      return true;
+    if (spec.size() <= root.size() || spec[root.size()] != '\\' || !sameName(root, spec.data(), root.size()))
+      return false;
+    size_t pos = root.size() + 1;
+    while (pos <= spec.size())
+    {
+      size_t next = (std::min)(spec.find('\\', pos), spec.size());
+      if (next > pos)
+        names.push_back(spec.substr(pos, next - pos));
+      pos = next + 1;
+    }
+    return true;
+  }
+  //----< dir paths in preorder: a dir, then its subdirs by name >----
+  /*
+   *  Paths are relative to the root, with '\\' separators.  Ranking the
+   *  separator below every name character orders a dir before its
+   *  subtree, and sibling subtrees by name, as lessName does.
+   */
+  bool preorderLess(const std::string& a, const std::string& b)
+  {
+    size_t n = (std::min)(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+      unsigned char ca = (a[i] == '\\') ? 0 : static_cast<unsigned char>(a[i]);
+      unsigned char cb = (b[i] == '\\') ? 0 : static_cast<unsigned char>(b[i]);
+      if (ca != cb)
+        return ca < cb;
+    }
+    return a.size() < b.size();
+  }
+  //----< generation of current segment, false if not a pointer >---
+
+  bool readPointer(const std::string& indexFile, uint64_t& generation)
+  {
+    std::ifstream in(indexFile, std::ios::in | std::ios::binary);
+    char buffer[PointerSize];
+    if (!in.read(buffer, PointerSize))
+      return false;
+    BinaryIO::Reader rd(buffer, buffer + PointerSize);
+    if (rd.u32() != PointerMagic || rd.u32() != Version)
+      return false;
+    generation = rd.u64();
+    return true;
+  }
+
+  std::string pointer(uint64_t generation)
+  {
+    std::string buffer;
+    BinaryIO::Writer wr(buffer);
+    wr.u32(PointerMagic);
+    wr.u32(Version);
+    wr.u64(generation);
+    return buffer;
+  }
+  //----< sorted generations of files named indexFile + infix + N >--
+
+  std::vector<uint64_t> generations(const std::string& indexFile, const std::string& infix)
+  {
+    std::vector<uint64_t> gens;
+    std::string prefix = FileSystem::Path::getName(indexFile) + infix;
+    for (auto name : FileSystem::Directory::getFiles(FileSystem::Path::getPath(indexFile), prefix + "*"))
+    {
+      if (name.size() <= prefix.size() || !sameName(prefix, name.data(), prefix.size()) ||
+          name.find_first_not_of("0123456789", prefix.size()) != std::string::npos)
+        continue;
+      gens.push_back(std::stoull(name.substr(prefix.size())));
+    }
+    std::sort(gens.begin(), gens.end());
+    return gens;
+  }
+  //----< split spec at its last separator >-------------------------
+
+  bool splitPath(const std::string& spec, std::string& parent, std::string& name)
+  {
+    size_t pos = spec.find_last_of("\\/");
+    if (pos == std::string::npos || pos + 1 == spec.size())
+      return false;
+    std::string head = spec.substr(0, pos);
+    name = spec.substr(pos + 1);
+    parent = head;
+    return true;
+  }
+}
+const NameIndex::DirId NameIndex::NoDir;
+const size_t NameIndex::BlockSize;
+const unsigned NameIndex::ProgressMillis;
+const uint64_t NameIndexView::Always;
+
+//----< construct for named index file >-----------------------------
+
+NameIndex::NameIndex(const Path& indexFile) : indexFile_(indexFile) {}
+
+//----< index kept at root of indexed tree, by default >-------------
+
+NameIndex::Path NameIndex::defaultFile(const Path& root)
+{
+  return FileSystem::Path::fileSpec(root, "FindFiles.fidx");
+}
+//----< segment a pointer file names, or indexFile if not a pointer >
+
+NameIndex::Path NameIndex::segmentFile(const Path& indexFile)
+{
+  uint64_t generation = 0;
+  if (!readPointer(indexFile, generation))
+    return indexFile;
+  return indexFile + "." + std::to_string(generation);
+}
+//----< log of changes made on top of a generation's segment >-------
+
+NameIndex::Path NameIndex::logFile(const Path& indexFile, uint64_t generation)
+{
+  return indexFile + ".wal." + std::to_string(generation);
+}
+//----< network path of root on host, e.g., \\host\D$\scratch >------
+
+NameIndex::Path NameIndex::hostPath(const std::string& host, const Path& root)
+{
+  Path path = root;
+  std::replace(path.begin(), path.end(), '/', '\\');
+  while (path.size() > 1 && path.back() == '\\')
+    path.pop_back();
+  if (path.compare(0, 2, "\\\\") == 0)
+    return path;   // already a network path
+  if (path.size() >= 2 && path[1] == ':')
+    return "\\\\" + host + "\\" + path[0] + "$" + path.substr(2);
+  return "\\\\" + host + (path.size() > 0 && path[0] == '\\' ? "" : "\\") + path;
+}
+//----< walk tree rooted at root, recording every dir and file >-----
+
+/*
+ *  Worker threads take subtrees from a shared queue.  A worker walks
+ *  its subtree depth first, but hands subdirs back to the queue while
+ *  the queue is short, so idle workers find work.  Each worker keeps
+ *  the dirs it walked as its own segment, sorted into preorder when it
+ *  finishes, and a k-way merge of the segments gives the dir table in
+ *  the same preorder a one thread walk makes.  The calling thread
+ *  reports progress while it waits.
+ */
+void NameIndex::build(const Path& root)
+{
+  struct Walked
+  {
+    Path path;   // relative to root, "" for root
+    std::vector<FileRec> files;
+  };
+  using Segment = std::vector<Walked>;
+
+  root_ = root;
+  dirs_.clear();
+  hosts_.clear();
+  deadDirs_ = 0;
+  size_t threads = (threads_ > 0) ? threads_ : (std::max)(1u, std::thread::hardware_concurrency());
+  std::vector<Segment> segments(threads);
+  std::vector<Path> work(1, "");
+  std::mutex mtx;
+  std::condition_variable cv;     // work queued, or all of it done, for workers
+  std::condition_variable done;   // a worker finished, for the progress loop
+  size_t busy = 0, finished = 0;
+  std::atomic<size_t> queued(1), dirCount(0), fileCount(0);
+
+  auto worker = [&](Segment& segment) {
+    std::vector<Path> stack;
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() { return work.size() > 0 || busy == 0; });
+        if (work.size() == 0)
+          break;
+        stack.push_back(work.back());
+        work.pop_back();
+        --queued;
+        ++busy;
+      }
+      while (stack.size() > 0)
+      {
+        Walked dir;
+        dir.path = stack.back();
+        stack.pop_back();
+        std::vector<std::string> subdirs;
+        dir.files = readDir(dir.path.size() > 0 ? root_ + "\\" + dir.path : root_, subdirs);
+        fileCount += dir.files.size();
+        ++dirCount;
+        for (auto& name : subdirs)
+        {
+          Path sub = dir.path.size() > 0 ? dir.path + "\\" + name : name;
+          if (queued < threads)
+          {
+            std::lock_guard<std::mutex> lock(mtx);
+            work.push_back(sub);
+            ++queued;
+            cv.notify_one();
+          }
+          else
+            stack.push_back(sub);
+        }
+        segment.push_back(std::move(dir));
+      }
+      std::lock_guard<std::mutex> lock(mtx);
+      if (--busy == 0 && work.size() == 0)
+        cv.notify_all();
+    }
+    std::sort(segment.begin(), segment.end(),
+      [](const Walked& a, const Walked& b) { return preorderLess(a.path, b.path); });
+    std::lock_guard<std::mutex> lock(mtx);
+    ++finished;
+    done.notify_one();
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; ++i)
+    workers.push_back(std::thread(worker, std::ref(segments[i])));
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!done.wait_for(lock, std::chrono::milliseconds(ProgressMillis), [&]() { return finished == threads; }))
+    {
+      if (progress_)
+        progress_(dirCount, fileCount);
+    }
+  }
+  for (auto& w : workers)
+    w.join();
+  if (progress_)
+    progress_(dirCount, fileCount);
+
+  // k-way merge; ancestors[k] is the last dir seen with k separators
+  using Head = std::pair<size_t, size_t>;   // segment, position
+  auto later = [&](const Head& a, const Head& b) {
+    return preorderLess(segments[b.first][b.second].path, segments[a.first][a.second].path);
+  };
+  std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+  for (size_t i = 0; i < threads; ++i)
+  {
+    if (segments[i].size() > 0)
+      heads.push(Head(i, 0));
+  }
+  dirs_.reserve(dirCount);
+  std::vector<DirId> ancestors;
+  while (heads.size() > 0)
+  {
+    Head head = heads.top();
+    heads.pop();
+    Walked& dir = segments[head.first][head.second];
+    if (head.second + 1 < segments[head.first].size())
+      heads.push(Head(head.first, head.second + 1));
+    DirId id = static_cast<DirId>(dirs_.size());
+    dirs_.push_back(DirRec());
+    dirs_[id].files.swap(dir.files);
+    if (dir.path.size() > 0)
+    {
+      size_t depth = std::count(dir.path.begin(), dir.path.end(), '\\');
+      size_t pos = dir.path.find_last_of('\\');
+      dirs_[id].name = (pos == std::string::npos) ? dir.path : dir.path.substr(pos + 1);
+      dirs_[id].parent = ancestors[depth];
+      dirs_[ancestors[depth]].dirs.push_back(id);
+      ancestors.resize(depth + 1);
+    }
+    ancestors.push_back(id);
+    Path().swap(dir.path);
+  }
+}
+//----< files of one dir sorted by name, and names of its subdirs >--
+
+std::vector<NameIndex::FileRec> NameIndex::readDir(const Path& path, std::vector<std::string>& subdirs) const
+{
+  std::vector<FileRec> files;
+  for (auto entry : FileSystem::Directory::getEntries(path))
+  {
+    if (entry.isDir)
+    {
+      subdirs.push_back(entry.name);
+      continue;
+    }
+    if (isIndexFile(path + "\\" + entry.name))
+      continue;
+    FileRec rec;
+    rec.name = entry.name;
+    rec.size = entry.size;
+    rec.time = entry.time;
+    files.push_back(rec);
+  }
+  std::sort(files.begin(), files.end(),
+    [](const FileRec& a, const FileRec& b) { return lessName(a.name, b.name); });
+  std::sort(subdirs.begin(), subdirs.end(), lessName);
+  return files;
+}
+//----< record contents of one dir, then its subdirs >---------------
+
+void NameIndex::scan(DirId dir, const Path& path)
+{
+  std::vector<std::string> subdirs;
+  dirs_[dir].files = readDir(path, subdirs);
+
+  for (auto name : subdirs)
+  {
+    DirId id = static_cast<DirId>(dirs_.size());
+    dirs_.push_back(DirRec());
+    dirs_[id].name = name;
+    dirs_[id].parent = dir;
+    dirs_[dir].dirs.push_back(id);
+    scan(id, path + "\\" + name);
+  }
+}
+//----< index's own files, e.g., segments and logs, aren't indexed >
+
+bool NameIndex::isIndexFile(const Path& path) const
+{
+  return sameName(indexFile_, path.data(), path.size()) ||
+    (path.size() > indexFile_.size() && path[indexFile_.size()] == '.' &&
+     sameName(indexFile_, path.data(), indexFile_.size()));
+}
+//----< rebuild in-memory index from saved index file >--------------
+
+bool NameIndex::load()
+{
+  dirs_.clear();
+  deadDirs_ = 0;
+  dirty_ = false;
+  log_.reset();
+  uint64_t segment = 0;
+  readPointer(indexFile_, segment);
+  NameIndexView view(indexFile_);
+  if (!view.good())
+  {
+    error_ = view.error();
+    return false;
+  }
+  root_ = view.root();
+  hosts_ = view.hosts();
+  suffixArray_ = view.hasSuffixArray();
+  dirs_.resize(view.dirCount());
+  for (DirId d = 0; d < view.dirCount(); ++d)
+  {
+    NameIndexView::Dir rec = view.dir(d);
+    dirs_[d].files.reserve(rec.fileCount);
+    if (d == 0 || rec.parent >= d)
+      continue;
+    dirs_[d].name = view.dirName(d);
+    dirs_[d].parent = rec.parent;
+    dirs_[rec.parent].dirs.push_back(d);
+  }
+  view.scan(0, true, NameMatcher(), [&](DirId d, FileId f, const std::string& name) {
+    FileRec rec;
+    rec.name = name;
+    rec.size = view.fileSize(f);
+    rec.time = view.fileTime(f);
+    dirs_[d].files.push_back(rec);
+  });
+  replay(segment);
+  return true;
+}
+//----< apply logged changes made since segment was saved >----------
+/*
+ *  Logs of later generations exist if the process died while saving
+ *  a snapshot.  Appending continues in the last log replayed.
+ */
+void NameIndex::replay(uint64_t segment)
+{
+  generation_ = segment;
+  stats_.replayed = 0;
+  IndexLog::Records records;
+  for (auto gen : generations(indexFile_, ".wal."))
+  {
+    if (gen < segment || !IndexLog::read(logFile(indexFile_, gen), records))
+      continue;
+    for (auto& rec : records)
+      apply(rec.op, rec.path);
+    stats_.replayed += records.size();
+    generation_ = gen;
+  }
+  if (stats_.replayed > 0)
+    dirty_ = true;   // fold logs into next save
+}
+//----< mount copy of host's index, replacing any earlier copy >-----
+/*
+ *  The first merge into an empty index makes it a global index.  An
+ *  input that is itself global brings all of its hosts.
+ */
+bool NameIndex::merge(const std::string& host, const Path& inputFile)
+{
+  if (dirs_.size() == 0)
+  {
+    root_ = "\\";
+    dirs_.resize(1);
+    hosts_.clear();
+  }
+  else if (hosts_.size() == 0)
+  {
+    error_ = indexFile_ + " is an index of " + root_ + ", not a global index";
+    return false;
+  }
+  NameIndexView view(inputFile);
+  if (!view.good())
+  {
+    error_ = view.error();
+    return false;
+  }
+  if (view.hosts().size() == 0)
+    return mount(view, 0, Host{ host, view.root(), hostPath(host, view.root()) });
+  for (auto& mounted : view.hosts())
+  {
+    if (!mount(view, view.findDir(mounted.path), mounted))
+      return false;
+  }
+  return true;
+}
+//----< copy view's subtree at from to host's path >-----------------
+
+bool NameIndex::mount(const NameIndexView& view, DirId from, const Host& host)
+{
+  std::vector<std::string> names;
+  if (from == NoDir || !components(root_, host.path, names) || names.size() == 0)
+  {
+    error_ = "can't mount " + host.root + " of " + host.name + " at " + host.path;
+    return false;
+  }
+  DirId d = 0;
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    DirId child = findChild(d, names[i]);
+    if (child != NoDir && i + 1 == names.size())
+    {
+      detach(child);   // older copy
+      child = NoDir;
+    }
+    d = (child != NoDir) ? child : addDir(d, names[i]);
+  }
+  hosts_.erase(std::remove_if(hosts_.begin(), hosts_.end(),
+    [&](const Host& h) { return sameName(h.path, host.path.data(), host.path.size()); }), hosts_.end());
+  hosts_.push_back(host);
+
+  DirId end = view.dir(from).subtreeEnd;
+  std::vector<DirId> ids(end - from);
+  ids[0] = d;
+  for (DirId v = from + 1; v < end; ++v)
+    ids[v - from] = addDir(ids[view.dir(v).parent - from], view.dirName(v));
+  view.scan(from, true, NameMatcher(), [&](DirId v, FileId f, const std::string& name) {
+    FileRec rec;
+    rec.name = name;
+    rec.size = view.fileSize(f);
+    rec.time = view.fileTime(f);
+    dirs_[ids[v - from]].files.push_back(rec);
+  });
+  dirty_ = true;
+  return true;
+}
+//----< dir with full path, or NoDir >-------------------------------
+
+NameIndex::DirId NameIndex::findDir(const Path& path) const
+{
+  std::vector<std::string> names;
+  if (dirs_.size() == 0 || !components(root_, path, names))
+    return NoDir;
+  DirId d = 0;
+  for (size_t i = 0; i < names.size() && d != NoDir; ++i)
+    d = findChild(d, names[i]);
+  return d;
+}
+//----< subdir of dir with name, or NoDir >--------------------------
+
+NameIndex::DirId NameIndex::findChild(DirId dir, const std::string& name) const
+{
+  for (auto child : dirs_[dir].dirs)
+  {
+    if (sameName(dirs_[child].name, name.data(), name.size()))
+      return child;
+  }
+  return NoDir;
+}
+//----< add empty subdir, keeping parent's subdirs sorted >----------
+
+NameIndex::DirId NameIndex::addDir(DirId parent, const std::string& name)
+{
+  DirId id = static_cast<DirId>(dirs_.size());
+  dirs_.push_back(DirRec());
+  dirs_[id].name = name;
+  dirs_[id].parent = parent;
+  std::vector<DirId>& siblings = dirs_[parent].dirs;
+  auto iter = std::lower_bound(siblings.begin(), siblings.end(), name,
+    [&](DirId d, const std::string& n) { return lessName(dirs_[d].name, n); });
+  siblings.insert(iter, id);
+  return id;
+}
+//----< drop dir and its subtree; records are reclaimed by save >----
+
+void NameIndex::detach(DirId dir)
+{
+  std::vector<DirId>& siblings = dirs_[dirs_[dir].parent].dirs;
+  siblings.erase(std::remove(siblings.begin(), siblings.end(), dir), siblings.end());
+  std::vector<DirId> stack(1, dir);
+  while (stack.size() > 0)
+  {
+    DirRec& rec = dirs_[stack.back()];
+    stack.pop_back();
+    stack.insert(stack.end(), rec.dirs.begin(), rec.dirs.end());
+    rec = DirRec();
+    ++deadDirs_;
+  }
+  dirty_ = true;
+}
+//----< log change, if logging, then apply it >----------------------
+
+void NameIndex::change(IndexLog::Op op, const Path& path)
+{
+  if (isIndexFile(path))
+    return;
+  if (logging_)
+  {
+    if (!log_)
+      log_.reset(new IndexLog(logFile(indexFile_, generation_)));
+    if (!log_->append(op, path))
+      error_ = log_->error();
+  }
+  apply(op, path);
+}
+
+void NameIndex::apply(IndexLog::Op op, const Path& path)
+{
+  switch (op)
+  {
+  case IndexLog::Update:
+    update(path);
+    break;
+  case IndexLog::Remove:
+    remove(path);
+    break;
+  case IndexLog::Rescan:
+    rescan(path);
+    break;
+  case IndexLog::Refresh:
+    refreshDir(path);
+    break;
+  }
+}
+//----< flush logged changes to disk >-------------------------------
+
+bool NameIndex::syncLog()
+{
+  if (!log_ || log_->sync())
+    return true;
+  error_ = log_->error();
+  return false;
+}
+//----< copy to save on another thread; log next generation >--------
+/*
+ *  Changes made after the copy go to the next generation's log, which
+ *  the copy's save keeps, so none are lost if that save fails.
+ */
+NameIndex NameIndex::snapshot()
+{
+  NameIndex copy(indexFile_);   // all that save() writes
+  copy.root_ = root_;
+  copy.dirs_ = dirs_;
+  copy.hosts_ = hosts_;
+  copy.deadDirs_ = deadDirs_;
+  copy.dirty_ = dirty_;
+  copy.suffixArray_ = suffixArray_;
+  copy.generation_ = generation_;
+  log_.reset();
+  ++generation_;
+  dirty_ = false;
+  return copy;
+}
+//----< re-read one file or dir after it was added or changed >------
+/*
+ *  A dir that is new to the index is walked, since it may have been
+ *  moved in with its contents.  If the parent isn't indexed yet, the
+ *  nearest indexed ancestor is rescanned instead.
+ */
+void NameIndex::update(const Path& path)
+{
+  Path parentPath, name;
+  if (!splitPath(path, parentPath, name) || isIndexFile(path))
+    return;
+  DirId parent = findDir(parentPath);
+  if (parent == NoDir)
+  {
+    Path up = parentPath;
+    while (parent == NoDir && splitPath(up, up, name))
+      parent = findDir(up);
+    if (parent != NoDir)
+      rescan(up);
+    return;
+  }
+  std::vector<FileSystem::Directory::Entry> found = FileSystem::Directory::getEntries(parentPath, name);
+  if (found.size() == 0)
+  {
+    remove(path);
+    return;
+  }
+  const FileSystem::Directory::Entry& entry = found[0];
+  std::vector<FileRec>& files = dirs_[parent].files;
+  auto iter = std::find_if(files.begin(), files.end(),
+    [&](const FileRec& f) { return sameName(f.name, entry.name.data(), entry.name.size()); });
+  DirId child = findChild(parent, entry.name);
+  if (entry.isDir)
+  {
+    if (iter != files.end())
+    {
+      files.erase(iter);
+      dirty_ = true;
+    }
+    if (child == NoDir)
+    {
+      scan(addDir(parent, entry.name), parentPath + "\\" + entry.name);
+      dirty_ = true;
+    }
+    return;
+  }
+  if (child != NoDir)
+    detach(child);
+  if (iter == files.end())
+  {
+    FileRec rec;
+    rec.name = entry.name;
+    iter = files.insert(std::lower_bound(files.begin(), files.end(), rec,
+      [](const FileRec& a, const FileRec& b) { return lessName(a.name, b.name); }), rec);
+  }
+  else if (iter->size == entry.size && iter->time == entry.time)
+    return;
+  iter->size = entry.size;
+  iter->time = entry.time;
+  dirty_ = true;
+}
+//----< drop file or dir, after it was deleted or renamed away >-----
+
+void NameIndex::remove(const Path& path)
+{
+  Path parentPath, name;
+  if (!splitPath(path, parentPath, name))
+    return;
+  DirId parent = findDir(parentPath);
+  if (parent == NoDir)
+    return;
+  DirId child = findChild(parent, name);
+  if (child != NoDir)
+  {
+    detach(child);
+    return;
+  }
+  std::vector<FileRec>& files = dirs_[parent].files;
+  auto iter = std::find_if(files.begin(), files.end(),
+    [&](const FileRec& f) { return sameName(f.name, name.data(), name.size()); });
+  if (iter != files.end())
+  {
+    files.erase(iter);
+    dirty_ = true;
+  }
+}
+//----< replace dir's subtree with a fresh walk >--------------------
+
+void NameIndex::rescan(const Path& dir)
+{
+  DirId d = findDir(dir);
+  if (d == NoDir)
+  {
+    update(dir);
+    return;
+  }
+  std::vector<DirId> children = dirs_[d].dirs;
+  for (auto child : children)
+    detach(child);
+  dirs_[d].files.clear();
+  scan(d, dir);
+  dirty_ = true;
+}
+//----< re-read one dir, walking only subdirs that are new >---------
+
+void NameIndex::refreshDir(const Path& dir)
+{
+  DirId d = findDir(dir);
+  if (d == NoDir)
+  {
+    update(dir);
+    return;
+  }
+  std::vector<FileSystem::Directory::Entry> entries = FileSystem::Directory::getEntries(dir);
+  std::vector<FileRec> files;
+  std::vector<std::string> subdirs;
+  for (auto entry : entries)
+  {
+    if (entry.isDir)
+      subdirs.push_back(entry.name);
+    else if (!isIndexFile(dir + "\\" + entry.name))
+    {
+      FileRec rec;
+      rec.name = entry.name;
+      rec.size = entry.size;
+      rec.time = entry.time;
+      files.push_back(rec);
+    }
+  }
+  std::sort(files.begin(), files.end(),
+    [](const FileRec& a, const FileRec& b) { return lessName(a.name, b.name); });
+  dirs_[d].files.swap(files);
+
+  std::vector<DirId> children = dirs_[d].dirs;
+  for (auto child : children)
+  {
+    const std::string& name = dirs_[child].name;
+    if (std::find_if(subdirs.begin(), subdirs.end(),
+        [&](const std::string& s) { return sameName(s, name.data(), name.size()); }) == subdirs.end())
+      detach(child);
+  }
+  for (auto name : subdirs)
+  {
+    if (findChild(d, name) == NoDir)
+      scan(addDir(d, name), dir + "\\" + name);
+  }
+  dirty_ = true;
+}
+//----< live dirs in depth first preorder >--------------------------
+/*
+ *  order maps preorder position to dirs_ index, position is its
+ *  inverse, NoDir for detached dirs.
+ */
+void NameIndex::preorder(std::vector<DirId>& order, std::vector<DirId>& position) const
+{
+  order.clear();
+  position.assign(dirs_.size(), NoDir);
+  std::vector<DirId> stack(1, 0);
+  while (stack.size() > 0)
+  {
+    DirId d = stack.back();
+    stack.pop_back();
+    position[d] = static_cast<DirId>(order.size());
+    order.push_back(d);
+    for (auto iter = dirs_[d].dirs.rbegin(); iter != dirs_[d].dirs.rend(); ++iter)
+      stack.push_back(*iter);
+  }
+}
+//----< renumber live dirs in preorder, dropping detached ones >-----
+
+void NameIndex::compact(const std::vector<DirId>& order, const std::vector<DirId>& position)
+{
+  std::vector<DirRec> dirs(order.size());
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    dirs[i] = std::move(dirs_[order[i]]);
+    if (dirs[i].parent != NoDir)
+      dirs[i].parent = position[dirs[i].parent];
+    for (auto& child : dirs[i].dirs)
+      child = position[child];
+  }
+  dirs_.swap(dirs);
+  deadDirs_ = 0;
+}
+//----< BLOM section: subtree filters, children before parents >----
+/*
+ *  Children come after their parent in preorder, so walking backwards
+ *  finishes every child's keys before its parent takes them over.
+ */
+std::string NameIndex::bloomSection(const std::vector<DirId>& order, const std::vector<DirId>& position) const
+{
+  std::vector<std::vector<uint64_t>> keys(order.size()), filters(order.size());
+  std::vector<bool> full(order.size(), false);
+  for (size_t i = order.size(); i-- > 0; )
+  {
+    const DirRec& rec = dirs_[order[i]];
+    for (auto child : rec.dirs)
+    {
+      DirId c = position[child];
+      if (full[c])
+        full[i] = true;
+      else if (!full[i])
+        keys[i].insert(keys[i].end(), keys[c].begin(), keys[c].end());
+      std::vector<uint64_t>().swap(keys[c]);
+    }
+    if (full[i])
+      continue;
+    for (auto& file : rec.files)
+      nameKeys(file.name, keys[i]);
+    std::sort(keys[i].begin(), keys[i].end());
+    keys[i].erase(std::unique(keys[i].begin(), keys[i].end()), keys[i].end());
+    if (keys[i].size() > BloomMaxKeys)
+    {
+      full[i] = true;
+      std::vector<uint64_t>().swap(keys[i]);
+      continue;
+    }
+    filters[i] = bloomFilter(keys[i]);
+  }
+
+  std::string bytes;
+  BinaryIO::Writer wr(bytes);
+  uint32_t offset = 0;
+  for (auto& filter : filters)
+  {
+    wr.u32(offset);
+    wr.u32(static_cast<uint32_t>(filter.size() * 64));
+    offset += static_cast<uint32_t>(filter.size());
+  }
+  for (auto& filter : filters)
+  {
+    for (auto word : filter)
+      wr.u64(word);
+  }
+  return bytes;
+}
+//----< SUFX section: suffix array of lower cased names >------------
+/*
+ *  Suffixes compare only up to the end of their name, '\n', which is
+ *  below every character that can be in a name.  Equal suffixes stay
+ *  in text order, so the array doesn't depend on the sort.
+ */
+std::string NameIndex::suffixSection(const std::vector<const std::string*>& names) const
+{
+  std::string text;
+  std::vector<uint32_t> starts;
+  starts.reserve(names.size());
+  for (auto pName : names)
+  {
+    starts.push_back(static_cast<uint32_t>(text.size()));
+    text += lowerCase(*pName);
+    text += '\n';
+    if (text.size() >= 0xffffffffULL)
+      return std::string();   // too large for u32 offsets
+  }
+  std::vector<uint32_t> suffixes;
+  suffixes.reserve(text.size() - names.size());
+  for (uint32_t pos = 0; pos < text.size(); ++pos)
+  {
+    if (text[pos] != '\n')
+      suffixes.push_back(pos);
+  }
+  const unsigned char* t = reinterpret_cast<const unsigned char*>(text.data());
+  std::sort(suffixes.begin(), suffixes.end(), [t](uint32_t a, uint32_t b) {
+    uint32_t i = a, j = b;
+    while (t[i] == t[j] && t[i] != '\n')
+    {
+      ++i;
+      ++j;
+    }
+    return t[i] != t[j] ? t[i] < t[j] : a < b;
+  });
+
+  std::string bytes;
+  BinaryIO::Writer wr(bytes);
+  wr.u32(static_cast<uint32_t>(names.size()));
+  wr.u32(0);
+  wr.u64(text.size());
+  wr.u64(suffixes.size());
+  wr.bytes(text.data(), text.size());
+  bytes.resize((bytes.size() + 7) & ~static_cast<size_t>(7), '\0');
+  for (auto start : starts)
+    wr.u32(start);
+  for (auto pos : suffixes)
+    wr.u32(pos);
+  return bytes;
+}
+//----< write index, numbering dirs in preorder >--------------------
+
+bool NameIndex::save()
+{
+  std::vector<DirId> order, position;
+  preorder(order, position);
+  if (deadDirs_ > 0)
+  {
+    compact(order, position);
+    preorder(order, position);
+  }
+  std::vector<DirId> subtreeEnd(order.size());
+  for (size_t i = order.size(); i-- > 0; )
+  {
+    const DirRec& rec = dirs_[order[i]];
+    subtreeEnd[i] = rec.dirs.size() > 0 ? subtreeEnd[position[rec.dirs.back()]] : static_cast<DirId>(i + 1);
+  }
+
+  std::vector<Section> sections = {
+    { tag("META") }, { tag("DIRS") }, { tag("DNAM") }, { tag("NBLK") }, { tag("NAME") }, { tag("FATR") },
+    { tag("NTRG") }, { tag("DTRG") }, { tag("BLOM") }, { tag("FACT") }
+  };
+  BinaryIO::Writer meta(sections[0].bytes), dirs(sections[1].bytes), dnam(sections[2].bytes);
+  BinaryIO::Writer nblk(sections[3].bytes), name(sections[4].bytes), fatr(sections[5].bytes);
+
+  uint32_t fileId = 0;
+  std::string prev;
+  Postings fileTrigrams, dirTrigrams;
+  std::vector<const std::string*> fileNames;
+  std::map<std::string, Roaring> extFacets;
+  std::map<uint32_t, Roaring> dayFacets;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    const DirRec& rec = dirs_[order[i]];
+    dirs.u32(rec.parent == NoDir ? NoDir : position[rec.parent]);
+    dirs.u32(static_cast<uint32_t>(dnam.size()));
+    dirs.u32(fileId);
+    dirs.u32(static_cast<uint32_t>(rec.files.size()));
+    dirs.u32(subtreeEnd[i]);
+    dirs.u32(0);
+    dnam.str(rec.name);
+    addTrigrams(dirTrigrams, rec.name, static_cast<uint32_t>(i));
+    for (auto& file : rec.files)
+    {
+      addTrigrams(fileTrigrams, file.name, fileId);
+      if (suffixArray_)
+        fileNames.push_back(&file.name);
+      extFacets[lowerCase(extOf(file.name))].add(fileId);
+      dayFacets[static_cast<uint32_t>(file.time / TicksPerDay)].add(fileId);
+      size_t shared = 0;
+      if (fileId % BlockSize == 0)
+        nblk.u64(name.size());
+      else
+      {
+        size_t limit = (std::min)(prev.size(), file.name.size());
+        while (shared < limit && prev[shared] == file.name[shared])
+          ++shared;
+      }
+      name.varint(shared);
+      name.varint(file.name.size() - shared);
+      name.bytes(file.name.data() + shared, file.name.size() - shared);
+      fatr.u64(file.size);
+      fatr.u64(file.time);
+      prev = file.name;
+      ++fileId;
+    }
+  }
+  meta.str(root_);
+  meta.u32(static_cast<uint32_t>(order.size()));
+  meta.u32(fileId);
+  sections[6].bytes = trigramSection(fileTrigrams);
+  sections[7].bytes = trigramSection(dirTrigrams);
+  sections[8].bytes = bloomSection(order, position);
+  sections[9].bytes = facetSection(extFacets, dayFacets);
+  extFacets.clear();
+  dayFacets.clear();
+  if (suffixArray_)
+  {
+    sections.push_back(Section{ tag("SUFX") });
+    sections.back().bytes = suffixSection(fileNames);
+  }
+  if (hosts_.size() > 0)
+  {
+    sections.push_back(Section{ tag("HOST") });
+    BinaryIO::Writer host(sections.back().bytes);
+    host.u32(static_cast<uint32_t>(hosts_.size()));
+    host.u32(0);
+    for (auto& h : hosts_)
+    {
+      host.str(h.name);
+      host.str(h.root);
+      host.str(h.path);
+    }
+  }
+
+  std::string buffer = assemble(sections);
+  stats_.dirs = order.size();
+  stats_.files = fileId;
+  stats_.bytes = buffer.size();
+  uint64_t current = 0;
+  readPointer(indexFile_, current);
+  uint64_t next = (std::max)(generation_, current) + 1;
+  Path segment = indexFile_ + "." + std::to_string(next);
+  if (!BinaryIO::writeFile(segment, buffer) || !BinaryIO::writeFile(indexFile_, pointer(next)))
+  {
+    error_ = "can't write " + segment;
+    return false;
+  }
+  log_.reset();
+  generation_ = next;
+  dirty_ = false;
+  removeStale();
+  return true;
+}
+//----< delete logs now in a segment, and segments before previous >--
+/*
+ *  The previous segment is kept for readers that read the old pointer
+ *  just before the switch.  Files still mapped can't be deleted, so
+ *  are tried again by later saves.
+ */
+void NameIndex::removeStale() const
+{
+  for (auto gen : generations(indexFile_, ".wal."))
+  {
+    if (gen < generation_)
+      FileSystem::File::remove(logFile(indexFile_, gen));
+  }
+  for (auto gen : generations(indexFile_, "."))
+  {
+    if (gen + 1 < generation_)
+      FileSystem::File::remove(indexFile_ + "." + std::to_string(gen));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////
+// NameIndexView
+
+//----< map index file and locate its sections >---------------------
+
+NameIndexView::NameIndexView(const Path& indexFile) : map_(NameIndex::segmentFile(indexFile))
+{
+  if (!map_.good())
+  {
+    error_ = "can't open name index " + indexFile;
+    return;
+  }
+  BinaryIO::Reader rd(map_.data(), map_.end());
+  if (rd.u32() != Magic || rd.u32() != Version)
+  {
+    error_ = indexFile + " is not a name index";
+    return;
+  }
+  Section meta, hosts;
+  if (!section(tag("META"), meta, true) || !section(tag("DIRS"), dirs_, true) ||
+      !section(tag("DNAM"), dirNames_, true) || !section(tag("NBLK"), blocks_, true) ||
+      !section(tag("NAME"), names_, true) || !section(tag("FATR"), attribs_, true) ||
+      !section(tag("NTRG"), fileTrigrams_, false) || !section(tag("DTRG"), dirTrigrams_, false) ||
+      !section(tag("BLOM"), blooms_, false) || !section(tag("SUFX"), suffixes_, false) ||
+      !section(tag("FACT"), facets_, false) || !section(tag("HOST"), hosts, false) ||
+      !trigramSection(fileTrigrams_) || !trigramSection(dirTrigrams_))
+  {
+    error_ = indexFile + " is damaged: " + error_;
+    return;
+  }
+  BinaryIO::Reader mrd(meta.data, meta.data + meta.size);
+  root_ = mrd.str();
+  dirCount_ = mrd.u32();
+  fileCount_ = mrd.u32();
+  size_t blockCount = (fileCount_ + NameIndex::BlockSize - 1) / NameIndex::BlockSize;
+  if (!mrd.good() || dirCount_ == 0 || dirs_.size != dirCount_ * DirRecSize ||
+      attribs_.size != fileCount_ * AttribSize || blocks_.size != blockCount * 8 ||
+      (blooms_.data != nullptr && blooms_.size < dirCount_ * BloomEntrySize) || !suffixSection() ||
+      !facetSection() || !hostSection(hosts))
+    error_ = indexFile + " is damaged: section sizes don't agree";
+}
+//----< find section by tag in the section table >-------------------
+
+bool NameIndexView::section(uint32_t sectionTag, Section& sec, bool required)
+{
+  BinaryIO::Reader rd(map_.data() + 8, map_.end());
+  uint32_t count = rd.u32();
+  rd.skip(4);
+  for (uint32_t i = 0; i < count && rd.good(); ++i)
+  {
+    uint32_t t = rd.u32();
+    rd.skip(4);
+    uint64_t offset = rd.u64();
+    uint64_t size = rd.u64();
+    if (t != sectionTag)
+      continue;
+    if (offset > map_.size() || size > map_.size() - offset)
+    {
+      error_ = "section out of bounds";
+      return false;
+    }
+    sec.data = map_.data() + offset;
+    sec.size = size;
+    return true;
+  }
+  if (required)
+    error_ = "missing section";
+  return !required;
+}
+//----< check that a present trigram section's directory fits >-----
+
+bool NameIndexView::trigramSection(Section& sec)
+{
+  if (sec.data == nullptr)
+    return true;
+  if (sec.size < 8 || (sec.size - 8) / TrigramEntrySize < le32(sec.data))
+  {
+    error_ = "trigram directory out of bounds";
+    return false;
+  }
+  return true;
+}
+//----< locate text, name starts, and suffixes of a SUFX section >--
+
+bool NameIndexView::suffixSection()
+{
+  if (suffixes_.data == nullptr || suffixes_.size == 0)
+    return true;   // not built, or names too large for it
+  BinaryIO::Reader rd(suffixes_.data, suffixes_.data + suffixes_.size);
+  uint32_t names = rd.u32();
+  rd.skip(4);
+  uint64_t textSize = rd.u64();
+  uint64_t count = rd.u64();
+  uint64_t textEnd = (24 + textSize + 7) & ~7ULL;
+  if (!rd.good() || names != fileCount_ || textSize >= suffixes_.size ||
+      suffixes_.size != textEnd + 4 * (names + count))
+    return false;
+  text_ = suffixes_.data + 24;
+  textSize_ = textSize;
+  textStarts_ = suffixes_.data + textEnd;
+  suffixArray_ = textStarts_ + 4ULL * names;
+  suffixCount_ = count;
+  return true;
+}
+//----< read facet dictionaries; bitmaps are read when used >--------
+
+bool NameIndexView::facetSection()
+{
+  if (facets_.data == nullptr)
+    return true;
+  BinaryIO::Reader rd(facets_.data, facets_.data + facets_.size);
+  uint32_t exts = rd.u32();
+  uint32_t days = rd.u32();
+  for (uint32_t i = 0; i < exts && rd.good(); ++i)
+  {
+    std::string ext = rd.str();
+    extFacets_.push_back(std::make_pair(ext, rd.u64()));
+  }
+  for (uint32_t i = 0; i < days && rd.good(); ++i)
+  {
+    uint32_t day = rd.u32();
+    dayFacets_.push_back(std::make_pair(day, rd.u64()));
+  }
+  if (!rd.good())
+    return false;
+  facetBitmaps_ = rd.pos();
+  return true;
+}
+//----< read host table of a global index >--------------------------
+
+bool NameIndexView::hostSection(const Section& sec)
+{
+  if (sec.data == nullptr)
+    return true;
+  BinaryIO::Reader rd(sec.data, sec.data + sec.size);
+  uint32_t count = rd.u32();
+  rd.skip(4);
+  for (uint32_t i = 0; i < count && rd.good(); ++i)
+  {
+    NameIndex::Host host;
+    host.name = rd.str();
+    host.root = rd.str();
+    host.path = rd.str();
+    hosts_.push_back(host);
+  }
+  return rd.good();
+}
+//----< dir table record >-------------------------------------------
+
+NameIndexView::Dir NameIndexView::dir(DirId id) const
+{
+  const char* p = dirs_.data + id * DirRecSize;
+  Dir d;
+  d.parent = le32(p);
+  d.firstFile = le32(p + 8);
+  d.fileCount = le32(p + 12);
+  d.subtreeEnd = le32(p + 16);
+  return d;
+}
+//----< name of dir, without path >----------------------------------
+
+std::string NameIndexView::dirName(DirId id) const
+{
+  uint32_t offset = le32(dirs_.data + id * DirRecSize + 4);
+  BinaryIO::Reader rd(dirNames_.data + (std::min)(static_cast<uint64_t>(offset), dirNames_.size), dirNames_.data + dirNames_.size);
+  return rd.str();
+}
+//----< full path of dir, built from its ancestors >-----------------
+
+NameIndexView::Path NameIndexView::dirPath(DirId id) const
+{
+  std::vector<std::string> names;
+  for (; id != 0 && id < dirCount_; id = dir(id).parent)
+    names.push_back(dirName(id));
+  Path path = root_;
+  for (auto iter = names.rbegin(); iter != names.rend(); ++iter)
+    path += "\\" + *iter;
+  return path;
+}
+//----< dir with full path, or NoDir, walking down from root >-------
+/*
+ *  Children of d are d + 1, then each child's subtree end, up to d's
+ *  own subtree end.  Names compare without case, and / and \ are
+ *  both separators, as on Windows.
+ */
+NameIndexView::DirId NameIndexView::findDir(const Path& path) const
+{
+  std::vector<std::string> names;
+  if (!good() || !components(root_, path, names))
+    return NameIndex::NoDir;
+  DirId d = 0;
+  for (auto name : names)
+  {
+    DirId end = dir(d).subtreeEnd;
+    DirId child = d + 1;
+    while (child < end && !sameName(dirName(child), name.data(), name.size()))
+      child = dir(child).subtreeEnd;
+    if (child >= end)
+      return NameIndex::NoDir;
+    d = child;
+  }
+  return d;
+}
+
+uint64_t NameIndexView::fileSize(FileId id) const
+{
+  return le64(attribs_.data + id * AttribSize);
+}
+
+uint64_t NameIndexView::fileTime(FileId id) const
+{
+  return le64(attribs_.data + id * AttribSize + 8);
+}
+//----< decode one block into names separated by '\n' >--------------
+/*
+ *  starts[i] is the offset of name i in names, and the last entry is
+ *  one past the final separator.
+ */
+void NameIndexView::decodeBlock(uint32_t block, std::string& names, std::vector<size_t>& starts) const
+{
+  names.clear();
+  starts.clear();
+  uint64_t offset = le64(blocks_.data + block * 8ULL);
+  BinaryIO::Reader rd(names_.data + (std::min)(offset, names_.size), names_.data + names_.size);
+  size_t count = (std::min)(static_cast<size_t>(NameIndex::BlockSize), fileCount_ - block * NameIndex::BlockSize);
+  size_t prev = 0;
+  for (size_t i = 0; i < count && rd.good(); ++i)
+  {
+    size_t shared = static_cast<size_t>(rd.varint());
+    size_t rest = static_cast<size_t>(rd.varint());
+    const char* suffix = rd.bytes(rest);
+    if (suffix == nullptr)
+      break;
+    size_t start = names.size();
+    starts.push_back(start);
+    names.append(names, prev, (std::min)(shared, start - prev));
+    names.append(suffix, rest);
+    names.push_back('\n');
+    prev = start;
+  }
+  starts.push_back(names.size());
+}
+//----< collect names of files in [first, last) that match >---------
+
+void NameIndexView::match(FileId first, FileId last, const NameMatcher& matcher, std::vector<Hit>& hits) const
+{
+  const std::string& literal = matcher.literal();
+  std::string names;
+  std::vector<size_t> starts;
+  names.reserve(64 * NameIndex::BlockSize);
+  for (uint32_t block = first / NameIndex::BlockSize; block * NameIndex::BlockSize < last; ++block)
+  {
+    decodeBlock(block, names, starts);
+    FileId base = block * static_cast<FileId>(NameIndex::BlockSize);
+    size_t lo = (std::max)(first, base) - base;
+    size_t hi = (std::min)(static_cast<size_t>(last - base), starts.size() - 1);
+    size_t i = lo;
+    while (i < hi)
+    {
+      if (literal.size() > 0)
+      {
+        // skip to the name holding the next occurrence of the literal
+        const char* beg = names.data() + starts[i];
+        const char* end = names.data() + starts[hi];
+        const char* hit = NameMatcher::findLiteral(beg, end, literal);
+        if (hit == end)
+          break;
+        size_t offset = hit - names.data();
+        while (starts[i + 1] <= offset)
+          ++i;
+      }
+      const char* name = names.data() + starts[i];
+      size_t len = starts[i + 1] - starts[i] - 1;
+      if (matcher.matches(name, len))
+        hits.push_back(Hit(base + static_cast<FileId>(i), std::string(name, len)));
+      ++i;
+    }
+  }
+}
+//----< collect names of candidate files that match >---------------
+/*
+ *  Candidates are sorted, so each block is decoded at most once.
+ */
+void NameIndexView::matchIds(const TrigramQuery::Ids& ids, const NameMatcher& matcher, std::vector<Hit>& hits) const
+{
+  std::string names;
+  std::vector<size_t> starts;
+  uint32_t decoded = 0xffffffff;
+  for (auto id : ids)
+  {
+    uint32_t block = id / static_cast<uint32_t>(NameIndex::BlockSize);
+    if (block != decoded)
+    {
+      decodeBlock(block, names, starts);
+      decoded = block;
+    }
+    size_t i = id - block * NameIndex::BlockSize;
+    if (i + 1 >= starts.size())
+      continue;
+    const char* name = names.data() + starts[i];
+    size_t len = starts[i + 1] - starts[i] - 1;
+    if (matcher.matches(name, len))
+      hits.push_back(Hit(id, std::string(name, len)));
+  }
+}
+//----< sorted ids of one trigram's posting list >-------------------
+
+TrigramQuery::Ids NameIndexView::postings(const Section& sec, TrigramQuery::Trigram tg) const
+{
+  TrigramQuery::Ids ids;
+  uint32_t count = le32(sec.data);
+  const char* dirBeg = sec.data + 8;
+  const char* postBeg = dirBeg + count * TrigramEntrySize;
+  const char* end = sec.data + sec.size;
+  size_t lo = 0, hi = count;
+  while (lo < hi)   // binary search fixed size directory entries
+  {
+    size_t mid = (lo + hi) / 2;
+    BinaryIO::Reader ent(dirBeg + mid * TrigramEntrySize, dirBeg + (mid + 1) * TrigramEntrySize);
+    uint32_t key = ent.u32();
+    if (key < tg)
+      lo = mid + 1;
+    else if (key > tg)
+      hi = mid;
+    else
+    {
+      uint64_t offset = ent.u64();
+      uint32_t n = ent.u32();
+      BinaryIO::Reader prd(postBeg + (std::min)(offset, static_cast<uint64_t>(end - postBeg)), end);
+      uint32_t id = 0;
+      ids.reserve(n);
+      for (uint32_t i = 0; i < n && prd.good(); ++i)
+      {
+        id += static_cast<uint32_t>(prd.varint());
+        ids.push_back(id);
+      }
+      break;
+    }
+  }
+  return ids;
+}
+//----< filter keys every file matching the query must have >-------
+
+NameIndexView::Needs NameIndexView::needs(const NameMatcher& matcher) const
+{
+  Needs result;
+  if (blooms_.data == nullptr)
+    return result;
+  for (auto& pattern : matcher.patterns())
+  {
+    std::string ext;
+    if (!patternExt(pattern, ext))
+    {
+      result.exts.clear();
+      break;
+    }
+    result.exts.push_back(extKey(ext));
+  }
+  TrigramQuery query(matcher.regex());
+  if (!matcher.matchesAnyName() && !query.matchesAll())
+  {
+    for (auto& branch : query.branches())
+    {
+      std::vector<uint64_t> keys;
+      for (auto tg : branch)
+        keys.push_back(trigramKey(tg));
+      result.branches.push_back(keys);
+    }
+  }
+  return result;
+}
+//----< false if d's subtree filter rules out every match >----------
+
+bool NameIndexView::mayContain(DirId d, const Needs& needs) const
+{
+  if (blooms_.data == nullptr || (needs.exts.size() == 0 && needs.branches.size() == 0))
+    return true;
+  uint64_t offset = le32(blooms_.data + d * BloomEntrySize);
+  uint32_t bits = le32(blooms_.data + d * BloomEntrySize + 4);
+  const char* words = blooms_.data + dirCount_ * BloomEntrySize;
+  uint64_t wordCount = (blooms_.size - dirCount_ * BloomEntrySize) / 8;
+  if (bits == 0 || (bits & (bits - 1)) != 0 || offset + bits / 64 > wordCount)
+    return true;   // no filter, subtree has too many keys
+  auto has = [&](uint64_t key) {
+    for (uint32_t i = 0; i < BloomHashes; ++i)
+    {
+      uint32_t bit = bloomBit(key, i, bits);
+      if ((le64(words + (offset + bit / 64) * 8) & (1ULL << (bit % 64))) == 0)
+        return false;
+    }
+    return true;
+  };
+  if (needs.exts.size() > 0 && std::none_of(needs.exts.begin(), needs.exts.end(), has))
+    return false;
+  if (needs.branches.size() > 0 && std::none_of(needs.branches.begin(), needs.branches.end(),
+      [&](const std::vector<uint64_t>& branch) { return std::all_of(branch.begin(), branch.end(), has); }))
+    return false;
+  return true;
+}
+//----< file ranges of dirs to search, skipping pruned subtrees >----
+
+std::vector<NameIndexView::Range> NameIndexView::fileRanges(DirId d, bool recurse, const NameMatcher& matcher) const
+{
+  Needs nd = needs(matcher);
+  DirId end = recurse ? dir(d).subtreeEnd : d + 1;
+  std::vector<Range> ranges;
+  DirId id = d;
+  while (id < end)
+  {
+    Dir rec = dir(id);
+    if (!mayContain(id, nd))
+    {
+      id = rec.subtreeEnd;
+      continue;
+    }
+    if (rec.fileCount > 0)
+    {
+      if (ranges.size() > 0 && ranges.back().second == rec.firstFile)
+        ranges.back().second += rec.fileCount;
+      else
+        ranges.push_back(Range(rec.firstFile, rec.firstFile + rec.fileCount));
+    }
+    ++id;
+  }
+  return ranges;
+}
+//----< files holding the query's literals, false if none narrow it >
+/*
+ *  From the suffix array if there is one, else from trigram postings.
+ */
+bool NameIndexView::literalIds(const NameMatcher& matcher, TrigramQuery::Ids& ids) const
+{
+  if (fragmentIds(matcher, ids))
+    return true;
+  if (fileTrigrams_.data == nullptr || matcher.matchesAnyName())
+    return false;
+  TrigramQuery query(matcher.regex());
+  if (query.matchesAll())
+    return false;
+  ids = query.candidates([&](TrigramQuery::Trigram tg) { return postings(fileTrigrams_, tg); });
+  return true;
+}
+//----< candidate files in ranges, false if scan is better >---------
+/*
+ *  Candidates come from the query's literals and from the extension
+ *  facets of its /p patterns.  When they are a large part of the ranges nearly
+ *  every block gets decoded anyway, and the threaded scan does that
+ *  faster.
+ */
+bool NameIndexView::candidates(const std::vector<Range>& ranges, const NameMatcher& matcher, TrigramQuery::Ids& ids) const
+{
+  if (ranges.size() == 0)
+    return false;
+  TrigramQuery::Ids all;
+  bool found = literalIds(matcher, all);
+  Roaring exts;
+  if (extFiles(matcher, exts))
+  {
+    all = found ? TrigramQuery::intersect(all, exts.ids()) : exts.ids();
+    found = true;
+  }
+  if (!found)
+    return false;
+  ids.clear();
+  size_t total = 0, r = 0;
+  for (auto& range : ranges)
+    total += range.second - range.first;
+  for (auto id : all)
+  {
+    while (r < ranges.size() && id >= ranges[r].second)
+      ++r;
+    if (r == ranges.size())
+      break;
+    if (id >= ranges[r].first)
+      ids.push_back(id);
+  }
+  return ids.size() <= total / 4;
+}
+//----< visit matching files of dir, and of its subtree if recurse >-
+/*
+ *  Subtrees whose Bloom filters rule out a match are skipped.  Trigram
+ *  candidates, when there are few, are matched directly.  Otherwise
+ *  the remaining ranges are split across threads.  Hits are visited in
+ *  index order, on the calling thread.
+ */
+void NameIndexView::scan(DirId d, bool recurse, const NameMatcher& matcher, Visitor visit) const
+{
+  if (!good() || d >= dirCount_)
+    return;
+  DirId endDir = recurse ? dir(d).subtreeEnd : d + 1;
+  std::vector<Range> ranges = fileRanges(d, recurse, matcher);
+  FileId total = 0;
+  for (auto& range : ranges)
+    total += range.second - range.first;
+
+  const FileId MinPerThread = 1 << 16;
+  size_t threads = (std::max)(1u, std::thread::hardware_concurrency());
+  threads = (std::min)(threads, static_cast<size_t>(total / MinPerThread + 1));
+  std::vector<std::vector<Hit>> hits(threads);
+  TrigramQuery::Ids ids;
+  if (candidates(ranges, matcher, ids))
+  {
+    hits.resize(1);
+    matchIds(ids, matcher, hits[0]);
+  }
+  else if (threads == 1)
+  {
+    for (auto& range : ranges)
+      match(range.first, range.second, matcher, hits[0]);
+  }
+  else
+  {
+    // deal ranges out in order, about total / threads files to each
+    std::vector<std::vector<Range>> work(threads);
+    FileId share = total / static_cast<FileId>(threads) + 1;
+    FileId room = share;
+    size_t t = 0;
+    for (auto range : ranges)
+    {
+      while (range.first < range.second)
+      {
+        FileId count = (std::min)(room, range.second - range.first);
+        work[t].push_back(Range(range.first, range.first + count));
+        range.first += count;
+        room -= count;
+        if (room == 0)
+        {
+          t = (std::min)(t + 1, threads - 1);
+          room = share;
+        }
+      }
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i)
+    {
+      workers.push_back(std::thread([=, &matcher, &work, &hits]() {
+        for (auto& range : work[i])
+          match(range.first, range.second, matcher, hits[i]);
+      }));
+    }
+    for (auto& worker : workers)
+      worker.join();
+  }
+
+  visitHits(d, endDir, hits, visit);
+}
+//----< visit hits, in index order, with the dir holding each >------
+
+void NameIndexView::visitHits(DirId d, DirId endDir, const std::vector<std::vector<Hit>>& hits, Visitor visit) const
+{
+  DirId curr = d;
+  Dir currDir = dir(d);
+  for (auto& part : hits)
+  {
+    for (auto& hit : part)
+    {
+      while (hit.first >= currDir.firstFile + currDir.fileCount && curr + 1 < endDir)
+        currDir = dir(++curr);
+      visit(curr, hit.first, hit.second);
+    }
+  }
+}
+//----< visit matching files last written in [from, to] >------------
+/*
+ *  With facets, candidates are the bitmap result of the dir range,
+ *  patterns, and days, narrowed by the regex's literals, then checked
+ *  against exact times.  Older indexes check the time of each match.
+ */
+void NameIndexView::scan(DirId d, bool recurse, const NameMatcher& matcher, uint64_t from, uint64_t to, Visitor visit) const
+{
+  auto inRange = [&](FileId f) {
+    uint64_t time = fileTime(f);
+    return time >= from && time <= to;
+  };
+  if (from == 0 && to == Always)
+    scan(d, recurse, matcher, visit);
+  else if (!hasFacets())
+  {
+    scan(d, recurse, matcher, [&](DirId dd, FileId f, const std::string& name) {
+      if (inRange(f))
+        visit(dd, f, name);
+    });
+  }
+  else if (good() && d < dirCount_)
+  {
+    TrigramQuery::Ids ids = facetFiles(d, recurse, matcher, from, to).ids();
+    TrigramQuery::Ids withLiterals;
+    if (literalIds(matcher, withLiterals))
+      ids = TrigramQuery::intersect(ids, withLiterals);
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [&](FileId f) { return !inRange(f); }), ids.end());
+    std::vector<std::vector<Hit>> hits(1);
+    matchIds(ids, matcher, hits[0]);
+    visitHits(d, recurse ? dir(d).subtreeEnd : d + 1, hits, visit);
+  }
+}
+//----< one past the last file of dir, or of its subtree >-----------
+
+NameIndexView::FileId NameIndexView::fileEnd(DirId d, bool recurse) const
+{
+  Dir rec = dir(d);
+  if (!recurse)
+    return rec.firstFile + rec.fileCount;
+  return rec.subtreeEnd < dirCount_ ? dir(rec.subtreeEnd).firstFile : fileCount_;
+}
+//----< bitmap at offset in the facet section >----------------------
+
+Roaring NameIndexView::facet(uint64_t offset) const
+{
+  Roaring bitmap;
+  const char* end = facets_.data + facets_.size;
+  if (offset < static_cast<uint64_t>(end - facetBitmaps_))
+  {
+    BinaryIO::Reader rd(facetBitmaps_ + offset, end);
+    if (!bitmap.read(rd))
+      bitmap = Roaring();
+  }
+  return bitmap;
+}
+//----< files with any /p pattern's extension, false if not fixed >--
+
+bool NameIndexView::extFiles(const NameMatcher& matcher, Roaring& files) const
+{
+  if (!hasFacets() || matcher.patterns().size() == 0)
+    return false;
+  std::vector<std::string> exts;
+  for (auto& pattern : matcher.patterns())
+  {
+    std::string ext;
+    if (!patternExt(pattern, ext))
+      return false;
+    exts.push_back(lowerCase(ext));
+  }
+  std::sort(exts.begin(), exts.end());
+  exts.erase(std::unique(exts.begin(), exts.end()), exts.end());
+  files = Roaring();
+  for (auto& ext : exts)
+  {
+    auto iter = std::lower_bound(extFacets_.begin(), extFacets_.end(), ext,
+      [](const std::pair<std::string, uint64_t>& item, const std::string& e) { return item.first < e; });
+    if (iter != extFacets_.end() && iter->first == ext)
+      files = Roaring::unite(files, facet(iter->second));
+  }
+  return true;
+}
+//----< files of within last written on days touching [from, to] >--
+/*
+ *  Days are whole UTC days, so files near the ends still need their
+ *  exact times checked.  When most days are inside the range, fewer
+ *  bitmaps are read by removing the days outside it.
+ */
+Roaring NameIndexView::timeFiles(uint64_t from, uint64_t to, const Roaring& within) const
+{
+  uint32_t first = static_cast<uint32_t>(from / TicksPerDay);
+  uint32_t last = static_cast<uint32_t>((std::min)(to / TicksPerDay, static_cast<uint64_t>(0xffffffff)));
+  auto lo = std::lower_bound(dayFacets_.begin(), dayFacets_.end(), first,
+    [](const std::pair<uint32_t, uint64_t>& item, uint32_t day) { return item.first < day; });
+  auto hi = std::upper_bound(lo, dayFacets_.end(), last,
+    [](uint32_t day, const std::pair<uint32_t, uint64_t>& item) { return day < item.first; });
+  size_t inside = hi - lo;
+  Roaring days;
+  if (inside * 2 <= dayFacets_.size())
+  {
+    for (auto iter = lo; iter != hi; ++iter)
+      days = Roaring::unite(days, facet(iter->second));
+    return Roaring::intersect(within, days);
+  }
+  for (auto iter = dayFacets_.begin(); iter != lo; ++iter)
+    days = Roaring::unite(days, facet(iter->second));
+  for (auto iter = hi; iter != dayFacets_.end(); ++iter)
+    days = Roaring::unite(days, facet(iter->second));
+  return Roaring::subtract(within, days);
+}
+//----< facet candidates: dir's files, by pattern, by day >----------
+/*
+ *  The result may hold files the regex, or exact times, rule out.
+ */
+Roaring NameIndexView::facetFiles(DirId d, bool recurse, const NameMatcher& matcher, uint64_t from, uint64_t to) const
+{
+  if (!good() || d >= dirCount_)
+    return Roaring();
+  Roaring files = Roaring::range(dir(d).firstFile, fileEnd(d, recurse));
+  Roaring exts;
+  if (extFiles(matcher, exts))
+    files = Roaring::intersect(files, exts);
+  if (hasFacets() && (from > 0 || to != Always))
+    files = timeFiles(from, to, files);
+  return files;
+}
+//----< number of files in each extension facet >--------------------
+
+std::vector<NameIndexView::Count> NameIndexView::extCounts(const Roaring& files) const
+{
+  std::vector<Count> counts;
+  for (auto& item : extFacets_)
+  {
+    uint64_t n = Roaring::intersectCount(files, facet(item.second));
+    if (n > 0)
+      counts.push_back(Count(item.first, n));
+  }
+  return counts;
+}
+//----< number of files in dir itself, then below each subdir >-----
+
+std::vector<std::pair<NameIndexView::DirId, uint64_t>> NameIndexView::dirCounts(DirId d, const Roaring& files) const
+{
+  std::vector<std::pair<DirId, uint64_t>> counts;
+  if (!good() || d >= dirCount_)
+    return counts;
+  Dir top = dir(d);
+  counts.push_back(std::make_pair(d, Roaring::intersectCount(files, Roaring::range(top.firstFile, top.firstFile + top.fileCount))));
+  for (DirId child = d + 1; child < top.subtreeEnd; child = dir(child).subtreeEnd)
+  {
+    Roaring below = Roaring::range(dir(child).firstFile, fileEnd(child, true));
+    counts.push_back(std::make_pair(child, Roaring::intersectCount(files, below)));
+  }
+  return counts;
+}
+//----< suffix array positions of suffixes starting with fragment >-
+/*
+ *  Two binary searches, each comparing at most m characters per step,
+ *  so O(m log n).  Fragments are lower cased like the text.
+ */
+NameIndexView::Range NameIndexView::suffixRange(std::string fragment) const
+{
+  fragment = lowerCase(fragment);
+  const unsigned char* text = reinterpret_cast<const unsigned char*>(text_);
+  const unsigned char* frag = reinterpret_cast<const unsigned char*>(fragment.data());
+  auto compare = [&](uint64_t i) {
+    uint64_t pos = le32(suffixArray_ + 4 * i);
+    for (size_t k = 0; k < fragment.size(); ++k)
+    {
+      if (pos + k >= textSize_ || text[pos + k] < frag[k])
+        return -1;   // '\n' ends every name, before any fragment character
+      if (text[pos + k] > frag[k])
+        return 1;
+    }
+    return 0;
+  };
+  uint64_t lo = 0, hi = suffixCount_;
+  while (lo < hi)
+  {
+    uint64_t mid = (lo + hi) / 2;
+    if (compare(mid) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  uint64_t first = lo;
+  hi = suffixCount_;
+  while (lo < hi)
+  {
+    uint64_t mid = (lo + hi) / 2;
+    if (compare(mid) <= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return Range(static_cast<uint32_t>(first), static_cast<uint32_t>(lo));
+}
+//----< occurrences of fragment in file names, without case >--------
+
+size_t NameIndexView::countSubstring(const std::string& fragment) const
+{
+  if (suffixArray_ == nullptr || fragment.size() == 0)
+    return 0;
+  Range range = suffixRange(fragment);
+  return range.second - range.first;
+}
+//----< sorted ids of files whose names contain fragment >-----------
+
+TrigramQuery::Ids NameIndexView::filesWith(const std::string& fragment) const
+{
+  TrigramQuery::Ids ids;
+  if (suffixArray_ == nullptr || fragment.size() == 0)
+    return ids;
+  Range range = suffixRange(fragment);
+  ids.reserve(range.second - range.first);
+  for (uint32_t i = range.first; i < range.second; ++i)
+  {
+    uint32_t pos = le32(suffixArray_ + 4ULL * i);
+    uint32_t lo = 0, hi = fileCount_;   // last name starting at or before pos
+    while (hi - lo > 1)
+    {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (le32(textStarts_ + 4ULL * mid) <= pos)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    ids.push_back(lo);
+  }
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  return ids;
+}
+//----< files holding the query's literal fragments, from suffixes >-
+/*
+ *  Every /p pattern must have a fragment for patterns to narrow the
+ *  search.  The regex contributes its longest literal, of any length.
+ */
+bool NameIndexView::fragmentIds(const NameMatcher& matcher, TrigramQuery::Ids& ids) const
+{
+  if (suffixArray_ == nullptr)
+    return false;
+  bool found = false;
+  std::vector<std::string> fragments;
+  for (auto& pattern : matcher.patterns())
+  {
+    std::string fragment = patternFragment(pattern);
+    if (fragment.size() == 0)
+      break;
+    fragments.push_back(fragment);
+  }
+  if (fragments.size() > 0 && fragments.size() == matcher.patterns().size())
+  {
+    ids.clear();
+    for (auto& fragment : fragments)
+      ids = TrigramQuery::unite(ids, filesWith(fragment));
+    found = true;
+  }
+  if (!matcher.matchesAnyName())
+  {
+    std::string longest;
+    for (auto run : TrigramQuery::literals(matcher.regex(), 1))
+    {
+      if (run.size() > longest.size())
+        longest = run;
+    }
+    if (longest.size() > 0)
+    {
+      TrigramQuery::Ids withLiteral = filesWith(longest);
+      ids = found ? TrigramQuery::intersect(ids, withLiteral) : withLiteral;
+      found = true;
+    }
+  }
+  return found;
+}
+//----< preorder ranges of the subtrees of sorted dirs >-------------
+
+std::vector<NameIndexView::Range> NameIndexView::subtrees(const TrigramQuery::Ids& dirs) const
+{
+  std::vector<Range> ranges;
+  for (auto d : dirs)
+  {
+    if (d >= dirCount_ || (ranges.size() > 0 && d < ranges.back().second))
+      continue;   // already inside an ancestor's range
+    ranges.push_back(Range(d, dir(d).subtreeEnd));
+  }
+  return ranges;
+}
+//----< dirs of dir, and of its subtree if recurse, whose path matches >
+/*
+ *  A dir's path contains a trigram if its own name or an ancestor's
+ *  does, so each trigram selects whole subtrees.  Trigrams that span
+ *  a separator, or that the root path already contains, say nothing
+ *  about which dirs match and are left out of the query.
+ */
+std::vector<NameIndexView::DirId> NameIndexView::matchDirs(DirId d, bool recurse, const std::string& regex) const
+{
+  std::vector<DirId> result;
+  if (!good() || d >= dirCount_)
+    return result;
+  DirId end = recurse ? dir(d).subtreeEnd : d + 1;
+  std::vector<Range> ranges(1, Range(d, end));
+  TrigramQuery query(regex);
+  if (dirTrigrams_.data != nullptr && !query.matchesAll())
+  {
+    TrigramQuery::Trigrams rootTrigrams = TrigramQuery::trigramsOf(root_.data(), root_.data() + root_.size());
+    auto usable = [&](TrigramQuery::Trigram tg) {
+      for (int shift = 0; shift < 24; shift += 8)
+      {
+        char c = static_cast<char>((tg >> shift) & 0xff);
+        if (c == '\\' || c == '/')
+          return false;
+      }
+      return !std::binary_search(rootTrigrams.begin(), rootTrigrams.end(), tg);
+    };
+    ranges.clear();
+    for (auto& branch : query.branches())
+    {
+      std::vector<Range> part(1, Range(d, end));
+      for (auto tg : branch)
+      {
+        if (usable(tg))
+          part = intersectRanges(part, subtrees(postings(dirTrigrams_, tg)));
+      }
+      ranges.insert(ranges.end(), part.begin(), part.end());
+    }
+    mergeRanges(ranges);
+  }
+  std::regex re(regex);
+  for (auto& range : ranges)
+  {
+    for (DirId id = range.first; id < range.second; ++id)
+    {
+      if (std::regex_search(dirPath(id), re))
+        result.push_back(id);
+    }
+  }
+  return result;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_NAMEINDEX
+
+#include <iostream>
+#include <chrono>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing NameIndex";
+  std::cout << "\n ===================";
+  std::string root = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : "..");
+  std::string regex = argc > 2 ? argv[2] : "^File";
+
+  auto start = std::chrono::steady_clock::now();
+  NameIndex ni(NameIndex::defaultFile(root));
+  ni.suffixArray(true);
+  ni.build(root);
+  if (!ni.save())
+  {
+    std::cout << "\n  " << ni.error() << "\n\n";
+    return 1;
+  }
+  auto built = std::chrono::steady_clock::now();
+  NameIndex::Stats st = ni.stats();
+  std::cout << "\n  indexed " << st.dirs << " dirs, " << st.files << " files in " << st.bytes << " bytes, "
+    << std::chrono::duration_cast<std::chrono::milliseconds>(built - start).count() << " ms";
+
+  NameIndexView view(ni.indexFile());
+  if (!view.good())
+  {
+    std::cout << "\n  " << view.error() << "\n\n";
+    return 1;
+  }
+  NameIndex::DirId last = NameIndex::NoDir;
+  view.scan(0, true, NameMatcher({ "*.h", "*.cpp" }, regex),
+    [&](NameIndex::DirId d, NameIndex::FileId f, const std::string& name) {
+      if (d != last)
+        std::cout << "\n  " << view.dirPath(last = d);
+      std::cout << "\n    " << name << "  " << view.fileSize(f) << " bytes";
+    }
+  );
+  auto queried = std::chrono::steady_clock::now();
+  std::cout << "\n  query took " << std::chrono::duration_cast<std::chrono::microseconds>(queried - built).count() << " us";
+  std::string sub = root + "\\FindFiles";
+  std::cout << "\n  findDir(" << sub << ") = " << view.findDir(sub);
+  std::cout << "\n  dirs matching \"FindFiles$|Utilities$\":";
+  for (auto d : view.matchDirs(0, true, "FindFiles$|Utilities$"))
+    std::cout << "\n    " << view.dirPath(d);
+  if (view.hasSuffixArray())
+    std::cout << "\n  \"mgr\" occurs in " << view.countSubstring("mgr") << " places, in "
+      << view.filesWith("mgr").size() << " file names";
+
+  std::string globalFile = FileSystem::Path::fileSpec(root, "global.fidx");
+  NameIndex global(globalFile);
+  if (global.merge("node1", ni.indexFile()) && global.save())
+  {
+    NameIndexView gv(globalFile);
+    std::cout << "\n  merged as " << gv.hosts()[0].path << ", findDir = " << gv.findDir(gv.hosts()[0].path + "\\FindFiles");
+  }
+  FileSystem::File::remove(globalFile);
+  FileSystem::File::remove(NameIndex::segmentFile(globalFile));
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
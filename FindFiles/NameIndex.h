@@ -0,0 +1,495 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+///////////////////////////////////////////////////////////////////////
+// NameIndex.h - persistent, memory-mapped index of file names       //
+// Ver 1.9                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Walking a large tree takes most of the time of every FindFiles run,
+ * even when nothing has changed.  NameIndex walks it once and saves:
+ * - a directory table in depth first preorder.  Each directory knows
+ *   its parent, its files, and where its subtree ends, so any subtree
+ *   is one contiguous range of directories and of files.
+ * - a front coded name table.  Names are sorted within each directory
+ *   and stored in blocks of 16, each name as the length of the prefix
+ *   it shares with the name before it plus the rest.  Every block
+ *   starts with a whole name, so blocks can be decoded independently.
+ * - each file's size and last write time.
+ *
+ * A loaded index can be kept current by applying single changes:
+ * update(path) re-reads one file or dir, remove(path) drops one, and
+ * rescan(dir) re-walks just one subtree.  IndexWatch uses these to
+ * follow change notifications.
+ *
+ * build(root) walks the tree on several threads, one per core unless
+ * threads(n) says otherwise.  Each thread keeps the dirs it walked as
+ * a segment sorted into preorder, and the segments are merged, so the
+ * saved index is the same for any number of threads.  A progress(...)
+ * callback is called about twice a second while the walk runs.
+ *
+ * Saved indexes are immutable segments.  Each save writes a new file,
+ * indexFile.N for generation N, then atomically replaces indexFile, a
+ * 16 byte pointer to the current segment.  Readers that mapped the old
+ * segment keep using it, and it is deleted by a later save, once no
+ * one has it mapped.  With logChanges(true), changes made with
+ * change(op, path) are first appended to a write-ahead log for the
+ * current generation, indexFile.wal.N, and load() replays the logs of
+ * the current and later generations.  snapshot() copies the index for
+ * saving on another thread, and starts the next generation's log, so
+ * a watcher can keep logging while the copy is saved.
+ *
+ * NameIndexView maps a saved index read only and answers /p and /R
+ * queries straight from the mapped pages, so there is no load step.
+ * Large scans split their blocks across threads.  Regex matching is
+ * only done on names containing the regex's longest literal, found
+ * with NameMatcher's SSE2 scan of each decoded block.
+ *
+ * The index also holds trigram posting lists over file names and over
+ * dir names.  A regex like "FindFiles$|Utilities$" becomes an OR of
+ * ANDs of trigrams, the posting lists are intersected and united, and
+ * only the surviving candidates are decoded and matched.  A regex with
+ * no usable literals, or one whose candidates cover much of the range,
+ * is answered by the scan instead.  For dirs, a trigram in a dir's name
+ * is in the path of every dir below it, so postings become subtree
+ * ranges before they are combined.
+ *
+ * Each dir also gets a small Bloom filter of the extensions and name
+ * trigrams of all files in its subtree.  A query for "*.cs", or for a
+ * regex with literals, tests each subtree's filter and skips the whole
+ * subtree when the filter says no file there can match, so selective
+ * queries cost in proportion to the part of the tree that might match.
+ * Subtrees with too many distinct keys for a useful filter have none,
+ * and are always searched.
+ *
+ * Optionally, the index also holds a suffix array over all file names,
+ * lower cased and joined with '\n'.  Binary search of the mapped array
+ * finds every name containing a fragment of any length, e.g., "Lo" of
+ * *Lo*, in O(m log n) time, with no load step.  Trigrams can't narrow
+ * fragments shorter than three characters.  scan uses it for /p and /R
+ * literals when present.  It costs about four bytes per name character,
+ * so it is only built when asked for.
+ *
+ * Facets - each extension and each day of last write - have Roaring
+ * bitmaps of their file ids.  A query like *.h or *.cpp below a dir,
+ * modified since Monday, is the OR of two extension bitmaps, ANDed with
+ * the dir's id range and with the OR of the days in range, and only the
+ * result is decoded.  A wide time range is taken as the range ANDNOT
+ * the days outside it, when that needs fewer bitmaps.  Counts per
+ * extension or per subdir, of any result, are bitmap intersections.
+ *
+ * merge(host, inputFile) mounts a copy of another host's index in a
+ * global index, so one query searches the scratch disks of many build
+ * nodes without touching the network.  A global index's root is "\",
+ * and each host's tree hangs below its network path: a tree indexed
+ * as D:\scratch on node1 becomes \\node1\D$\scratch, so queries
+ * return host qualified paths.  The mounts are saved as a host table.
+ * Merging a newer copy from the same host replaces its tree, and a
+ * global index can itself be merged into another.
+ *
+ * The file is a header followed by a table of tagged sections, so new
+ * sections can be added without breaking older readers.
+ *
+ * Public Interface:
+ * -----------------
+ * NameIndex ni(NameIndex::defaultFile(root));
+ * ni.suffixArray(true);   // optional
+ * ni.threads(8);          // optional, default is one per core
+ * ni.progress([](size_t dirs, size_t files) { ... });
+ * ni.build(root);
+ * ni.save();
+ * ni.load();
+ * ni.logChanges(true);
+ * ni.change(IndexLog::Update, root + "\\FindFiles\\NameIndex.h");
+ * ni.syncLog();
+ * NameIndex copy = ni.snapshot();   // copy.save() on another thread
+ * ni.update(root + "\\FindFiles\\NameIndex.h");
+ * ni.rescan(root + "\\CppUtilities");
+ * if (ni.dirty()) ni.save();
+ *
+ * NameIndex global("global.fidx");
+ * global.merge("node1", "node1.fidx");   // copy of node1's segment
+ * global.merge("node2", "node2.fidx");
+ * global.save();
+ *
+ * NameIndexView view(NameIndex::defaultFile(root));
+ * NameIndex::DirId dir = view.findDir(root + "\\FindFiles");
+ * view.scan(dir, true, NameMatcher({ "*.h" }, "^File"),
+ *   [](NameIndex::DirId d, NameIndex::FileId f, const std::string& name) { ... });
+ * std::vector<NameIndex::DirId> dirs = view.matchDirs(0, true, "Utilities$");
+ * size_t n = view.countSubstring("logger");   // needs suffix array
+ * view.scan(dir, true, matcher, weekAgo, NameIndexView::Always, visitor);
+ * Roaring files = view.facetFiles(dir, true, matcher, weekAgo, NameIndexView::Always);
+ * for (auto item : view.extCounts(files)) ...
+ * for (auto& host : view.hosts()) ...   // empty unless merged
+ *
+ * Required Files:
+ * ---------------
+ * NameIndex.h, NameIndex.cpp, Roaring.h, Roaring.cpp, IndexLog.h, IndexLog.cpp
+ * NameMatch.h, NameMatch.cpp, Trigram.h, Trigram.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.9 : 18 Oct 2026
+ * - snapshot() copies the hosts of a global index, so a watched global
+ *   index keeps its HOST section when compacted
+ * - build's workers and its progress loop wait on separate condition
+ *   variables, so a wakeup meant for an idle worker can't be taken by
+ *   the progress loop
+ * Ver 1.8 : 18 Oct 2026
+ * - added merge of other hosts' indexes into a global index, with a
+ *   host table and host qualified paths
+ * Ver 1.7 : 18 Oct 2026
+ * - build walks the tree on worker threads, merging their sorted
+ *   segments, and reports progress
+ * Ver 1.6 : 18 Oct 2026
+ * - saves write immutable segments and switch a pointer file to them;
+ *   added write-ahead log of changes, replayed by load, and snapshot
+ * Ver 1.5 : 18 Oct 2026
+ * - added Roaring bitmap facets by extension and day of last write,
+ *   used by scan with a time range, extCounts, and dirCounts
+ * Ver 1.4 : 18 Oct 2026
+ * - added optional suffix array of names, with countSubstring and
+ *   filesWith, used by scan for literal fragments
+ * Ver 1.3 : 18 Oct 2026
+ * - added per subtree Bloom filters of extensions and name trigrams;
+ *   scan skips subtrees that can't hold a match
+ * Ver 1.2 : 18 Oct 2026
+ * - added trigram postings of file and dir names, used by scan and by
+ *   new matchDirs to skip names that can't match
+ * Ver 1.1 : 18 Oct 2026
+ * - added load, update, remove, rescan, and refreshDir for keeping a
+ *   loaded index current
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include "NameMatch.h"
+#include "Trigram.h"
+#include "Roaring.h"
+#include "IndexLog.h"
+#include "FileSystem.h"
+
+class NameIndexView;
+
+class NameIndex
+{
+public:
+  using Path = std::string;
+  using DirId = uint32_t;
+  using FileId = uint32_t;
+  static const DirId NoDir = 0xffffffff;
+  static const size_t BlockSize = 16;   // names per front coded block
+  static const unsigned ProgressMillis = 500;
+  using Progress = std::function<void(size_t dirs, size_t files)>;
+
+  struct FileRec
+  {
+    std::string name;
+    uint64_t size = 0;
+    uint64_t time = 0;   // last write, 100 ns ticks since 1601, UTC
+  };
+
+  struct DirRec
+  {
+    std::string name;
+    DirId parent = NoDir;
+    std::vector<DirId> dirs;
+    std::vector<FileRec> files;
+  };
+
+  struct Stats
+  {
+    size_t dirs = 0;
+    size_t files = 0;
+    size_t bytes = 0;      // size of saved index
+    size_t replayed = 0;   // logged changes applied by load
+  };
+
+  struct Host
+  {
+    std::string name;
+    Path root;   // as indexed on the host
+    Path path;   // of root in a global index, e.g., \\node1\D$\scratch
+  };
+  using Hosts = std::vector<Host>;
+
+  NameIndex(const Path& indexFile);
+  static Path defaultFile(const Path& root);
+  static Path segmentFile(const Path& indexFile);
+  static Path logFile(const Path& indexFile, uint64_t generation);
+  static Path hostPath(const std::string& host, const Path& root);
+
+  void suffixArray(bool add);
+  void threads(size_t count);
+  void progress(Progress report);
+  void build(const Path& root);
+  bool load();
+  bool save();
+  bool merge(const std::string& host, const Path& inputFile);
+  const Hosts& hosts() const;
+
+  DirId findDir(const Path& path) const;
+  void update(const Path& path);
+  void remove(const Path& path);
+  void rescan(const Path& dir);
+  void refreshDir(const Path& dir);
+  bool dirty() const;
+
+  void logChanges(bool on);
+  void change(IndexLog::Op op, const Path& path);
+  bool syncLog();
+  NameIndex snapshot();
+  uint64_t generation() const;
+
+  Path indexFile();
+  Path root();
+  Stats stats();
+  std::string error();
+private:
+  std::vector<FileRec> readDir(const Path& path, std::vector<std::string>& subdirs) const;
+  void scan(DirId dir, const Path& path);
+  DirId findChild(DirId dir, const std::string& name) const;
+  DirId addDir(DirId parent, const std::string& name);
+  void detach(DirId dir);
+  bool isIndexFile(const Path& path) const;
+  void apply(IndexLog::Op op, const Path& path);
+  bool mount(const NameIndexView& view, DirId from, const Host& host);
+  void replay(uint64_t segment);
+  void removeStale() const;
+  void preorder(std::vector<DirId>& order, std::vector<DirId>& position) const;
+  void compact(const std::vector<DirId>& order, const std::vector<DirId>& position);
+  std::string bloomSection(const std::vector<DirId>& order, const std::vector<DirId>& position) const;
+  std::string suffixSection(const std::vector<const std::string*>& names) const;
+
+  Path indexFile_;
+  Path root_;
+  std::vector<DirRec> dirs_;   // dirs_[0] is root
+  Hosts hosts_;                // mounted by merge, if global
+  size_t deadDirs_ = 0;        // detached, reclaimed by save
+  bool dirty_ = false;
+  bool suffixArray_ = false;
+  size_t threads_ = 0;               // for build, 0 is one per core
+  Progress progress_;
+  uint64_t generation_ = 0;          // of the log being appended
+  bool logging_ = false;
+  std::unique_ptr<IndexLog> log_;    // opened by first logged change
+  Stats stats_;
+  std::string error_;
+};
+
+inline void NameIndex::suffixArray(bool add)
+{
+  suffixArray_ = add;
+}
+
+inline bool NameIndex::dirty() const
+{
+  return dirty_;
+}
+
+inline void NameIndex::threads(size_t count)
+{
+  threads_ = count;
+}
+
+inline void NameIndex::progress(Progress report)
+{
+  progress_ = report;
+}
+
+inline void NameIndex::logChanges(bool on)
+{
+  logging_ = on;
+}
+
+inline uint64_t NameIndex::generation() const
+{
+  return generation_;
+}
+
+inline const NameIndex::Hosts& NameIndex::hosts() const
+{
+  return hosts_;
+}
+
+inline NameIndex::Path NameIndex::indexFile()
+{
+  return indexFile_;
+}
+
+inline NameIndex::Path NameIndex::root()
+{
+  return root_;
+}
+
+inline NameIndex::Stats NameIndex::stats()
+{
+  return stats_;
+}
+
+inline std::string NameIndex::error()
+{
+  return error_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// NameIndexView class
+// - read only queries on a mapped index file
+
+class NameIndexView
+{
+public:
+  using Path = NameIndex::Path;
+  using DirId = NameIndex::DirId;
+  using FileId = NameIndex::FileId;
+  using Visitor = std::function<void(DirId dir, FileId file, const std::string& name)>;
+  using Count = std::pair<std::string, uint64_t>;
+  static const uint64_t Always = ~0ULL;   // open end of a time range
+
+  struct Dir
+  {
+    DirId parent;
+    uint32_t firstFile;
+    uint32_t fileCount;
+    DirId subtreeEnd;   // first dir after this dir's subtree
+  };
+
+  NameIndexView(const Path& indexFile);
+  bool good() const;
+  std::string error() const;
+
+  Path root() const;
+  uint32_t dirCount() const;
+  uint32_t fileCount() const;
+  Dir dir(DirId id) const;
+  std::string dirName(DirId id) const;
+  Path dirPath(DirId id) const;
+  DirId findDir(const Path& path) const;
+  uint64_t fileSize(FileId id) const;
+  uint64_t fileTime(FileId id) const;
+  const NameIndex::Hosts& hosts() const;
+
+  void scan(DirId dir, bool recurse, const NameMatcher& matcher, Visitor visit) const;
+  void scan(DirId dir, bool recurse, const NameMatcher& matcher, uint64_t from, uint64_t to, Visitor visit) const;
+  std::vector<DirId> matchDirs(DirId dir, bool recurse, const std::string& regex) const;
+  bool hasTrigrams() const;
+  bool hasSuffixArray() const;
+  size_t countSubstring(const std::string& fragment) const;
+  TrigramQuery::Ids filesWith(const std::string& fragment) const;
+
+  bool hasFacets() const;
+  Roaring facetFiles(DirId dir, bool recurse, const NameMatcher& matcher, uint64_t from, uint64_t to) const;
+  std::vector<Count> extCounts(const Roaring& files) const;
+  std::vector<std::pair<DirId, uint64_t>> dirCounts(DirId dir, const Roaring& files) const;
+private:
+  struct Section
+  {
+    const char* data = nullptr;
+    uint64_t size = 0;
+  };
+  using Hit = std::pair<FileId, std::string>;
+  using Range = std::pair<uint32_t, uint32_t>;   // [first, last) of dirs or files
+  struct Needs
+  {
+    std::vector<uint64_t> exts;                    // any one, if not empty
+    std::vector<std::vector<uint64_t>> branches;   // all of any one, if not empty
+  };
+  bool section(uint32_t tag, Section& sec, bool required);
+  bool trigramSection(Section& sec);
+  TrigramQuery::Ids postings(const Section& sec, TrigramQuery::Trigram tg) const;
+  std::vector<Range> subtrees(const TrigramQuery::Ids& dirs) const;
+  bool suffixSection();
+  Range suffixRange(std::string fragment) const;
+  bool fragmentIds(const NameMatcher& matcher, TrigramQuery::Ids& ids) const;
+  bool literalIds(const NameMatcher& matcher, TrigramQuery::Ids& ids) const;
+  bool facetSection();
+  bool hostSection(const Section& sec);
+  Roaring facet(uint64_t offset) const;
+  bool extFiles(const NameMatcher& matcher, Roaring& files) const;
+  Roaring timeFiles(uint64_t from, uint64_t to, const Roaring& within) const;
+  FileId fileEnd(DirId d, bool recurse) const;
+  void visitHits(DirId d, DirId endDir, const std::vector<std::vector<Hit>>& hits, Visitor visit) const;
+  void decodeBlock(uint32_t block, std::string& names, std::vector<size_t>& starts) const;
+  void match(FileId first, FileId last, const NameMatcher& matcher, std::vector<Hit>& hits) const;
+  Needs needs(const NameMatcher& matcher) const;
+  bool mayContain(DirId d, const Needs& needs) const;
+  std::vector<Range> fileRanges(DirId d, bool recurse, const NameMatcher& matcher) const;
+  bool candidates(const std::vector<Range>& ranges, const NameMatcher& matcher, TrigramQuery::Ids& ids) const;
+  void matchIds(const TrigramQuery::Ids& ids, const NameMatcher& matcher, std::vector<Hit>& hits) const;
+
+  FileSystem::MappedFile map_;
+  Path root_;
+  uint32_t dirCount_ = 0;
+  uint32_t fileCount_ = 0;
+  Section dirs_, dirNames_, blocks_, names_, attribs_;
+  Section fileTrigrams_, dirTrigrams_;   // absent in indexes saved by Ver 1.1
+  Section blooms_;                       // absent in indexes saved by Ver 1.2
+  Section suffixes_;                     // optional
+  const char* text_ = nullptr;           // suffix array's lower cased names
+  const char* textStarts_ = nullptr;     // u32 offset of each name in text_
+  const char* suffixArray_ = nullptr;    // u32 text offsets, sorted by suffix
+  uint64_t textSize_ = 0;
+  uint64_t suffixCount_ = 0;
+  Section facets_;                       // absent in indexes saved by Ver 1.4
+  const char* facetBitmaps_ = nullptr;   // offsets below are from here
+  std::vector<std::pair<std::string, uint64_t>> extFacets_;   // sorted by extension
+  std::vector<std::pair<uint32_t, uint64_t>> dayFacets_;      // sorted by day
+  NameIndex::Hosts hosts_;               // empty unless merged
+  std::string error_;
+};
+
+inline bool NameIndexView::good() const
+{
+  return error_.size() == 0;
+}
+
+inline std::string NameIndexView::error() const
+{
+  return error_;
+}
+
+inline NameIndexView::Path NameIndexView::root() const
+{
+  return root_;
+}
+
+inline const NameIndex::Hosts& NameIndexView::hosts() const
+{
+  return hosts_;
+}
+
+inline uint32_t NameIndexView::dirCount() const
+{
+  return dirCount_;
+}
+
+inline uint32_t NameIndexView::fileCount() const
+{
+  return fileCount_;
+}
+
+inline bool NameIndexView::hasTrigrams() const
+{
+  return fileTrigrams_.data != nullptr && dirTrigrams_.data != nullptr;
+}
+
+inline bool NameIndexView::hasSuffixArray() const
+{
+  return suffixArray_ != nullptr;
+}
+
+inline bool NameIndexView::hasFacets() const
+{
+  return facetBitmaps_ != nullptr;
+}
+
+#endif
@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////
+// NameMatch.cpp - match file names against /p patterns and /R regex //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "NameMatch.h"
+#include "Trigram.h"
+#include <cstring>
+#include <cctype>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define NAMEMATCH_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+  char lower(char c)
+  {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  //----< index of lowest set bit, mask is not zero >----------------
+
+  unsigned lowBit(unsigned mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+  }
+}
+//----< compile regex and find literal for prefiltering >------------
+
+NameMatcher::NameMatcher(const Patterns& patterns, const std::string& regex)
+{
+  for (auto patt : patterns)
+  {
+    if (patt == "*.*" || patt == "*")
+      continue;   // matches every name, as with FindFirstFile
+    patterns_.push_back(patt);
+  }
+  anyPattern_ = patterns_.size() < patterns.size() || patterns.size() == 0;
+  if (anyPattern_)
+    patterns_.clear();
+
+  source_ = regex;
+  anyName_ = (regex == "" || regex == ".*");
+  if (anyName_)
+    return;
+  regex_ = std::regex(regex);
+  for (auto run : TrigramQuery::literals(regex))
+  {
+    if (run.size() > literal_.size())
+      literal_ = run;
+  }
+}
+//----< does name match any /p pattern? >----------------------------
+
+bool NameMatcher::matchesPattern(const char* name, size_t len) const
+{
+  if (anyPattern_)
+    return true;
+  for (auto& patt : patterns_)
+  {
+    if (wildcard(patt, name, len))
+      return true;
+  }
+  return false;
+}
+//----< does name match /R regex? >----------------------------------
+
+bool NameMatcher::matchesRegex(const char* name, size_t len) const
+{
+  return anyName_ || std::regex_search(name, name + len, regex_);
+}
+//----< case insensitive match with * and ? wildcards >--------------
+/*
+ *  Greedy match that backtracks only to the most recent *, which is
+ *  enough for wildcards and is linear for typical patterns.
+ */
+bool NameMatcher::wildcard(const std::string& pattern, const char* name, size_t len)
+{
+  size_t p = 0, n = 0;
+  size_t star = std::string::npos, mark = 0;
+  while (n < len)
+  {
+    if (p < pattern.size() && (pattern[p] == '?' || lower(pattern[p]) == lower(name[n])))
+    {
+      ++p;
+      ++n;
+    }
+    else if (p < pattern.size() && pattern[p] == '*')
+    {
+      star = p++;
+      mark = n;
+    }
+    else if (star != std::string::npos)
+    {
+      p = star + 1;
+      n = ++mark;
+    }
+    else
+      return false;
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+//----< first occurrence of literal in [beg, end), or end >----------
+/*
+ *  SSE2 version compares the literal's first and last characters
+ *  against 16 positions at once, and checks the middle only where
+ *  both agree.  Short tails, and builds without SSE2, use memchr.
+ */
+const char* NameMatcher::findLiteral(const char* beg, const char* end, const std::string& literal)
+{
+  size_t k = literal.size();
+  if (k == 0)
+    return beg;
+  if (static_cast<size_t>(end - beg) < k)
+    return end;
+  const char* p = beg;
+#ifdef NAMEMATCH_SSE2
+  const __m128i first = _mm_set1_epi8(literal[0]);
+  const __m128i last = _mm_set1_epi8(literal[k - 1]);
+  for (; p + k - 1 + 16 <= end; p += 16)
+  {
+    __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k - 1));
+    __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+    while (mask != 0)
+    {
+      unsigned bit = lowBit(mask);
+      if (k <= 2 || std::memcmp(p + bit + 1, literal.data() + 1, k - 2) == 0)
+        return p + bit;
+      mask &= mask - 1;
+    }
+  }
+#endif
+  const char* stop = end - k + 1;
+  while (p < stop)
+  {
+    p = static_cast<const char*>(std::memchr(p, literal[0], stop - p));
+    if (p == nullptr)
+      return end;
+    if (std::memcmp(p, literal.data(), k) == 0)
+      return p;
+    ++p;
+  }
+  return end;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_NAMEMATCH
+
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Testing NameMatcher";
+  std::cout << "\n =====================";
+
+  std::vector<std::string> names = {
+    "FileSystem.h", "FileSystem.cpp", "FindFileMgr.CPP", "Trigram.h", "readme.md", "NameMatch.cpp"
+  };
+  NameMatcher nm({ "*.h", "*.cpp" }, "^File|Match\\.");
+  std::cout << "\n  /p *.h,*.cpp /R \"^File|Match\\.\"";
+  for (auto name : names)
+    std::cout << "\n    " << (nm.matches(name.data(), name.size()) ? "match    " : "no match ") << name;
+
+  NameMatcher lit({ "*.*" }, "Sys(tem)?.*\\.cpp$");
+  std::cout << "\n\n  literal of \"Sys(tem)?.*\\.cpp$\" is \"" << lit.literal() << "\"";
+
+  std::string text = "FileSystem.h\nFileSystem.cpp\nFindFileMgr.cpp\nTrigram.h\nNameMatch.cpp\n";
+  for (auto word : { std::string("Mgr.cpp"), std::string("Match"), std::string("absent") })
+  {
+    const char* hit = NameMatcher::findLiteral(text.data(), text.data() + text.size(), word);
+    std::cout << "\n  findLiteral(\"" << word << "\") at " << (hit - text.data());
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,102 @@
+#ifndef NAMEMATCH_H
+#define NAMEMATCH_H
+///////////////////////////////////////////////////////////////////////
+// NameMatch.h - match file names against /p patterns and /R regex   //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * When names come from an index, not from FindFirstFile, FindFiles has
+ * to apply /p patterns itself.  NameMatcher does that, with the same
+ * case insensitive * and ? wildcards, then applies the /R regex.
+ *
+ * Regex matching is the expensive step, so NameMatcher also extracts
+ * the longest literal run every match must contain.  Index scans look
+ * for it with findLiteral(...), which compares 16 bytes at a time with
+ * SSE2 where available, and run the regex only on names containing it.
+ *
+ * Public Interface:
+ * -----------------
+ * NameMatcher nm({ "*.h", "*.cpp" }, "^File");
+ * if (nm.matches(name.data(), name.size())) ...
+ * const char* hit = NameMatcher::findLiteral(beg, end, nm.literal());
+ *
+ * Required Files:
+ * ---------------
+ * NameMatch.h, NameMatch.cpp
+ * Trigram.h, Trigram.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.2 : 18 Oct 2026
+ * - added patterns(), for indexes that prune by extension
+ * Ver 1.1 : 18 Oct 2026
+ * - added regex(), so indexes can build trigram queries from it
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <regex>
+
+class NameMatcher
+{
+public:
+  using Pattern = std::string;
+  using Patterns = std::vector<Pattern>;
+
+  NameMatcher(const Patterns& patterns = Patterns(), const std::string& regex = ".*");
+  bool matches(const char* name, size_t len) const;
+  bool matchesPattern(const char* name, size_t len) const;
+  bool matchesRegex(const char* name, size_t len) const;
+  bool matchesAll() const;
+  bool matchesAnyName() const;
+  const Patterns& patterns() const;
+  const std::string& regex() const;
+  const std::string& literal() const;
+
+  static bool wildcard(const std::string& pattern, const char* name, size_t len);
+  static const char* findLiteral(const char* beg, const char* end, const std::string& literal);
+private:
+  Patterns patterns_;
+  std::string source_;
+  std::regex regex_;
+  std::string literal_;
+  bool anyPattern_ = true;
+  bool anyName_ = true;
+};
+
+inline bool NameMatcher::matches(const char* name, size_t len) const
+{
+  return matchesPattern(name, len) && matchesRegex(name, len);
+}
+
+inline bool NameMatcher::matchesAll() const
+{
+  return anyPattern_ && anyName_;
+}
+
+inline bool NameMatcher::matchesAnyName() const
+{
+  return anyName_;
+}
+
+inline const NameMatcher::Patterns& NameMatcher::patterns() const
+{
+  return patterns_;   // empty if any name matches
+}
+
+inline const std::string& NameMatcher::regex() const
+{
+  return source_;
+}
+
+inline const std::string& NameMatcher::literal() const
+{
+  return literal_;
+}
+
+#endif
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////
+// OutputSink.cpp - buffered stdout, written in large blocks         //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "OutputSink.h"
+#include <cstring>
+#include <algorithm>
+
+const size_t OutputSink::DefaultBytes;
+const size_t OutputSink::ConsoleBytes;
+const DWORD OutputSink::FlushMillis;
+const DWORD OutputSink::ConsoleMillis;
+
+//----< buffer bytes for out, or ConsoleBytes if out is a console >--
+
+OutputSink::OutputSink(HANDLE out, size_t bytes) : out_(out)
+{
+  DWORD mode = 0;
+  console_ = ::GetFileType(out) == FILE_TYPE_CHAR && ::GetConsoleMode(out, &mode);
+  buffer_.resize(console_ ? ConsoleBytes : (std::max)(bytes, ConsoleBytes));
+  wait_ = std::chrono::milliseconds(console_ ? ConsoleMillis : FlushMillis);
+  flusher_ = std::thread([this]() { flushLate(); });
+}
+//----< write what's left >------------------------------------------
+
+OutputSink::~OutputSink()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  flusher_.join();
+  write();
+}
+//----< ostream's insertions; short count fails the stream >---------
+
+std::streamsize OutputSink::xsputn(const char* text, std::streamsize count)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return append(text, static_cast<size_t>(count)) ? count : 0;
+}
+
+OutputSink::int_type OutputSink::overflow(int_type ch)
+{
+  if (traits_type::eq_int_type(ch, traits_type::eof()))
+    return traits_type::not_eof(ch);
+  char c = traits_type::to_char_type(ch);
+  std::lock_guard<std::mutex> lock(mtx_);
+  return append(&c, 1) ? ch : traits_type::eof();
+}
+//----< std::flush, and std::endl, write now >-----------------------
+
+int OutputSink::sync()
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return write() ? 0 : -1;
+}
+//----< add text, \n as \r\n unless to a console; caller locks >------
+
+bool OutputSink::append(const char* text, size_t count)
+{
+  if (console_)
+    return appendBytes(text, count);
+  const char* end = text + count;
+  while (text < end)
+  {
+    const char* nl = static_cast<const char*>(std::memchr(text, '\n', end - text));
+    if (nl == nullptr)
+      return appendBytes(text, end - text);
+    if ((nl > text && !appendBytes(text, nl - text)) || !appendBytes("\r\n", 2))
+      return false;
+    text = nl + 1;
+  }
+  return true;
+}
+//----< add bytes, writing the buffer when it fills; caller locks >--
+
+bool OutputSink::appendBytes(const char* text, size_t count)
+{
+  if (broken_ || failed_)
+    return false;
+  if (used_ + count > buffer_.size() && !write())
+    return false;
+  if (count >= buffer_.size())   // too big to buffer, so write it as is
+    return writeOut(text, count);
+  if (used_ == 0)
+  {
+    oldest_ = std::chrono::steady_clock::now();
+    cv_.notify_one();
+  }
+  std::memcpy(buffer_.data() + used_, text, count);
+  used_ += count;
+  return true;
+}
+//----< write buffer to out_, emptying it; caller locks >-----------
+
+bool OutputSink::write()
+{
+  bool ok = writeOut(buffer_.data(), used_);
+  used_ = 0;
+  return ok;
+}
+//----< write all of text to out_ >----------------------------------
+/*
+ *  A pipe's WriteFile may take less than all, so it's called until
+ *  all is written.  A closed pipe fails with ERROR_BROKEN_PIPE, or with
+ *  ERROR_NO_DATA while the pipe is being closed.
+ */
+bool OutputSink::writeOut(const char* text, size_t count)
+{
+  size_t done = 0;
+  while (done < count && !broken_ && !failed_)
+  {
+    DWORD wrote = 0;
+    DWORD chunk = static_cast<DWORD>((std::min)(count - done, size_t(0x40000000)));
+    if (!::WriteFile(out_, text + done, chunk, &wrote, NULL))
+    {
+      DWORD error = ::GetLastError();
+      broken_ = (error == ERROR_BROKEN_PIPE || error == ERROR_NO_DATA);
+      failed_ = !broken_;
+      break;
+    }
+    done += wrote;
+    stats_.bytes += wrote;
+    ++stats_.writes;
+  }
+  return !broken_ && !failed_;
+}
+//----< thread writing output that has waited wait_ >----------------
+
+void OutputSink::flushLate()
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (!stop_)
+  {
+    if (used_ == 0)
+      cv_.wait(lock);
+    else if (cv_.wait_until(lock, oldest_ + wait_) == std::cv_status::timeout && used_ > 0 &&
+      std::chrono::steady_clock::now() >= oldest_ + wait_)
+      write();
+  }
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_OUTPUTSINK
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+  size_t lines = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  std::cerr << "\n  Testing OutputSink";
+  std::cerr << "\n ====================";
+  auto start = std::chrono::steady_clock::now();
+  OutputSink::Stats st;
+  bool broken = false;
+  {
+    OutputSink sink;
+    std::streambuf* saved = std::cout.rdbuf(&sink);
+    for (size_t i = 0; i < lines && std::cout; ++i)
+      std::cout << "\n    C:\\src\\dir" << i % 977 << "\\file" << i << ".cpp";
+    std::cout << "\n" << std::flush;
+    std::cout.rdbuf(saved);
+    st = sink.stats();
+    broken = sink.broken();
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cerr << "\n  wrote " << st.bytes << " bytes in " << st.writes << " writes, in " << secs << " s";
+  if (broken)
+    std::cerr << "\n  stopped: output's reader closed the pipe";
+  std::cerr << "\n\n";
+  return 0;
+}
+#endif
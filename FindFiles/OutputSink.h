@@ -0,0 +1,125 @@
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+///////////////////////////////////////////////////////////////////////
+// OutputSink.h - buffered stdout, written in large blocks           //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * FindFiles shows each path with a few insertions into std::cout, and
+ * when its output goes to a file or pipe, writing millions of lines
+ * that way takes longer than the walk.  OutputSink is a streambuf,
+ * installed as std::cout's, that collects output in one large buffer
+ * and writes it to the output handle with one WriteFile, when the
+ * buffer is full, when it holds output older than FlushMillis, or when
+ * the stream is flushed.  A thread of its own writes output that has
+ * waited FlushMillis, so output of a slow walk isn't held back.
+ *
+ * When output goes to a console, the buffer is ConsoleBytes and output
+ * waits at most ConsoleMillis, so lines appear as they are found.
+ *
+ * WriteFile writes bytes as they are, so the sink does what the CRT's
+ * text mode stdout did: each \n written to a file or pipe is written
+ * as \r\n, so redirected output keeps its CRLF line endings.
+ *
+ * When the output is a pipe whose reader has closed it, e.g., by
+ * "| more" quitting, the next write fails with a broken pipe.  The
+ * sink then drops what it has, and all later output, and fails its
+ * stream, so FileMgr's walk stops instead of running on unseen.
+ *
+ * Public Interface:
+ * -----------------
+ * OutputSink sink;                         // standard output
+ * std::streambuf* saved = std::cout.rdbuf(&sink);
+ * ... std::cout << "\n    " << file; ...
+ * std::cout.flush();
+ * std::cout.rdbuf(saved);
+ * if (sink.broken()) ...                   // reader closed the pipe
+ *
+ * Required Files:
+ * ---------------
+ * OutputSink.h, OutputSink.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - \n is written as \r\n to files and pipes, as by text mode stdout
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <streambuf>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <windows.h>
+
+class OutputSink : public std::streambuf
+{
+public:
+  static const size_t DefaultBytes = 1024 * 1024;
+  static const size_t ConsoleBytes = 4096;
+  static const DWORD FlushMillis = 100;
+  static const DWORD ConsoleMillis = 20;
+
+  struct Stats
+  {
+    size_t bytes = 0;
+    size_t writes = 0;   // calls of WriteFile
+  };
+
+  OutputSink(HANDLE out = ::GetStdHandle(STD_OUTPUT_HANDLE), size_t bytes = DefaultBytes);
+  ~OutputSink();
+  OutputSink(const OutputSink&) = delete;
+  OutputSink& operator=(const OutputSink&) = delete;
+  bool console() const;
+  bool broken() const;
+  Stats stats() const;
+protected:
+  std::streamsize xsputn(const char* text, std::streamsize count) override;
+  int_type overflow(int_type ch) override;
+  int sync() override;
+private:
+  bool append(const char* text, size_t count);
+  bool appendBytes(const char* text, size_t count);
+  bool write();
+  bool writeOut(const char* text, size_t count);
+  void flushLate();
+
+  HANDLE out_;
+  bool console_ = false;
+  std::vector<char> buffer_;
+  size_t used_ = 0;
+  std::chrono::steady_clock::time_point oldest_;   // output in buffer_ since
+  std::chrono::milliseconds wait_;
+  bool broken_ = false;
+  bool failed_ = false;                           // write failed, but not broken
+  bool stop_ = false;
+  Stats stats_;
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  std::thread flusher_;
+};
+
+inline bool OutputSink::console() const
+{
+  return console_;
+}
+
+inline bool OutputSink::broken() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return broken_;
+}
+
+inline OutputSink::Stats OutputSink::stats() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  return stats_;
+}
+
+#endif
@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////////////
+// QueryBatch.cpp - many name queries answered from one tree walk    //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "QueryBatch.h"
+#include "../CppUtilities/CodeUtilities/CodeUtilities.h"
+#include <sstream>
+
+namespace
+{
+  //----< words of line, with "quoted words" kept whole >--------------
+
+  std::vector<std::string> words(const std::string& line)
+  {
+    std::vector<std::string> result;
+    size_t i = 0;
+    while (i < line.size())
+    {
+      if (isspace(static_cast<unsigned char>(line[i])))
+      {
+        ++i;
+        continue;
+      }
+      std::string word;
+      bool quoted = false;
+      for (; i < line.size() && (quoted || !isspace(static_cast<unsigned char>(line[i]))); ++i)
+      {
+        if (line[i] == '"')
+          quoted = !quoted;
+        else
+          word += line[i];
+      }
+      result.push_back(word);
+    }
+    return result;
+  }
+}
+//----< dateOf formats file times shown by queries with /D >---------
+
+QueryBatch::QueryBatch(DateFormat dateOf) : dateOf_(dateOf) {}
+
+//----< read queries and open their output files >--------------------
+
+bool QueryBatch::load(const Path& queriesFile)
+{
+  queries_.clear();
+  std::ifstream in(queriesFile);
+  if (!in.good())
+  {
+    error_ = "can't open " + queriesFile;
+    return false;
+  }
+  Path dir = FileSystem::Path::getPath(queriesFile);
+  std::string stem = FileSystem::Path::getName(queriesFile, false);
+  std::string line;
+  for (size_t lineNo = 1; std::getline(in, line); ++lineNo)
+  {
+    if (line.size() > 0 && line.back() == '\r')
+      line.pop_back();
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || line[first] == '#')
+      continue;
+    Query query;
+    query.line = lineNo;
+    query.text = line.substr(first);
+    if (!parse(query))
+      return false;
+    query.outFile = FileSystem::Path::fileSpec(dir, stem + "." + std::to_string(lineNo) + ".txt");
+    queries_.push_back(std::move(query));
+  }
+  if (queries_.size() == 0)
+  {
+    error_ = queriesFile + " has no queries";
+    return false;
+  }
+  for (auto& query : queries_)   // only when all queries parse
+  {
+    query.out.reset(new std::ofstream(query.outFile));
+    if (!query.out->good())
+    {
+      error_ = "can't write " + query.outFile;
+      return false;
+    }
+    *query.out << "\n  FindFiles " << query.text;
+  }
+  return true;
+}
+//----< options of query's text, parsed as on the command line >-----
+
+bool QueryBatch::parse(Query& query)
+{
+  std::string where = "line " + std::to_string(query.line) + ": ";
+  std::vector<std::string> args = words(query.text);
+  args.insert(args.begin(), "FindFiles");
+  std::vector<char*> argv;
+  for (auto& arg : args)
+  {
+    if (arg.size() > 1 && arg[0] == '/' && (arg.size() > 2 || std::string("pRfdD").find(arg[1]) == std::string::npos))
+    {
+      error_ = where + arg + " is not a query option, use /p, /R, /f, /d, or /D";
+      return false;
+    }
+    argv.push_back(&arg[0]);
+  }
+  std::ostringstream ignored;
+  Utilities::ProcessCmdLine pcl(0, nullptr, ignored);
+  pcl.process(static_cast<int>(argv.size()), argv.data());
+  if (pcl.parseError())
+  {
+    error_ = where + "can't parse " + query.text;
+    return false;
+  }
+  query.criteria.patterns = pcl.patterns();
+  query.criteria.regex = pcl.regex();
+  query.criteria.dirs = pcl.hasOption('d');
+  query.criteria.files = pcl.hasOption('f') || !query.criteria.dirs;
+  query.showDates = pcl.hasOption('D');
+  try
+  {
+    query.regex = std::regex(pcl.regex());
+  }
+  catch (std::regex_error& ex)
+  {
+    error_ = where + "bad regex " + pcl.regex() + ", " + ex.what();
+    return false;
+  }
+  return true;
+}
+//----< evaluate every query against one dir's entries >-------------
+
+void QueryBatch::visit(FindEngine::Visit& visit)
+{
+  for (auto& query : queries_)
+    evaluate(query, visit);
+}
+//----< write query's matches in dir, as find shows them with /H >---
+
+void QueryBatch::evaluate(Query& query, FindEngine::Visit& visit)
+{
+  FindEngine::match(query.criteria, query.regex, visit);
+  std::ostream& out = *query.out;
+  if (visit.matched || visit.files.size() > 0)
+    out << "\n  " << visit.dir;   // once, for the dir's match and its files
+  if (visit.matched)
+    ++query.dirs;
+  for (auto& found : visit.files)
+  {
+    const FileSystem::Directory::Entry& entry = visit.entries[found.entry];
+    if (query.showDates)
+      out << "\n    " << dateOf_(entry.time) << " -- " << entry.name;
+    else
+      out << "\n    " << entry.name;
+    ++query.files;
+  }
+}
+//----< finish output files, false if any couldn't be written >------
+
+bool QueryBatch::close()
+{
+  bool ok = true;
+  for (auto& query : queries_)
+  {
+    *query.out << "\n\n    Found " << query.files << " files, " << query.dirs << " dirs\n";
+    query.out->close();
+    if (query.out->fail())
+    {
+      error_ = "can't write " + query.outFile;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_QUERYBATCH
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing QueryBatch";
+  std::cout << "\n ====================";
+
+  std::string dir = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : ".");
+  std::string queriesFile = FileSystem::Path::fileSpec(dir, "batch.txt");
+  {
+    std::ofstream queries(queriesFile);
+    queries << "# test queries\n/p *.h /R ^File\n/p *.cpp,*.h /D\n/d /R \"Find\"\n";
+  }
+  QueryBatch batch([](unsigned long long time) { return FileSystem::FileInfo::dateOf(time); });
+  if (!batch.load(queriesFile))
+    std::cout << "\n  " << batch.error();
+  FindEngine::Visit visit;
+  visit.dir = dir;
+  visit.entries = FileSystem::Directory::getEntries(dir);
+  batch.visit(visit);
+  batch.close();
+  for (auto& query : batch.queries())
+  {
+    std::cout << "\n  " << query.text << ": " << query.files << " files, " << query.dirs << " dirs";
+    FileSystem::File::remove(query.outFile);
+  }
+  FileSystem::File::remove(queriesFile);
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,101 @@
+#ifndef QUERYBATCH_H
+#define QUERYBATCH_H
+///////////////////////////////////////////////////////////////////////
+// QueryBatch.h - many name queries answered from one tree walk      //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Reports often run dozens of FindFiles queries over the same tree,
+ * and each one walks the whole tree.  With /Q queries.txt, FindFiles
+ * walks the tree once and QueryBatch evaluates every query against
+ * each dir's listing, so the cost of reading dirs doesn't grow with
+ * the number of queries.
+ *
+ * Each line of the queries file is one query, made of the options
+ * /p patterns, /R regex, /f, /d, and /D, with the same meanings as on
+ * the command line.  Blank lines and lines starting with # are skipped.
+ * The results of the query on line n of queries.txt are written to
+ * queries.n.txt, in the queries file's dir, in the form FindFiles
+ * shows them with /H.
+ *
+ * Public Interface:
+ * -----------------
+ * QueryBatch batch(dateOf);   // formats file times for /D
+ * if (batch.load("nightly.txt")) {
+ *   while (walk.next(visit)) batch.visit(visit);   // a FindEngine::Walk
+ *   batch.close();
+ * }
+ * for (auto& query : batch.queries()) ... query.files, query.outFile ...
+ *
+ * Required Files:
+ * ---------------
+ * QueryBatch.h, QueryBatch.cpp
+ * FindEngine.h, FindEngine.cpp, NameMatch.h, NameMatch.cpp, FileSystem.h, FileSystem.cpp
+ * CodeUtilities.h
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - queries are matched by FindEngine::match, against the listings of
+ *   a FindEngine::Walk
+ * - a dir matching a /d query, with matching files, is shown once
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <memory>
+#include <fstream>
+#include <functional>
+#include "FindEngine.h"
+
+class QueryBatch
+{
+public:
+  using Path = std::string;
+  using DateFormat = std::function<std::string(unsigned long long time)>;
+
+  struct Query
+  {
+    size_t line = 0;            // in queries file, from 1
+    std::string text;
+    FindEngine::Query criteria; // patterns, regex, files, and dirs
+    std::regex regex;
+    bool showDates = false;
+    Path outFile;
+    std::unique_ptr<std::ofstream> out;
+    size_t files = 0;           // matches found
+    size_t dirs = 0;
+  };
+
+  QueryBatch(DateFormat dateOf);
+  bool load(const Path& queriesFile);
+  void visit(FindEngine::Visit& visit);
+  bool close();
+  const std::vector<Query>& queries() const;
+  std::string error() const;
+private:
+  bool parse(Query& query);
+  void evaluate(Query& query, FindEngine::Visit& visit);
+
+  DateFormat dateOf_;
+  std::vector<Query> queries_;
+  std::string error_;
+};
+
+inline const std::vector<QueryBatch::Query>& QueryBatch::queries() const
+{
+  return queries_;
+}
+
+inline std::string QueryBatch::error() const
+{
+  return error_;
+}
+
+#endif
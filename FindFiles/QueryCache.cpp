@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////
+// QueryCache.cpp - results of a repeated query, kept per directory  //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Cache file layout, all integers little-endian:
+ *   header  : magic "FFQC", version, varint length and query
+ *   entries : dir count, then per dir - varint length and lower cased
+ *             path, u64 last write time, varint count and names of
+ *             files, varint count and names of subdirs
+ */
+
+#include "QueryCache.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+#include <windows.h>
+
+namespace
+{
+  const uint32_t Magic = 0x43514646;   // "FFQC"
+  const uint32_t Version = 2;   // 1 kept only matching files
+
+  void writeNames(BinaryIO::Writer& wr, const QueryCache::Names& names)
+  {
+    wr.varint(names.size());
+    for (auto& name : names)
+      wr.str(name);
+  }
+
+  bool readNames(BinaryIO::Reader& rd, QueryCache::Names& names)
+  {
+    uint64_t count = rd.varint();
+    for (uint64_t i = 0; i < count && rd.good(); ++i)
+      names.push_back(rd.str());
+    return rd.good();
+  }
+}
+const uint64_t QueryCache::RacyTicks;
+
+//----< cache of query, kept in a file of cacheDir named by its hash >
+
+QueryCache::QueryCache(const Path& cacheDir, const std::string& query)
+  : query_(query), file_(FileSystem::Path::fileSpec(cacheDir, "FindFiles-" + BinaryIO::hexHash(query) + ".qcache")),
+    started_(FileSystem::FileInfo::now()) {}
+
+//----< FindFiles dir in the user's temp dir >------------------------
+
+QueryCache::Path QueryCache::defaultDir()
+{
+  char buffer[MAX_PATH + 1];
+  DWORD size = ::GetTempPathA(MAX_PATH + 1, buffer);
+  Path temp = (size > 0 && size <= MAX_PATH) ? Path(buffer, size) : ".";
+  return FileSystem::Path::fileSpec(temp, "FindFiles");
+}
+//----< read entries saved by last run of query >---------------------
+/*
+ *  Returns false if there is no cache yet.  A file for another query
+ *  with the same hash is treated as no cache.
+ */
+bool QueryCache::load()
+{
+  loaded_.clear();
+  std::string buffer;
+  if (!FileSystem::File::exists(file_) || !BinaryIO::readFile(file_, buffer))
+    return false;
+  BinaryIO::Reader rd(buffer);
+  if (rd.u32() != Magic || rd.u32() != Version || rd.str() != query_)
+    return false;
+  uint32_t count = rd.u32();
+  for (uint32_t i = 0; i < count && rd.good(); ++i)
+  {
+    Path dir = rd.str();
+    Entry& entry = loaded_[dir];
+    entry.time = rd.u64();
+    if (!readNames(rd, entry.files) || !readNames(rd, entry.subdirs))
+      break;
+  }
+  if (!rd.good())
+  {
+    loaded_.clear();
+    error_ = file_ + " is damaged, ignoring it";
+    return false;
+  }
+  return true;
+}
+//----< cached lists of dir, if its last write time hasn't changed >--
+
+bool QueryCache::lookup(const Path& dir, uint64_t time, Names& files, Names& subdirs)
+{
+  Path key = FileSystem::Path::toLower(dir);
+  auto iter = loaded_.find(key);
+  if (time == 0 || iter == loaded_.end() || iter->second.time != time)
+    return false;
+  files = iter->second.files;
+  subdirs = iter->second.subdirs;
+  visited_[key] = std::move(iter->second);
+  loaded_.erase(iter);
+  ++stats_.dirs;
+  ++stats_.reused;
+  return true;
+}
+//----< record lists of dir, just enumerated >-----------------------
+
+void QueryCache::store(const Path& dir, uint64_t time, const Names& files, const Names& subdirs)
+{
+  Entry& entry = visited_[FileSystem::Path::toLower(dir)];
+  entry.time = (time + RacyTicks >= started_) ? 0 : time;
+  entry.files = files;
+  entry.subdirs = subdirs;
+  ++stats_.dirs;
+}
+//----< write dirs visited this run, replacing the old cache >-------
+
+bool QueryCache::save()
+{
+  std::string buffer;
+  BinaryIO::Writer wr(buffer);
+  wr.u32(Magic);
+  wr.u32(Version);
+  wr.str(query_);
+  wr.u32(static_cast<uint32_t>(visited_.size()));
+  for (auto& item : visited_)
+  {
+    wr.str(item.first);
+    wr.u64(item.second.time);
+    writeNames(wr, item.second.files);
+    writeNames(wr, item.second.subdirs);
+  }
+  Path dir = FileSystem::Path::getPath(file_);
+  if (!FileSystem::Directory::exists(dir))
+    FileSystem::Directory::create(dir);
+  if (!BinaryIO::writeFile(file_, buffer))
+  {
+    error_ = "can't write " + file_;
+    return false;
+  }
+  stats_.bytes = buffer.size();
+  return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_QUERYCACHE
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing QueryCache";
+  std::cout << "\n ====================";
+
+  std::string root = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : ".");
+  std::string query = FileSystem::Path::toLower(root) + "\n*.h\n.*";
+  for (int run = 1; run <= 2; ++run)
+  {
+    QueryCache cache(QueryCache::defaultDir(), query);
+    cache.load();
+    QueryCache::Names files, subdirs;
+    uint64_t time = FileSystem::FileInfo(root).time() - 2 * QueryCache::RacyTicks;   // as if listed long ago
+    if (!cache.lookup(root, time, files, subdirs))
+    {
+      files = FileSystem::Directory::getFiles(root, "*.h");
+      cache.store(root, time, files, subdirs);
+    }
+    cache.save();
+    std::cout << "\n  run " << run << ": " << files.size() << " files, reused " << cache.stats().reused << " of " << cache.stats().dirs << " dirs";
+    if (run == 2)
+      FileSystem::File::remove(cache.file());
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
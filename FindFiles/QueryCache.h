@@ -0,0 +1,115 @@
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+///////////////////////////////////////////////////////////////////////
+// QueryCache.h - results of a repeated query, kept per directory    //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * CI jobs often run the same FindFiles query minutes apart.  QueryCache
+ * keeps, on disk, what the last run of a query found in each dir it
+ * visited: the names of its files and subdirs, and the dir's last
+ * write time.  Adding, removing, or renaming an entry changes a
+ * dir's last write time, so on the next run a dir with the same time
+ * is not enumerated; its cached lists are used instead.  Only changed
+ * dirs are read again, so a repeat run costs one attribute read per
+ * dir instead of a full enumeration.
+ *
+ * Each distinct query, its normalized path, patterns, regex, and the
+ * options that change what is listed, has its own cache file in the
+ * cache dir, named by a hash of the query.
+ *
+ * A dir written to within RacyTicks of the start of the run that
+ * listed it is cached as changed.  Its time might not move again if it
+ * changes later in the same tick, e.g., on volumes with coarse times.
+ *
+ * Public Interface:
+ * -----------------
+ * QueryCache cache(QueryCache::defaultDir(), query);
+ * cache.load();
+ * if (!cache.lookup(dir, time, files, subdirs)) {
+ *   ... enumerate dir ...
+ *   cache.store(dir, time, files, subdirs);
+ * }
+ * cache.save();   // keeps only dirs looked up or stored
+ *
+ * Required Files:
+ * ---------------
+ * QueryCache.h, QueryCache.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - keeps all of a dir's names, which FindEngine matches, instead of
+ *   the names FileMgr had matched
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+class QueryCache
+{
+public:
+  using Path = std::string;
+  using Names = std::vector<std::string>;
+  static const uint64_t RacyTicks = 20000000;   // 2 sec, FAT time resolution
+
+  struct Stats
+  {
+    size_t dirs = 0;     // looked up or stored this run
+    size_t reused = 0;   // unchanged, not enumerated
+    size_t bytes = 0;    // size of saved cache
+  };
+
+  QueryCache(const Path& cacheDir, const std::string& query);
+  static Path defaultDir();
+
+  bool load();
+  bool lookup(const Path& dir, uint64_t time, Names& files, Names& subdirs);
+  void store(const Path& dir, uint64_t time, const Names& files, const Names& subdirs);
+  bool save();
+
+  Path file();
+  Stats stats();
+  std::string error();
+private:
+  struct Entry
+  {
+    uint64_t time = 0;   // 0 if listed too soon after a change
+    Names files;
+    Names subdirs;
+  };
+  using Entries = std::unordered_map<Path, Entry>;   // by lower cased path
+
+  std::string query_;
+  Path file_;
+  uint64_t started_;
+  Entries loaded_;
+  Entries visited_;
+  Stats stats_;
+  std::string error_;
+};
+
+inline QueryCache::Path QueryCache::file()
+{
+  return file_;
+}
+
+inline QueryCache::Stats QueryCache::stats()
+{
+  return stats_;
+}
+
+inline std::string QueryCache::error()
+{
+  return error_;
+}
+
+#endif
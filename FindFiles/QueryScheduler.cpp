@@ -0,0 +1,234 @@
+///////////////////////////////////////////////////////////////////////
+// QueryScheduler.cpp - time slices queries of a server by priority  //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "QueryScheduler.h"
+#include <algorithm>
+
+namespace
+{
+  const auto PausedPoll = std::chrono::milliseconds(5);   // recheck jobs waiting for readers
+
+  double millisBetween(QueryScheduler::Clock::time_point from, QueryScheduler::Clock::time_point to)
+  {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+  }
+}
+const size_t QueryScheduler::Classes;
+const size_t QueryScheduler::RecentWaits;
+
+QueryScheduler::QueryScheduler() {}
+
+QueryScheduler::QueryScheduler(const Limits& limits) : limits_(limits) {}
+
+std::string QueryScheduler::name(Class cls)
+{
+  return cls == Interactive ? "interactive" : "batch";
+}
+//----< queue job; it runs when its class has room >-----------------
+
+void QueryScheduler::submit(std::shared_ptr<Job> job, Class cls)
+{
+  std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+  entry->job = job;
+  entry->cls = cls;
+  entry->submitted = Clock::now();
+  std::lock_guard<std::mutex> guard(lock_);
+  waiting_[cls].push_back(entry);
+  ready_.notify_one();
+}
+//----< run slices of jobs until shutdown >--------------------------
+
+void QueryScheduler::run()
+{
+  for (;;)
+  {
+    std::shared_ptr<Entry> entry = next();
+    if (!entry)
+      return;
+    slice(*entry);
+    if (!entry->job)
+      retire(entry);
+    else
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      running_[entry->cls].push_back(entry);
+    }
+  }
+}
+//----< stop run(), leaving jobs not yet done >----------------------
+
+void QueryScheduler::shutdown()
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  stopping_ = true;
+  ready_.notify_all();
+}
+//----< job to run next, waiting for one; null at shutdown >---------
+/*
+ *  Waiting jobs are started while their class has room.  Of the ready
+ *  jobs, an interactive one runs unless interactiveSlices have run
+ *  since a batch job last did.  Within a class, jobs take turns.
+ */
+std::shared_ptr<QueryScheduler::Entry> QueryScheduler::next()
+{
+  std::unique_lock<std::mutex> guard(lock_);
+  for (;;)
+  {
+    if (stopping_)
+      return nullptr;
+    for (size_t cls = 0; cls < Classes; ++cls)
+    {
+      while (waiting_[cls].size() > 0 && running_[cls].size() < limits_.running[cls])
+      {
+        running_[cls].push_back(waiting_[cls].front());
+        waiting_[cls].pop_front();
+      }
+    }
+    auto isReady = [this](const std::shared_ptr<Entry>& entry) { return entry->job->unsent() <= limits_.unsent; };
+    Entries::iterator ready[Classes];
+    for (size_t cls = 0; cls < Classes; ++cls)
+      ready[cls] = std::find_if(running_[cls].begin(), running_[cls].end(), isReady);
+    bool interactive = ready[Interactive] != running_[Interactive].end();
+    bool batch = ready[Batch] != running_[Batch].end();
+    if (interactive || batch)
+    {
+      Class cls = (interactive && (!batch || interactiveRun_ < limits_.interactiveSlices)) ? Interactive : Batch;
+      interactiveRun_ = (cls == Interactive) ? interactiveRun_ + 1 : 0;
+      std::shared_ptr<Entry> entry = *ready[cls];
+      running_[cls].erase(ready[cls]);
+      return entry;
+    }
+    if (running_[Interactive].size() > 0 || running_[Batch].size() > 0)
+      ready_.wait_for(guard, PausedPoll);
+    else
+      ready_.wait(guard);
+  }
+}
+//----< run steps of entry's job for one slice >---------------------
+/*
+ *  The slice ends early if the job finishes, gets ahead of its reader,
+ *  or holds too much memory, which stops it.  A finished job's entry
+ *  is left without its job.
+ */
+void QueryScheduler::slice(Entry& entry)
+{
+  Clock::time_point start = Clock::now();
+  if (!entry.started)
+  {
+    entry.started = true;
+    entry.times.waitMillis = millisBetween(entry.submitted, start);
+  }
+  Clock::time_point deadline = start + std::chrono::microseconds(limits_.sliceMicros[entry.cls]);
+  bool more = true;
+  do
+  {
+    more = entry.job->step();
+    ++entry.times.steps;
+  } while (more && Clock::now() < deadline && entry.job->unsent() <= limits_.unsent &&
+           entry.job->memory() <= limits_.memory);
+
+  ++entry.times.slices;
+  entry.times.runMillis += millisBetween(start, Clock::now());
+  if (more && entry.job->memory() > limits_.memory)
+    entry.times.stopped = "holds more than " + std::to_string(limits_.memory / (1024 * 1024)) + " MB";
+  if (!more || entry.times.stopped.size() > 0)
+  {
+    entry.job->done(entry.times);
+    entry.job.reset();
+  }
+}
+//----< record wait of a job that has finished >---------------------
+
+void QueryScheduler::retire(std::shared_ptr<Entry> entry)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  Class cls = entry->cls;
+  double wait = entry->times.waitMillis;
+  ++done_[cls];
+  totalWait_[cls] += wait;
+  maxWait_[cls] = (std::max)(maxWait_[cls], wait);
+  std::vector<double>& recent = recentWaits_[cls];
+  if (recent.size() < RecentWaits)
+    recent.push_back(wait);
+  else
+    recent[done_[cls] % RecentWaits] = wait;
+}
+//----< queue waits and counts of cls's jobs >-----------------------
+
+QueryScheduler::Stats QueryScheduler::stats(Class cls) const
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  Stats st;
+  st.done = done_[cls];
+  st.waiting = waiting_[cls].size();
+  st.running = running_[cls].size();
+  st.maxWaitMillis = maxWait_[cls];
+  if (st.done > 0)
+    st.meanWaitMillis = totalWait_[cls] / st.done;
+  std::vector<double> waits = recentWaits_[cls];
+  if (waits.size() > 0)
+  {
+    size_t rank = (waits.size() * 99) / 100;
+    std::nth_element(waits.begin(), waits.begin() + rank, waits.end());
+    st.p99WaitMillis = waits[rank];
+  }
+  return st;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_QUERYSCHEDULER
+
+#include <iostream>
+#include <thread>
+
+class CountJob : public QueryScheduler::Job
+{
+public:
+  CountJob(const std::string& name, size_t steps) : name_(name), left_(steps) {}
+  bool step() override
+  {
+    volatile size_t work = 0;
+    for (size_t i = 0; i < 20000; ++i)
+      work += i;
+    return --left_ > 0;
+  }
+  size_t memory() const override { return 0; }
+  void done(const QueryScheduler::Times& times) override
+  {
+    std::cout << "\n  " << name_ << ": waited " << times.waitMillis << " ms, ran " << times.runMillis
+      << " ms in " << times.slices << " slices";
+  }
+private:
+  std::string name_;
+  size_t left_;
+};
+
+int main()
+{
+  std::cout << "\n  Testing QueryScheduler";
+  std::cout << "\n ========================";
+
+  QueryScheduler scheduler;
+  std::thread clients([&]() {
+    scheduler.submit(std::make_shared<CountJob>("batch", 20000), QueryScheduler::Batch);
+    for (int i = 0; i < 5; ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      scheduler.submit(std::make_shared<CountJob>("interactive " + std::to_string(i), 20), QueryScheduler::Interactive);
+    }
+    while (scheduler.stats(QueryScheduler::Batch).done == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    scheduler.shutdown();
+  });
+  scheduler.run();
+  clients.join();
+  QueryScheduler::Stats st = scheduler.stats(QueryScheduler::Interactive);
+  std::cout << "\n  interactive p99 wait " << st.p99WaitMillis << " ms";
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
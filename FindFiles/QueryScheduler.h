@@ -0,0 +1,147 @@
+#ifndef QUERYSCHEDULER_H
+#define QUERYSCHEDULER_H
+///////////////////////////////////////////////////////////////////////
+// QueryScheduler.h - time slices queries of a server by priority    //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * A FindFiles server answers editors, which want results in a few
+ * milliseconds, and report jobs, whose walks take minutes.  Run one at
+ * a time, a long walk would hold up every editor query behind it.
+ *
+ * QueryScheduler runs jobs that do their work in small steps, e.g.,
+ * one dir of a walk, and gives each a time slice in turn.  Jobs are in
+ * one of two classes.  Interactive jobs get short slices and go first;
+ * batch jobs get longer slices, one after every few interactive ones,
+ * so they progress but never wait long behind each other.
+ *
+ * Limits:
+ * - Each class has a number of jobs that may run at once.  Others wait
+ *   in their class's queue, in order of arrival, and the time from
+ *   submit to first step is reported as the job's queue wait.
+ * - A job whose consumer hasn't taken its output, beyond a limit, is
+ *   passed over until it has, so slow readers don't grow the server.
+ * - A job holding more than a memory limit, e.g., a huge frontier of
+ *   dirs to visit, is stopped.
+ *
+ * Jobs run on the thread that calls run(), one at a time, so they need
+ * not be thread safe, and may share caches.  submit(...) may be called
+ * from any thread.
+ *
+ * Public Interface:
+ * -----------------
+ * QueryScheduler scheduler;
+ * std::thread([&]() { ... scheduler.submit(job, QueryScheduler::Batch); ... }).detach();
+ * scheduler.run();   // until scheduler.shutdown()
+ * QueryScheduler::Stats st = scheduler.stats(QueryScheduler::Interactive);
+ *
+ * Required Files:
+ * ---------------
+ * QueryScheduler.h, QueryScheduler.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+class QueryScheduler
+{
+public:
+  enum Class { Interactive, Batch };
+  static const size_t Classes = 2;
+  using Clock = std::chrono::steady_clock;
+
+  struct Limits
+  {
+    size_t running[Classes] = { 8, 2 };             // jobs run at once, others wait
+    unsigned sliceMicros[Classes] = { 2000, 5000 };  // batch slices bound interactive waits
+    unsigned interactiveSlices = 4;                 // per batch slice, when both are ready
+    size_t memory = 64 * 1024 * 1024;               // bytes a job may hold
+    size_t unsent = 4 * 1024 * 1024;                // bytes of output waiting for its reader
+  };
+
+  struct Times
+  {
+    double waitMillis = 0;   // submit to first step
+    double runMillis = 0;
+    size_t slices = 0;
+    size_t steps = 0;
+    std::string stopped;     // why the job was stopped, if it was
+  };
+
+  struct Stats
+  {
+    size_t done = 0;
+    size_t waiting = 0;
+    size_t running = 0;
+    double meanWaitMillis = 0;
+    double p99WaitMillis = 0;   // of the last RecentWaits jobs
+    double maxWaitMillis = 0;
+  };
+
+  /////////////////////////////////////////////////////////////////////
+  // Job interface
+  // - work done in steps, each short compared to a slice
+
+  class Job
+  {
+  public:
+    virtual ~Job() {}
+    virtual bool step() = 0;                     // false when done
+    virtual size_t memory() const = 0;           // bytes held now
+    virtual size_t unsent() const { return 0; }  // output its reader hasn't taken
+    virtual void done(const Times& times) = 0;   // last call, after last step or stop
+  };
+
+  static const size_t RecentWaits = 1000;
+
+  QueryScheduler();
+  QueryScheduler(const Limits& limits);
+  QueryScheduler(const QueryScheduler&) = delete;
+  QueryScheduler& operator=(const QueryScheduler&) = delete;
+  void submit(std::shared_ptr<Job> job, Class cls);
+  void run();
+  void shutdown();
+  Stats stats(Class cls) const;
+  static std::string name(Class cls);
+private:
+  struct Entry
+  {
+    std::shared_ptr<Job> job;
+    Class cls;
+    Clock::time_point submitted;
+    Times times;
+    bool started = false;
+  };
+  using Entries = std::deque<std::shared_ptr<Entry>>;
+
+  std::shared_ptr<Entry> next();
+  void slice(Entry& entry);
+  void retire(std::shared_ptr<Entry> entry);
+
+  Limits limits_;
+  mutable std::mutex lock_;
+  std::condition_variable ready_;
+  Entries waiting_[Classes];
+  Entries running_[Classes];
+  unsigned interactiveRun_ = 0;   // interactive slices since last batch slice
+  bool stopping_ = false;
+  size_t done_[Classes] = { 0, 0 };
+  double totalWait_[Classes] = { 0, 0 };
+  double maxWait_[Classes] = { 0, 0 };
+  std::vector<double> recentWaits_[Classes];
+};
+
+#endif
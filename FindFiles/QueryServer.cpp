@@ -0,0 +1,502 @@
+///////////////////////////////////////////////////////////////////////
+// QueryServer.cpp - answer FindFiles queries from a resident process//
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Request layout, all integers little-endian:
+ *   u32 size of the rest, varint length and client's current dir,
+ *   varint arg count, then each arg, varint length and bytes
+ * The response is the handler's output, until the server closes the
+ * pipe.
+ */
+
+#include "QueryServer.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+#include <windows.h>
+#include <sddl.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+namespace
+{
+  const DWORD BufferSize = 64 * 1024;
+  const uint32_t MaxRequest = 1024 * 1024;
+  const int ConnectAttempts = 10;
+  const DWORD RetryMillis = 20;
+  const size_t MaxReading = 64;   // clients connected, request not yet read
+
+  //----< read exactly size bytes, false if pipe closes first >-------
+
+  bool readAll(HANDLE hPipe, char* buffer, size_t size)
+  {
+    while (size > 0)
+    {
+      DWORD got = 0;
+      if (!::ReadFile(hPipe, buffer, static_cast<DWORD>(size), &got, NULL) || got == 0)
+        return false;
+      buffer += got;
+      size -= got;
+    }
+    return true;
+  }
+
+  bool writeAll(HANDLE hPipe, const char* buffer, size_t size)
+  {
+    while (size > 0)
+    {
+      DWORD written = 0;
+      if (!::WriteFile(hPipe, buffer, static_cast<DWORD>(size), &written, NULL))
+        return false;
+      buffer += written;
+      size -= written;
+    }
+    return true;
+  }
+  //----< read a request, false if it's short or malformed >----------
+  /*
+   *  Each arg takes at least its length byte, so a count larger than
+   *  the request is rejected before anything is sized from it.
+   */
+  bool readRequest(HANDLE hPipe, std::string& cwd, QueryServer::Args& args)
+  {
+    char size[4];
+    if (!readAll(hPipe, size, sizeof(size)))
+      return false;
+    uint32_t length = BinaryIO::Reader(size, size + sizeof(size)).u32();
+    if (length == 0 || length > MaxRequest)
+      return false;
+    std::string request(length, '\0');
+    if (!readAll(hPipe, &request[0], request.size()))
+      return false;
+    BinaryIO::Reader rd(request);
+    cwd = rd.str();
+    uint64_t count = rd.varint();
+    if (!rd.good() || count > request.size())
+      return false;
+    args.resize(static_cast<size_t>(count));
+    for (auto& arg : args)
+      arg = rd.str();
+    return rd.good();
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // PipeSecurity class
+  // - a DACL giving only this user, and SYSTEM, access to the pipe
+
+  class PipeSecurity
+  {
+  public:
+    PipeSecurity();
+    ~PipeSecurity();
+    PipeSecurity(const PipeSecurity&) = delete;
+    PipeSecurity& operator=(const PipeSecurity&) = delete;
+    SECURITY_ATTRIBUTES* attributes() { return descriptor_ ? &attributes_ : nullptr; }
+  private:
+    PSECURITY_DESCRIPTOR descriptor_ = nullptr;
+    SECURITY_ATTRIBUTES attributes_;
+  };
+  //----< descriptor from the SDDL "D:P(A;;GA;;;SY)(A;;GA;;;user)" >-
+  /*
+   *  Without it, the pipe's default DACL lets Everyone, and anonymous
+   *  logons, read it, so any local user could send queries that read
+   *  this user's files.
+   */
+  PipeSecurity::PipeSecurity()
+  {
+    HANDLE token = NULL;
+    if (!::OpenProcessToken(::GetCurrentProcess(), TOKEN_QUERY, &token))
+      return;
+    DWORD size = 0;
+    ::GetTokenInformation(token, TokenUser, NULL, 0, &size);
+    std::vector<char> info(size);
+    char* sid = nullptr;
+    if (size > 0 && ::GetTokenInformation(token, TokenUser, info.data(), size, &size) &&
+      ::ConvertSidToStringSidA(reinterpret_cast<TOKEN_USER*>(info.data())->User.Sid, &sid))
+    {
+      std::string sddl = "D:P(A;;GA;;;SY)(A;;GA;;;" + std::string(sid) + ")";
+      ::LocalFree(sid);
+      if (!::ConvertStringSecurityDescriptorToSecurityDescriptorA(sddl.c_str(), SDDL_REVISION_1, &descriptor_, NULL))
+        descriptor_ = nullptr;
+    }
+    ::CloseHandle(token);
+    attributes_.nLength = sizeof(attributes_);
+    attributes_.lpSecurityDescriptor = descriptor_;
+    attributes_.bInheritHandle = FALSE;
+  }
+
+  PipeSecurity::~PipeSecurity()
+  {
+    if (descriptor_)
+      ::LocalFree(descriptor_);
+  }
+}
+/////////////////////////////////////////////////////////////////////
+// QueryServer::Reply::Channel
+// - output of a Reply waiting to be sent, shared with its sender
+
+struct QueryServer::Reply::Channel
+{
+  HANDLE hPipe;
+  std::mutex lock;
+  std::condition_variable ready;
+  std::string pending;
+  bool closed = false;
+  std::atomic<size_t> unsent{ 0 };
+  std::atomic<bool> broken{ false };
+
+  void send();
+};
+//----< send pending output until closed, then close the pipe >------
+/*
+ *  Runs on the Reply's own thread.  After the client goes away, output
+ *  is discarded.
+ */
+void QueryServer::Reply::Channel::send()
+{
+  std::string chunk;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      ready.wait(guard, [this]() { return pending.size() > 0 || closed; });
+      if (pending.size() == 0)
+        break;
+      chunk.swap(pending);
+    }
+    if (!broken && !writeAll(hPipe, chunk.data(), chunk.size()))
+      broken = true;
+    unsent -= chunk.size();
+    chunk.clear();
+  }
+  ::FlushFileBuffers(hPipe);   // until client has read it all
+  ::DisconnectNamedPipe(hPipe);
+  ::CloseHandle(hPipe);
+}
+
+namespace
+{
+  ///////////////////////////////////////////////////////////////////
+  // ChannelBuf class
+  // - stream buffer that hands full buffers to a Reply's sender
+
+  template <typename Channel>
+  class ChannelBuf : public std::streambuf
+  {
+  public:
+    ChannelBuf(std::shared_ptr<Channel> channel) : channel_(channel), buffer_(BufferSize)
+    {
+      setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+  protected:
+    int_type overflow(int_type c) override
+    {
+      drain();
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+      }
+      return traits_type::not_eof(c);
+    }
+    int sync() override
+    {
+      drain();
+      return 0;
+    }
+  private:
+    void drain()
+    {
+      size_t size = pptr() - pbase();
+      if (size > 0 && !channel_->broken)
+      {
+        std::lock_guard<std::mutex> guard(channel_->lock);
+        channel_->pending.append(pbase(), size);
+        channel_->unsent += size;
+        channel_->ready.notify_one();
+      }
+      setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+    std::shared_ptr<Channel> channel_;
+    std::vector<char> buffer_;
+  };
+}
+//----< reply on connected pipe, sent by a thread of its own >-------
+
+QueryServer::Reply::Reply(void* hPipe, const std::string& cwd)
+  : channel_(std::make_shared<Channel>()), out_(nullptr), cwd_(cwd)
+{
+  channel_->hPipe = hPipe;
+  buffer_.reset(new ChannelBuf<Channel>(channel_));
+  out_.rdbuf(buffer_.get());
+  std::shared_ptr<Channel> channel = channel_;
+  std::thread([channel]() { channel->send(); }).detach();
+}
+//----< end of response; sender closes pipe when all is sent >-------
+
+QueryServer::Reply::~Reply()
+{
+  out_.flush();
+  std::lock_guard<std::mutex> guard(channel_->lock);
+  channel_->closed = true;
+  channel_->ready.notify_one();
+}
+
+size_t QueryServer::Reply::unsent() const
+{
+  return channel_->unsent;
+}
+
+bool QueryServer::Reply::broken() const
+{
+  return channel_->broken;
+}
+
+/////////////////////////////////////////////////////////////////////
+// QueryServer
+
+//----< server for \\.\pipe\FindFiles.name >--------------------------
+
+QueryServer::QueryServer(const std::string& name)
+  : pipe_(pipeName(name)), intake_(std::make_shared<Intake>()) {}
+
+//----< full pipe name; a name starting with \\ is used as is >-----
+
+std::string QueryServer::pipeName(const std::string& name)
+{
+  if (name.compare(0, 2, "\\\\") == 0)
+    return name;
+  return "\\\\.\\pipe\\FindFiles." + name;
+}
+/////////////////////////////////////////////////////////////////////
+// QueryServer::Intake
+// - clients whose requests are being read, shared with their readers
+
+struct QueryServer::Intake
+{
+  Handler handle;
+  std::mutex lock;
+  std::condition_variable room;
+  size_t reading = 0;
+  bool stopped = false;   // run() returned, so handle is no longer called
+  std::atomic<size_t> requests{ 0 };
+
+  void receive(HANDLE hPipe);
+};
+//----< read a client's request and hand it to handle >-------------
+/*
+ *  Runs on a thread of the client's own, so a client that connects and
+ *  sends slowly, or not at all, holds up only itself.  Handlers are
+ *  called one at a time.
+ */
+void QueryServer::Intake::receive(HANDLE hPipe)
+{
+  std::string cwd;
+  Args args;
+  bool ok = readRequest(hPipe, cwd, args);
+  std::lock_guard<std::mutex> guard(lock);
+  --reading;
+  room.notify_one();
+  if (!ok || stopped)
+  {
+    ::DisconnectNamedPipe(hPipe);
+    ::CloseHandle(hPipe);
+    return;
+  }
+  ++requests;
+  handle(args, std::shared_ptr<Reply>(new Reply(hPipe, cwd)));
+}
+
+size_t QueryServer::requests() const
+{
+  return intake_->requests;
+}
+//----< hand each request to handle, until an error >---------------
+/*
+ *  Clients are accepted here and their requests read on threads of
+ *  their own, at most MaxReading at once, and answered through their
+ *  Replies, so a handler that queues its query frees the server to
+ *  accept the next client at once.  The pipe rejects remote clients
+ *  and, through its DACL, other users.  Its first instance must be
+ *  new, so a process that made the pipe first can't pose as the
+ *  server to clients.
+ */
+bool QueryServer::run(Handler handle)
+{
+  PipeSecurity security;
+  if (!security.attributes())
+  {
+    error_ = "can't secure pipe " + pipe_;
+    return false;
+  }
+  intake_->handle = handle;
+  DWORD first = FILE_FLAG_FIRST_PIPE_INSTANCE;   // fails if another process made the pipe
+  for (;;)
+  {
+    HANDLE hPipe = ::CreateNamedPipeA(
+      pipe_.c_str(), PIPE_ACCESS_DUPLEX | first,
+      PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+      PIPE_UNLIMITED_INSTANCES, BufferSize, BufferSize, 0, security.attributes()
+    );
+    if (hPipe == INVALID_HANDLE_VALUE)
+    {
+      if (first != 0 && ::GetLastError() == ERROR_ACCESS_DENIED)
+        error_ = pipe_ + " already exists, so another process is serving it";
+      else
+        error_ = "can't create pipe " + pipe_;
+      std::lock_guard<std::mutex> guard(intake_->lock);
+      intake_->stopped = true;
+      return false;
+    }
+    first = 0;
+    if (!::ConnectNamedPipe(hPipe, NULL) && ::GetLastError() != ERROR_PIPE_CONNECTED)
+    {
+      ::CloseHandle(hPipe);
+      continue;
+    }
+    {
+      std::unique_lock<std::mutex> guard(intake_->lock);
+      intake_->room.wait(guard, [this]() { return intake_->reading < MaxReading; });
+      ++intake_->reading;
+    }
+    std::shared_ptr<Intake> intake = intake_;
+    std::thread([intake, hPipe]() { intake->receive(hPipe); }).detach();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////
+// QueryClient
+
+//----< send request, copying response to out as it arrives >-------
+/*
+ *  The server makes a new pipe instance for each client, so a busy
+ *  server, or one between clients, is retried briefly.
+ */
+bool QueryClient::ask(const std::string& name, const Args& args, std::ostream& out, std::string& error)
+{
+  std::string pipe = QueryServer::pipeName(name);
+  HANDLE hPipe = INVALID_HANDLE_VALUE;
+  for (int attempt = 0; attempt < ConnectAttempts && hPipe == INVALID_HANDLE_VALUE; ++attempt)
+  {
+    hPipe = ::CreateFileA(pipe.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+    if (hPipe != INVALID_HANDLE_VALUE)
+      break;
+    if (::GetLastError() != ERROR_PIPE_BUSY || !::WaitNamedPipeA(pipe.c_str(), RetryMillis))
+      ::Sleep(RetryMillis);
+  }
+  if (hPipe == INVALID_HANDLE_VALUE)
+  {
+    error = "no FindFiles server at " + pipe;
+    return false;
+  }
+  std::string request;
+  BinaryIO::Writer wr(request);
+  wr.str(FileSystem::Directory::getCurrentDirectory());
+  wr.varint(args.size());
+  for (auto& arg : args)
+    wr.str(arg);
+  std::string message;
+  BinaryIO::Writer(message).u32(static_cast<uint32_t>(request.size()));
+  message += request;
+
+  bool ok = writeAll(hPipe, message.data(), message.size());
+  std::vector<char> buffer(BufferSize);
+  DWORD got = 0;
+  while (ok && ::ReadFile(hPipe, buffer.data(), BufferSize, &got, NULL) && got > 0)
+  {
+    out.write(buffer.data(), got);
+    out.flush();
+  }
+  ::CloseHandle(hPipe);
+  if (!ok)
+    error = "can't send request to " + pipe;
+  return ok;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_QUERYSERVER
+
+#include "FindFileMgr.h"
+#include <sstream>
+
+//----< run a query as /serve does: started in client's dir, stepped in home >
+/*
+ *  Needs FindFileMgr.cpp and its packages.  The server's own dir is
+ *  home, here the parent of the client's, so a query that resolves
+ *  paths after it starts resolves them in the wrong dir.
+ */
+void runServed(const QueryServer::Args& args, QueryServer::Reply& reply)
+{
+  std::vector<char*> argv{ const_cast<char*>("FindFiles") };
+  for (auto& arg : args)
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  std::streambuf* saved = std::cout.rdbuf(reply.out().rdbuf());
+  FileMgr fm;
+  FileSystem::Directory::setCurrentDirectory(reply.cwd());
+  bool walking = fm.processCmdLine(static_cast<int>(argv.size()), argv.data());
+  if (walking)
+  {
+    fm.path(fm.pcl().path());
+    walking = fm.start();
+  }
+  FileSystem::Directory::setCurrentDirectory(reply.cwd() + "\\..");
+  while (walking && fm.step())
+    ;
+  if (walking)
+    fm.finish();
+  fm.showProcessed();
+  std::cout.flush();
+  std::cout.rdbuf(saved);
+  FileSystem::Directory::setCurrentDirectory(reply.cwd());
+}
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing QueryServer";
+  std::cout << "\n =====================";
+
+  std::thread server([]() {
+    QueryServer qs("test");
+    qs.run([](const QueryServer::Args& args, std::shared_ptr<QueryServer::Reply> reply) {
+      if (args.size() > 0 && args[0] == "/find")
+      {
+        runServed(QueryServer::Args(args.begin() + 1, args.end()), *reply);
+        return;
+      }
+      reply->out() << "\n  server got " << args.size() << " args from " << reply->cwd();
+      for (auto& arg : args)
+        reply->out() << "\n    " << arg;
+    });
+  });
+  server.detach();
+  for (int i = 0; i < 2; ++i)
+  {
+    std::string error;
+    if (!QueryClient::ask("test", { "/P", ".", "/s", "/R", "^File" }, std::cout, error))
+      std::cout << "\n  " << error;
+  }
+
+  // round trip of a walk stopped by /timeout, then resumed by its token
+  std::string path = argc > 1 ? argv[1] : "..";
+  std::ostringstream first, second;
+  std::string error;
+  QueryClient::ask("test", { "/find", "/P", path, "/s", "/timeout", "1" }, first, error);
+  size_t pos = first.str().find("/resume ");
+  if (pos == std::string::npos)
+    std::cout << "\n  walk of " << path << " wasn't stopped by /timeout 1, so can't be resumed";
+  else
+  {
+    std::string token = first.str().substr(pos + 8, 16);
+    QueryClient::ask("test", { "/find", "/P", path, "/s", "/resume", token }, second, error);
+    bool resumed = second.str().find("continues a different query") == std::string::npos &&
+      second.str().find("no walk to resume") == std::string::npos;
+    std::cout << "\n  served walk stopped with token " << token << ", resumed: " << (resumed ? "yes" : "no");
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
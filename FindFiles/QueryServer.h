@@ -0,0 +1,139 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+///////////////////////////////////////////////////////////////////////
+// QueryServer.h - answer FindFiles queries from a resident process  //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Small interactive queries, e.g., from an editor, spend most of their
+ * time starting a process, compiling regexes, and reading cold dirs and
+ * indexes.  FindFiles /serve name keeps one process running that answers
+ * queries sent to a named pipe, so those costs are paid once.
+ *
+ * QueryServer accepts clients on \\.\pipe\FindFiles.name.  A request is
+ * the client's current directory and command line.  The server passes
+ * them to its handler with a Reply, whose stream sends output back to
+ * the client.  The handler may keep the Reply and answer later, e.g.,
+ * after queueing the query, while the server goes on accepting other
+ * clients.  Each client's request is read on a thread of its own, so
+ * a client that never sends holds up only itself, and each Reply sends
+ * its output on its own thread, so a client that reads slowly holds up
+ * only its own query, whose unsent output grows.  Dropping the last
+ * reference to a Reply ends the response, once its output is sent.
+ * Only clients of the same user, on the same machine, can connect, and
+ * run fails if another process already made the pipe, rather than
+ * share its name with a server clients can't trust.
+ *
+ * QueryClient::ask(...) sends a request and copies the response to an
+ * output stream as it arrives.
+ *
+ * Public Interface:
+ * -----------------
+ * QueryServer server("editor");
+ * server.run([](const QueryServer::Args& args, std::shared_ptr<QueryServer::Reply> reply) {
+ *   reply->out() << ...;   // relative paths are relative to reply->cwd()
+ * });
+ *
+ * std::string error;
+ * if (!QueryClient::ask("editor", { "/P", ".", "/s", "/R", "^File" }, std::cout, error)) ...
+ *
+ * Required Files:
+ * ---------------
+ * QueryServer.h, QueryServer.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.2 : 18 Oct 2026
+ * - requests are read on a thread per client, so a client that doesn't
+ *   send can't stall the server; arg counts are bounded by the request;
+ *   the pipe rejects remote clients and other users, and run fails if
+ *   the pipe already exists
+ * Ver 1.1 : 18 Oct 2026
+ * - serves clients concurrently; handlers answer through a Reply that
+ *   sends on its own thread, instead of a stream valid only during the
+ *   call, and the server no longer changes its current dir
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+class QueryServer
+{
+public:
+  using Args = std::vector<std::string>;
+  class Reply;
+  using Handler = std::function<void(const Args& args, std::shared_ptr<Reply> reply)>;
+
+  QueryServer(const std::string& name);
+  static std::string pipeName(const std::string& name);
+  bool run(Handler handle);
+  size_t requests() const;
+  std::string error() const;
+private:
+  struct Intake;
+  std::string pipe_;
+  std::shared_ptr<Intake> intake_;
+  std::string error_;
+};
+
+inline std::string QueryServer::error() const
+{
+  return error_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// QueryServer::Reply class
+// - stream back to one client, sent by a thread of its own
+
+class QueryServer::Reply
+{
+public:
+  ~Reply();
+  Reply(const Reply&) = delete;
+  Reply& operator=(const Reply&) = delete;
+  std::ostream& out();
+  std::string cwd() const;
+  size_t unsent() const;   // bytes written, not yet read by the client
+  bool broken() const;     // client went away
+private:
+  friend class QueryServer;
+  struct Channel;
+  Reply(void* hPipe, const std::string& cwd);
+
+  std::shared_ptr<Channel> channel_;
+  std::unique_ptr<std::streambuf> buffer_;
+  std::ostream out_;
+  std::string cwd_;
+};
+
+inline std::ostream& QueryServer::Reply::out()
+{
+  return out_;
+}
+
+inline std::string QueryServer::Reply::cwd() const
+{
+  return cwd_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// QueryClient class
+// - sends one request to a QueryServer and streams back its response
+
+class QueryClient
+{
+public:
+  using Args = QueryServer::Args;
+  static bool ask(const std::string& name, const Args& args, std::ostream& out, std::string& error);
+};
+
+#endif
@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////
+// ResultRing.cpp - results streamed to a consumer in shared memory  //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "ResultRing.h"
+#include <cstring>
+#include <chrono>
+
+using namespace ResultRingLayout;
+
+namespace
+{
+  const uint32_t MinTextBytes = 64 * 1024;   // room for any path, twice
+
+  //----< value published by the other process >-----------------------
+
+  uint64_t load(volatile LONG64* value)
+  {
+    return static_cast<uint64_t>(::InterlockedCompareExchange64(value, 0, 0));
+  }
+
+  void store(volatile LONG64* value, uint64_t to)
+  {
+    ::InterlockedExchange64(value, static_cast<LONG64>(to));
+  }
+
+  size_t sectionSize(uint32_t records, uint32_t textBytes)
+  {
+    return sizeof(Header) + static_cast<size_t>(records) * sizeof(Record) + textBytes;
+  }
+}
+
+std::string ResultRingLayout::sectionName(const std::string& name)
+{
+  return "Local\\FindFiles.Ring." + name;
+}
+
+std::string ResultRingLayout::dataEventName(const std::string& name)
+{
+  return "Local\\FindFiles.Ring." + name + ".data";
+}
+
+std::string ResultRingLayout::spaceEventName(const std::string& name)
+{
+  return "Local\\FindFiles.Ring." + name + ".space";
+}
+
+/////////////////////////////////////////////////////////////////////
+// ResultRing
+
+const size_t ResultRing::PublishEvery;
+const DWORD ResultRing::WaitMillis;
+
+//----< open ring created by a reader; one writer per ring >---------
+
+ResultRing::ResultRing(const std::string& name) : name_(name)
+{
+  static_assert(sizeof(Header) == 192 && sizeof(Record) == 32, "ring layout is shared with readers");
+  hMap_ = ::OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, sectionName(name).c_str());
+  data_ = ::OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, dataEventName(name).c_str());
+  space_ = ::OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, spaceEventName(name).c_str());
+  if (hMap_ == NULL || data_ == NULL || space_ == NULL)
+  {
+    error_ = "no ring " + name + ", its reader must create it first";
+    return;
+  }
+  Header* header = static_cast<Header*>(::MapViewOfFile(hMap_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+  if (header == nullptr || header->magic != Magic || header->version != Version)
+  {
+    error_ = "ring " + name + " is not a FindFiles result ring of version " + std::to_string(Version);
+    if (header != nullptr)
+      ::UnmapViewOfFile(header);
+    return;
+  }
+  if (::InterlockedCompareExchange(&header->writer, 1, 0) != 0 || header->state != Open)
+  {
+    error_ = "ring " + name + " already has a writer";
+    ::UnmapViewOfFile(header);
+    return;
+  }
+  header_ = header;
+  records_ = reinterpret_cast<Record*>(header + 1);
+  text_ = reinterpret_cast<char*>(records_ + header->recordCount);
+}
+//----< close, if not closed, so the reader sees the end >-----------
+
+ResultRing::~ResultRing()
+{
+  close();
+  if (header_ != nullptr)
+    ::UnmapViewOfFile(header_);
+  for (HANDLE h : { hMap_, data_, space_ })
+  {
+    if (h != NULL)
+      ::CloseHandle(h);
+  }
+}
+//----< add a record; waits while the ring is full >-----------------
+
+bool ResultRing::write(const std::string& path, uint64_t size, uint64_t time, uint32_t flags)
+{
+  if (!good() || closed_)
+    return false;
+  uint32_t textBytes = header_->textBytes;
+  uint64_t at = textWritten_ % textBytes;
+  uint64_t skip = (at + path.size() > textBytes) ? textBytes - at : 0;   // don't split path
+  uint64_t needed = skip + path.size();
+  if (path.size() > textBytes / 2)
+  {
+    error_ = "path longer than half of ring " + name_ + "'s text";
+    return false;
+  }
+  bool full = written_ - released_ >= header_->recordCount || textWritten_ + needed - textReleased_ > textBytes;
+  if (full && !waitForSpace(needed))
+    return false;
+
+  uint64_t offset = textWritten_ + skip;
+  std::memcpy(text_ + offset % textBytes, path.data(), path.size());
+  Record& rec = records_[written_ & (header_->recordCount - 1)];
+  rec.pathOffset = offset;
+  rec.pathLength = static_cast<uint32_t>(path.size());
+  rec.flags = flags;
+  rec.size = size;
+  rec.time = time;
+  ++written_;
+  textWritten_ = offset + path.size();
+  ++stats_.records;
+  if (written_ - published_ >= PublishEvery)
+  {
+    publish();
+    if (header_->state == ReaderGone)
+      return false;
+  }
+  return true;
+}
+//----< let the reader see records written so far >------------------
+
+void ResultRing::flush()
+{
+  if (good() && written_ != published_)
+    publish();
+}
+//----< publish the last records and mark the ring done >------------
+
+void ResultRing::close()
+{
+  if (!good() || closed_)
+    return;
+  closed_ = true;
+  publish();
+  ::InterlockedCompareExchange(&header_->state, WriterDone, Open);
+  ::SetEvent(data_);
+}
+//----< publish written records, waking the reader if it waits >-----
+
+void ResultRing::publish()
+{
+  store(&header_->written, written_);
+  published_ = written_;
+  if (header_->readerWaiting)
+    ::SetEvent(data_);
+}
+//----< wait until the reader has released enough; false if it's gone >
+
+bool ResultRing::waitForSpace(uint64_t textNeeded)
+{
+  auto room = [&]() {
+    released_ = load(&header_->released);
+    textReleased_ = load(&header_->textReleased);
+    return written_ - released_ < header_->recordCount && textWritten_ + textNeeded - textReleased_ <= header_->textBytes;
+  };
+  while (!room())
+  {
+    if (header_->state == ReaderGone)
+      return false;
+    publish();
+    ::InterlockedExchange(&header_->writerWaiting, 1);
+    if (!room())
+    {
+      ++stats_.waits;
+      ::WaitForSingleObject(space_, WaitMillis);
+    }
+    ::InterlockedExchange(&header_->writerWaiting, 0);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// ResultRingReader
+
+const uint32_t ResultRingReader::DefaultRecords;
+const uint32_t ResultRingReader::DefaultTextBytes;
+const size_t ResultRingReader::ReleaseEvery;
+const DWORD ResultRingReader::WaitMillis;
+
+//----< create ring; records is rounded up to a power of two >-------
+
+ResultRingReader::ResultRingReader(const std::string& name, uint32_t records, uint32_t textBytes)
+{
+  uint32_t count = 1;
+  while (count < records && count < 0x80000000u)
+    count <<= 1;
+  textBytes = (std::max)(textBytes, MinTextBytes);
+  uint64_t size = sectionSize(count, textBytes);
+  hMap_ = ::CreateFileMappingA(
+    INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+    static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), sectionName(name).c_str()
+  );
+  if (hMap_ == NULL || ::GetLastError() == ERROR_ALREADY_EXISTS)
+  {
+    error_ = "can't create ring " + name + ", it may be in use";
+    return;
+  }
+  data_ = ::CreateEventA(NULL, FALSE, FALSE, dataEventName(name).c_str());
+  space_ = ::CreateEventA(NULL, FALSE, FALSE, spaceEventName(name).c_str());
+  Header* header = static_cast<Header*>(::MapViewOfFile(hMap_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+  if (data_ == NULL || space_ == NULL || header == nullptr)
+  {
+    error_ = "can't create ring " + name;
+    return;
+  }
+  std::memset(header, 0, sizeof(Header));
+  header->version = Version;
+  header->recordCount = count;
+  header->textBytes = textBytes;
+  ::InterlockedExchange(reinterpret_cast<volatile LONG*>(&header->magic), static_cast<LONG>(Magic));   // last, for writers
+  header_ = header;
+  records_ = reinterpret_cast<Record*>(header + 1);
+  text_ = reinterpret_cast<char*>(records_ + count);
+}
+//----< tell a writer still running that no one is reading >---------
+
+ResultRingReader::~ResultRingReader()
+{
+  if (header_ != nullptr)
+  {
+    ::InterlockedExchange(&header_->state, ReaderGone);
+    ::SetEvent(space_);
+    ::UnmapViewOfFile(header_);
+  }
+  for (HANDLE h : { hMap_, data_, space_ })
+  {
+    if (h != NULL)
+      ::CloseHandle(h);
+  }
+}
+//----< next record, in place; false at end, or after timeoutMillis >
+/*
+ *  Taking a record releases the one before it, so its path may then be
+ *  overwritten.  Releases are published a batch at a time.
+ */
+bool ResultRingReader::next(View& view, DWORD timeoutMillis)
+{
+  timedOut_ = false;
+  if (!good())
+    return false;
+  if (read_ - releasedTo_ >= ReleaseEvery)
+    release();
+  if (read_ == written_ && !waitForRecords(timeoutMillis))
+    return false;
+  const Record& rec = records_[read_ & (header_->recordCount - 1)];
+  view.path = text_ + rec.pathOffset % header_->textBytes;
+  view.length = rec.pathLength;
+  view.size = rec.size;
+  view.time = rec.time;
+  view.flags = rec.flags;
+  ++read_;
+  textRead_ = rec.pathOffset + rec.pathLength;
+  return true;
+}
+//----< publish records taken, waking the writer if it waits >-------
+
+void ResultRingReader::release()
+{
+  store(&header_->textReleased, textRead_);
+  store(&header_->released, read_);
+  releasedTo_ = read_;
+  if (header_->writerWaiting)
+    ::SetEvent(space_);
+}
+//----< wait for the writer to publish more; false if it's done >----
+
+bool ResultRingReader::waitForRecords(DWORD timeoutMillis)
+{
+  auto start = std::chrono::steady_clock::now();
+  written_ = load(&header_->written);
+  while (read_ == written_)
+  {
+    release();
+    if (header_->state == WriterDone)
+    {
+      written_ = load(&header_->written);
+      return read_ != written_;
+    }
+    ::InterlockedExchange(&header_->readerWaiting, 1);
+    written_ = load(&header_->written);
+    if (read_ == written_ && header_->state != WriterDone)
+    {
+      ++waits_;
+      ::WaitForSingleObject(data_, WaitMillis);
+    }
+    ::InterlockedExchange(&header_->readerWaiting, 0);
+    written_ = load(&header_->written);
+    auto waited = std::chrono::steady_clock::now() - start;
+    if (read_ == written_ && timeoutMillis != INFINITE && waited >= std::chrono::milliseconds(timeoutMillis))
+    {
+      timedOut_ = true;
+      return false;
+    }
+  }
+  return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_RESULTRING
+
+#include <iostream>
+#include <thread>
+
+//----< with a name, consume a FindFiles /ring name run >------------
+
+int consume(const std::string& name)
+{
+  ResultRingReader reader(name);
+  if (!reader.good())
+  {
+    std::cout << "\n  " << reader.error() << "\n\n";
+    return 1;
+  }
+  std::cout << "\n  ring " << name << " ready, run FindFiles ... /ring " << name << std::flush;
+  ResultRingReader::View view;
+  size_t files = 0, dirs = 0;
+  uint64_t bytes = 0;
+  while (!reader.next(view, 100) && reader.timedOut())
+    ;
+  auto start = std::chrono::steady_clock::now();
+  do
+  {
+    if (view.flags & ResultRing::IsDir)
+      ++dirs;
+    else
+      ++files;
+    bytes += view.size;
+  } while (reader.next(view));
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "\n  " << files << " files, " << bytes << " bytes, and " << dirs << " dirs in " << secs << " s";
+  std::cout << "\n  last: " << std::string(view.path, view.length);
+  std::cout << "\n  reader waited " << reader.waits() << " times\n\n";
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing ResultRing";
+  std::cout << "\n ====================";
+  if (argc > 1)
+    return consume(argv[1]);
+
+  const size_t Count = 2000000;
+  ResultRingReader reader("test", 4096, 256 * 1024);   // small, so the writer waits
+  if (!reader.good())
+  {
+    std::cout << "\n  " << reader.error() << "\n\n";
+    return 1;
+  }
+  ResultRing::Stats st;
+  std::thread writer([&]() {
+    ResultRing ring("test");
+    for (size_t i = 0; i < Count && ring.good(); ++i)
+      ring.write("C:\\src\\dir" + std::to_string(i % 977) + "\\file" + std::to_string(i) + ".cpp", i, i * 10, 0);
+    ring.close();
+    st = ring.stats();
+  });
+  auto start = std::chrono::steady_clock::now();
+  ResultRingReader::View view;
+  size_t read = 0, bad = 0;
+  while (reader.next(view))
+  {
+    std::string expect = "file" + std::to_string(read) + ".cpp";
+    if (view.size != read || view.length < expect.size() ||
+        std::memcmp(view.path + view.length - expect.size(), expect.data(), expect.size()) != 0)
+      ++bad;
+    ++read;
+  }
+  writer.join();
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "\n  read " << read << " of " << st.records << " records, " << bad << " wrong, in " << secs << " s";
+  std::cout << "\n  writer waited " << st.waits << " times, reader " << reader.waits() << " times";
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,233 @@
+#ifndef RESULTRING_H
+#define RESULTRING_H
+///////////////////////////////////////////////////////////////////////
+// ResultRing.h - results streamed to a consumer in shared memory    //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Tools reading millions of results spend most of their time parsing
+ * FindFiles' text.  With /ring name, FindFiles writes each result as a
+ * fixed layout record, path offset and length, size, last write time,
+ * and flags, into a ring in a named shared memory section, with the
+ * path's text in a second ring beside it.  A consumer linking
+ * ResultRingReader takes records in place, with the path pointing into
+ * the section, so nothing is copied or parsed.
+ *
+ * The consumer creates the ring, choosing its size, then starts
+ * FindFiles with its name.  The writer, ResultRing, waits for space
+ * when the consumer falls behind, so a slow consumer slows the walk
+ * instead of growing memory, and the reader waits for records when it
+ * gets ahead.
+ *
+ * Each side publishes how far it has got, the writer records written
+ * and the reader records released, with an interlocked exchange, after
+ * a batch of records, before it waits, and, for the writer, when told
+ * to flush, e.g., after each dir.  A side about to wait sets a flag,
+ * checks once more, and waits on a named auto-reset event, which the
+ * other side sets only if it sees the flag, so a side that doesn't
+ * wait costs no kernel calls.  Waits time out now and then, so a lost
+ * wakeup only delays, and to notice a peer that has gone.
+ *
+ * Section layout: a header, then RecordCount records of 32 bytes, then
+ * TextBytes of path text.  A path is never split at the end of the
+ * text ring; the writer skips to its start instead.
+ *
+ * Public Interface:
+ * -----------------
+ * ResultRingReader reader("build42");               // consumer first
+ * ... start FindFiles /P C:\src /s /ring build42 ...
+ * ResultRingReader::View view;
+ * while (reader.next(view)) ... view.path, view.length, view.size ...
+ *
+ * ResultRing ring("build42");                        // FindFiles
+ * ring.write(path, size, time, 0);
+ * ring.close();
+ *
+ * Required Files:
+ * ---------------
+ * ResultRing.h, ResultRing.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <cstdint>
+#include <windows.h>
+
+namespace ResultRingLayout
+{
+  const uint32_t Magic = 0x52524646;   // "FFRR"
+  const uint32_t Version = 1;
+  enum State { Open, WriterDone, ReaderGone };
+
+  struct Record
+  {
+    uint64_t pathOffset;   // position in text ring, mod TextBytes
+    uint32_t pathLength;
+    uint32_t flags;        // ResultRing::Flags
+    uint64_t size;
+    uint64_t time;         // last write, 100 ns ticks since 1601, UTC
+  };
+
+  struct Header                     // each side's fields in their own cache line
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordCount;           // a power of two
+    uint32_t textBytes;
+    volatile LONG state;
+    volatile LONG writer;           // 1 once a writer has opened the ring
+    char pad0[40];
+    volatile LONG64 written;        // records, published by writer
+    volatile LONG writerWaiting;
+    char pad1[52];
+    volatile LONG64 released;       // records, published by reader
+    volatile LONG64 textReleased;   // text bytes, published by reader
+    volatile LONG readerWaiting;
+    char pad2[44];
+  };
+
+  std::string sectionName(const std::string& name);
+  std::string dataEventName(const std::string& name);
+  std::string spaceEventName(const std::string& name);
+}
+
+///////////////////////////////////////////////////////////////////////
+// ResultRing class
+// - writes records to a ring created by a ResultRingReader
+
+class ResultRing
+{
+public:
+  enum Flags { IsDir = 1 };
+  static const size_t PublishEvery = 256;   // records
+  static const DWORD WaitMillis = 100;
+
+  struct Stats
+  {
+    size_t records = 0;
+    size_t waits = 0;   // for the reader to make space
+  };
+
+  ResultRing(const std::string& name);
+  ~ResultRing();
+  ResultRing(const ResultRing&) = delete;
+  ResultRing& operator=(const ResultRing&) = delete;
+  bool good() const;
+  std::string error() const;
+  bool write(const std::string& path, uint64_t size, uint64_t time, uint32_t flags);   // false if reader is gone
+  void flush();
+  void close();
+  Stats stats() const;
+private:
+  void publish();
+  bool waitForSpace(uint64_t textNeeded);
+
+  std::string name_;
+  HANDLE hMap_ = NULL;
+  HANDLE data_ = NULL;
+  HANDLE space_ = NULL;
+  ResultRingLayout::Header* header_ = nullptr;
+  ResultRingLayout::Record* records_ = nullptr;
+  char* text_ = nullptr;
+  uint64_t written_ = 0;
+  uint64_t published_ = 0;        // written_, as last published
+  uint64_t textWritten_ = 0;
+  uint64_t released_ = 0;         // as last read from header
+  uint64_t textReleased_ = 0;
+  bool closed_ = false;
+  Stats stats_;
+  std::string error_;
+};
+
+inline bool ResultRing::good() const
+{
+  return header_ != nullptr;
+}
+
+inline std::string ResultRing::error() const
+{
+  return error_;
+}
+
+inline ResultRing::Stats ResultRing::stats() const
+{
+  return stats_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// ResultRingReader class
+// - creates a ring and takes its records in place
+
+class ResultRingReader
+{
+public:
+  static const uint32_t DefaultRecords = 65536;
+  static const uint32_t DefaultTextBytes = 8 * 1024 * 1024;
+  static const size_t ReleaseEvery = 256;   // records
+  static const DWORD WaitMillis = 100;
+
+  struct View
+  {
+    const char* path = nullptr;   // in the section, valid until next call of next
+    size_t length = 0;
+    uint64_t size = 0;
+    uint64_t time = 0;
+    uint32_t flags = 0;
+  };
+
+  ResultRingReader(const std::string& name, uint32_t records = DefaultRecords, uint32_t textBytes = DefaultTextBytes);
+  ~ResultRingReader();
+  ResultRingReader(const ResultRingReader&) = delete;
+  ResultRingReader& operator=(const ResultRingReader&) = delete;
+  bool good() const;
+  std::string error() const;
+  bool next(View& view, DWORD timeoutMillis = INFINITE);   // false when all are read, or timed out
+  bool timedOut() const;
+  size_t waits() const;
+private:
+  void release();
+  bool waitForRecords(DWORD timeoutMillis);
+
+  HANDLE hMap_ = NULL;
+  HANDLE data_ = NULL;
+  HANDLE space_ = NULL;
+  ResultRingLayout::Header* header_ = nullptr;
+  ResultRingLayout::Record* records_ = nullptr;
+  char* text_ = nullptr;
+  uint64_t read_ = 0;
+  uint64_t releasedTo_ = 0;       // read_, as last released
+  uint64_t textRead_ = 0;
+  uint64_t written_ = 0;          // as last read from header
+  bool timedOut_ = false;
+  size_t waits_ = 0;
+  std::string error_;
+};
+
+inline bool ResultRingReader::good() const
+{
+  return header_ != nullptr;
+}
+
+inline std::string ResultRingReader::error() const
+{
+  return error_;
+}
+
+inline bool ResultRingReader::timedOut() const
+{
+  return timedOut_;
+}
+
+inline size_t ResultRingReader::waits() const
+{
+  return waits_;
+}
+
+#endif
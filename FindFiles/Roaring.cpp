@@ -0,0 +1,450 @@
+///////////////////////////////////////////////////////////////////////
+// Roaring.cpp - compressed bitmaps of file ids, for faceted queries //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Serialized form, all integers little-endian:
+ *   container count
+ *   per container - u16 key, u16 reserved, u32 count, then count u16
+ *   low bits if count <= 4096, else 1024 u64 bitmap words
+ */
+
+#include "Roaring.h"
+#include <algorithm>
+#include <iterator>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ROARING_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+  //----< set bits in one word >-------------------------------------
+
+  unsigned popcount(uint64_t w)
+  {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+    return static_cast<unsigned>(__popcnt64(w));
+#elif defined(_MSC_VER)
+    return __popcnt(static_cast<unsigned>(w)) + __popcnt(static_cast<unsigned>(w >> 32));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(w));
+#endif
+  }
+
+  bool testBit(const std::vector<uint64_t>& bits, uint16_t low)
+  {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+  }
+}
+
+const uint32_t Roaring::ArrayMax;
+const size_t Roaring::BitmapWords;
+
+//----< all ids in [first, last) >-----------------------------------
+
+Roaring Roaring::range(Id first, Id last)
+{
+  Roaring result;
+  uint64_t lo = first;
+  while (lo < last)
+  {
+    uint64_t hi = (std::min)(static_cast<uint64_t>(last), ((lo >> 16) + 1) << 16);
+    Container c;
+    c.key = static_cast<uint16_t>(lo >> 16);
+    c.count = static_cast<uint32_t>(hi - lo);
+    if (c.count <= ArrayMax)
+    {
+      for (uint64_t id = lo; id < hi; ++id)
+        c.array.push_back(static_cast<uint16_t>(id));
+    }
+    else
+    {
+      c.bits.assign(BitmapWords, 0);
+      for (uint64_t id = lo; id < hi; ++id)   // at most 65536 bits
+        c.bits[(id & 0xffff) >> 6] |= 1ULL << (id & 63);
+    }
+    result.containers_.push_back(c);
+    lo = hi;
+  }
+  return result;
+}
+//----< add id, fastest when ids arrive in increasing order >--------
+
+void Roaring::add(Id id)
+{
+  uint16_t key = static_cast<uint16_t>(id >> 16);
+  uint16_t low = static_cast<uint16_t>(id);
+  auto iter = containers_.end();
+  if (containers_.size() == 0 || containers_.back().key < key)
+  {
+    containers_.push_back(Container());
+    containers_.back().key = key;
+    iter = containers_.end() - 1;
+  }
+  else
+  {
+    iter = std::lower_bound(containers_.begin(), containers_.end(), key,
+      [](const Container& c, uint16_t k) { return c.key < k; });
+    if (iter->key != key)
+    {
+      iter = containers_.insert(iter, Container());
+      iter->key = key;
+    }
+  }
+  Container& c = *iter;
+  if (c.isBitmap())
+  {
+    uint64_t mask = 1ULL << (low & 63);
+    if ((c.bits[low >> 6] & mask) == 0)
+    {
+      c.bits[low >> 6] |= mask;
+      ++c.count;
+    }
+    return;
+  }
+  if (c.array.size() == 0 || c.array.back() < low)
+    c.array.push_back(low);
+  else
+  {
+    auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+    if (*pos == low)
+      return;
+    c.array.insert(pos, low);
+  }
+  if (++c.count > ArrayMax)
+    toBitmap(c);
+}
+
+bool Roaring::contains(Id id) const
+{
+  uint16_t key = static_cast<uint16_t>(id >> 16);
+  uint16_t low = static_cast<uint16_t>(id);
+  auto iter = std::lower_bound(containers_.begin(), containers_.end(), key,
+    [](const Container& c, uint16_t k) { return c.key < k; });
+  if (iter == containers_.end() || iter->key != key)
+    return false;
+  if (iter->isBitmap())
+    return testBit(iter->bits, low);
+  return std::binary_search(iter->array.begin(), iter->array.end(), low);
+}
+
+uint64_t Roaring::count() const
+{
+  uint64_t total = 0;
+  for (auto& c : containers_)
+    total += c.count;
+  return total;
+}
+//----< ids in increasing order >------------------------------------
+
+Roaring::Ids Roaring::ids() const
+{
+  Ids result;
+  result.reserve(static_cast<size_t>(count()));
+  for (auto& c : containers_)
+  {
+    Id high = static_cast<Id>(c.key) << 16;
+    if (!c.isBitmap())
+    {
+      for (auto low : c.array)
+        result.push_back(high | low);
+      continue;
+    }
+    for (size_t w = 0; w < BitmapWords; ++w)
+    {
+      uint64_t word = c.bits[w];
+      while (word != 0)
+      {
+        unsigned bit = popcount((word & (0 - word)) - 1);   // index of lowest set bit
+        result.push_back(high | static_cast<Id>(w * 64 + bit));
+        word &= word - 1;
+      }
+    }
+  }
+  return result;
+}
+//----< combine two bitmaps' words, returning set bits of result >---
+
+uint32_t Roaring::words(const uint64_t* a, const uint64_t* b, uint64_t* out, Op op)
+{
+  size_t i = 0;
+#ifdef ROARING_SSE2
+  for (; i + 2 <= BitmapWords; i += 2)
+  {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    __m128i vr = (op == And) ? _mm_and_si128(va, vb) : (op == Or) ? _mm_or_si128(va, vb) : _mm_andnot_si128(vb, va);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), vr);
+  }
+#endif
+  for (; i < BitmapWords; ++i)
+    out[i] = (op == And) ? (a[i] & b[i]) : (op == Or) ? (a[i] | b[i]) : (a[i] & ~b[i]);
+  uint32_t count = 0;
+  for (i = 0; i < BitmapWords; ++i)
+    count += popcount(out[i]);
+  return count;
+}
+//----< array container becomes a bitmap >---------------------------
+
+void Roaring::toBitmap(Container& c)
+{
+  c.bits.assign(BitmapWords, 0);
+  for (auto low : c.array)
+    c.bits[low >> 6] |= 1ULL << (low & 63);
+  std::vector<uint16_t>().swap(c.array);
+}
+//----< bitmap container with few ids becomes an array >-------------
+
+void Roaring::fit(Container& c)
+{
+  if (!c.isBitmap() || c.count > ArrayMax)
+    return;
+  c.array.reserve(c.count);
+  for (uint32_t low = 0; low < BitmapWords * 64; ++low)
+  {
+    if (testBit(c.bits, static_cast<uint16_t>(low)))
+      c.array.push_back(static_cast<uint16_t>(low));
+  }
+  std::vector<uint64_t>().swap(c.bits);
+}
+//----< combine containers with the same key >-----------------------
+
+Roaring::Container Roaring::combine(const Container& a, const Container& b, Op op)
+{
+  Container r;
+  r.key = a.key;
+  if (a.isBitmap() && b.isBitmap())
+  {
+    r.bits.resize(BitmapWords);
+    r.count = words(a.bits.data(), b.bits.data(), r.bits.data(), op);
+    fit(r);
+    return r;
+  }
+  if (!a.isBitmap() && !b.isBitmap())
+  {
+    auto out = std::back_inserter(r.array);
+    if (op == And)
+      std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+    else if (op == Or)
+      std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+    else
+      std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+    r.count = static_cast<uint32_t>(r.array.size());
+    if (r.count > ArrayMax)
+      toBitmap(r);
+    return r;
+  }
+  // one array, one bitmap
+  const Container& arr = a.isBitmap() ? b : a;
+  const Container& bmp = a.isBitmap() ? a : b;
+  if (op == And || (op == AndNot && !a.isBitmap()))
+  {
+    bool keep = (op == And);   // AndNot keeps a's ids not in b
+    for (auto low : arr.array)
+    {
+      if (testBit(bmp.bits, low) == keep)
+        r.array.push_back(low);
+    }
+    r.count = static_cast<uint32_t>(r.array.size());
+    return r;
+  }
+  r.bits = bmp.bits;
+  r.count = bmp.count;
+  for (auto low : arr.array)
+  {
+    uint64_t mask = 1ULL << (low & 63);
+    bool set = (r.bits[low >> 6] & mask) != 0;
+    if (op == Or && !set)
+    {
+      r.bits[low >> 6] |= mask;
+      ++r.count;
+    }
+    else if (op == AndNot && set)
+    {
+      r.bits[low >> 6] &= ~mask;
+      --r.count;
+    }
+  }
+  fit(r);
+  return r;
+}
+//----< AND, OR, or ANDNOT, container by container >-----------------
+
+Roaring Roaring::combine(const Roaring& a, const Roaring& b, Op op)
+{
+  Roaring result;
+  size_t i = 0, j = 0;
+  while (i < a.containers_.size() || j < b.containers_.size())
+  {
+    const Container* ca = i < a.containers_.size() ? &a.containers_[i] : nullptr;
+    const Container* cb = j < b.containers_.size() ? &b.containers_[j] : nullptr;
+    if (ca != nullptr && (cb == nullptr || ca->key < cb->key))
+    {
+      if (op != And)
+        result.containers_.push_back(*ca);
+      ++i;
+    }
+    else if (ca == nullptr || cb->key < ca->key)
+    {
+      if (op == Or)
+        result.containers_.push_back(*cb);
+      else if (op == AndNot && ca == nullptr)
+        break;
+      ++j;
+    }
+    else
+    {
+      Container c = combine(*ca, *cb, op);
+      if (c.count > 0)
+        result.containers_.push_back(std::move(c));
+      ++i;
+      ++j;
+    }
+    if (op == And && (i == a.containers_.size() || j == b.containers_.size()))
+      break;
+  }
+  return result;
+}
+//----< size of a AND b, without building it >-----------------------
+
+uint64_t Roaring::intersectCount(const Roaring& a, const Roaring& b)
+{
+  uint64_t total = 0;
+  std::vector<uint64_t> scratch(BitmapWords);
+  size_t i = 0, j = 0;
+  while (i < a.containers_.size() && j < b.containers_.size())
+  {
+    const Container& ca = a.containers_[i];
+    const Container& cb = b.containers_[j];
+    if (ca.key < cb.key)
+      ++i;
+    else if (cb.key < ca.key)
+      ++j;
+    else
+    {
+      if (ca.isBitmap() && cb.isBitmap())
+        total += words(ca.bits.data(), cb.bits.data(), scratch.data(), And);
+      else if (ca.isBitmap() || cb.isBitmap())
+      {
+        const Container& arr = ca.isBitmap() ? cb : ca;
+        const Container& bmp = ca.isBitmap() ? ca : cb;
+        for (auto low : arr.array)
+          total += testBit(bmp.bits, low) ? 1 : 0;
+      }
+      else
+      {
+        size_t p = 0, q = 0;
+        while (p < ca.array.size() && q < cb.array.size())
+        {
+          if (ca.array[p] < cb.array[q])
+            ++p;
+          else if (cb.array[q] < ca.array[p])
+            ++q;
+          else
+          {
+            ++total;
+            ++p;
+            ++q;
+          }
+        }
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return total;
+}
+//----< serialize >--------------------------------------------------
+
+void Roaring::write(BinaryIO::Writer& wr) const
+{
+  wr.u32(static_cast<uint32_t>(containers_.size()));
+  for (auto& c : containers_)
+  {
+    wr.u16(c.key);
+    wr.u16(0);
+    wr.u32(c.count);
+    if (c.isBitmap())
+    {
+      for (auto word : c.bits)
+        wr.u64(word);
+    }
+    else
+    {
+      for (auto low : c.array)
+        wr.u16(low);
+    }
+  }
+}
+//----< deserialize, false if data is truncated or inconsistent >----
+
+bool Roaring::read(BinaryIO::Reader& rd)
+{
+  containers_.clear();
+  uint32_t n = rd.u32();
+  for (uint32_t i = 0; i < n && rd.good(); ++i)
+  {
+    Container c;
+    c.key = rd.u16();
+    rd.skip(2);
+    c.count = rd.u32();
+    if (c.count == 0 || c.count > BitmapWords * 64 ||
+        (containers_.size() > 0 && containers_.back().key >= c.key))
+      return false;
+    if (c.count > ArrayMax)
+    {
+      c.bits.resize(BitmapWords);
+      for (auto& word : c.bits)
+        word = rd.u64();
+    }
+    else
+    {
+      c.array.resize(c.count);
+      for (auto& low : c.array)
+        low = rd.u16();
+    }
+    containers_.push_back(std::move(c));
+  }
+  return rd.good();
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_ROARING
+
+#include <iostream>
+
+int main()
+{
+  std::cout << "\n  Testing Roaring";
+  std::cout << "\n =================";
+
+  Roaring evens, below;
+  for (Roaring::Id id = 0; id < 200000; id += 2)
+    evens.add(id);
+  below = Roaring::range(65000, 70000);
+  Roaring both = Roaring::intersect(evens, below);
+  Roaring either = Roaring::unite(evens, below);
+  Roaring odd = Roaring::subtract(below, evens);
+  std::cout << "\n  evens: " << evens.count() << ", range: " << below.count();
+  std::cout << "\n  AND: " << both.count() << ", counted: " << Roaring::intersectCount(evens, below);
+  std::cout << "\n  OR: " << either.count() << ", ANDNOT: " << odd.count();
+  std::cout << "\n  first odd in range: " << odd.ids()[0];
+
+  std::string buffer;
+  BinaryIO::Writer wr(buffer);
+  either.write(wr);
+  Roaring copy;
+  BinaryIO::Reader rd(buffer);
+  std::cout << "\n  serialized " << buffer.size() << " bytes, read back "
+    << (copy.read(rd) && copy.ids() == either.ids() ? "equal" : "different");
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,110 @@
+#ifndef ROARING_H
+#define ROARING_H
+///////////////////////////////////////////////////////////////////////
+// Roaring.h - compressed bitmaps of file ids, for faceted queries   //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Roaring holds a set of 32 bit ids the way roaring bitmaps do.  Ids
+ * are grouped by their high 16 bits into containers, and each container
+ * stores its low 16 bits either as a sorted array, while it holds at
+ * most 4096 ids, or as a bitmap of 65536 bits.  Sparse and dense sets
+ * both stay small, and AND, OR, and ANDNOT work container by container.
+ *
+ * Bitmap containers are combined 128 bits at a time with SSE2 where
+ * available, and counted with popcount, so faceted counts are cheap.
+ *
+ * The name index stores one Roaring per extension and per day of last
+ * write, and answers queries like *.h or *.cpp below a dir, modified
+ * this week, by combining them.
+ *
+ * Public Interface:
+ * -----------------
+ * Roaring cpp, h;
+ * cpp.add(17); h.add(42);
+ * Roaring below = Roaring::range(10, 100);
+ * Roaring hits = Roaring::intersect(Roaring::unite(cpp, h), below);
+ * uint64_t n = Roaring::intersectCount(cpp, below);
+ * Roaring::Ids ids = hits.ids();
+ * hits.write(writer);  loaded.read(reader);
+ *
+ * Required Files:
+ * ---------------
+ * Roaring.h, Roaring.cpp
+ * BinaryIO.h
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <vector>
+#include <cstdint>
+#include "BinaryIO.h"
+
+class Roaring
+{
+public:
+  using Id = uint32_t;
+  using Ids = std::vector<Id>;
+  static const uint32_t ArrayMax = 4096;    // larger containers are bitmaps
+  static const size_t BitmapWords = 1024;   // 65536 bits
+
+  static Roaring range(Id first, Id last);
+  void add(Id id);
+  bool contains(Id id) const;
+  uint64_t count() const;
+  bool empty() const;
+  Ids ids() const;
+
+  static Roaring intersect(const Roaring& a, const Roaring& b);
+  static Roaring unite(const Roaring& a, const Roaring& b);
+  static Roaring subtract(const Roaring& a, const Roaring& b);   // a ANDNOT b
+  static uint64_t intersectCount(const Roaring& a, const Roaring& b);
+
+  void write(BinaryIO::Writer& wr) const;
+  bool read(BinaryIO::Reader& rd);
+private:
+  struct Container
+  {
+    uint16_t key = 0;              // high 16 bits of its ids
+    uint32_t count = 0;
+    std::vector<uint16_t> array;   // sorted low bits, while count <= ArrayMax
+    std::vector<uint64_t> bits;    // BitmapWords words, otherwise
+    bool isBitmap() const { return bits.size() > 0; }
+  };
+  enum Op { And, Or, AndNot };
+  static Roaring combine(const Roaring& a, const Roaring& b, Op op);
+  static Container combine(const Container& a, const Container& b, Op op);
+  static uint32_t words(const uint64_t* a, const uint64_t* b, uint64_t* out, Op op);
+  static void toBitmap(Container& c);
+  static void fit(Container& c);
+
+  std::vector<Container> containers_;   // sorted by key, none empty
+};
+
+inline bool Roaring::empty() const
+{
+  return containers_.size() == 0;
+}
+
+inline Roaring Roaring::intersect(const Roaring& a, const Roaring& b)
+{
+  return combine(a, b, And);
+}
+
+inline Roaring Roaring::unite(const Roaring& a, const Roaring& b)
+{
+  return combine(a, b, Or);
+}
+
+inline Roaring Roaring::subtract(const Roaring& a, const Roaring& b)
+{
+  return combine(a, b, AndNot);
+}
+
+#endif
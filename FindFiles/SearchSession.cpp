@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////
+// SearchSession.cpp - narrows the last query's matches as user types//
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "SearchSession.h"
+#include "FileSystem.h"
+#include <regex>
+#include <algorithm>
+
+namespace
+{
+  const std::string Special = ".^$|()[]{}*+?\\";
+
+  bool isLiteral(const std::string& regex)
+  {
+    return regex.find_first_of(Special) == std::string::npos;
+  }
+  //----< is dir root, or with recursive, a dir below root? >---------
+
+  bool under(const std::string& dir, const std::string& root, bool recursive)
+  {
+    if (dir.size() < root.size() || FileSystem::Path::toLower(dir.substr(0, root.size())) != FileSystem::Path::toLower(root))
+      return false;
+    if (dir.size() == root.size())
+      return true;
+    return recursive && (dir[root.size()] == '\\' || dir[root.size()] == '/');
+  }
+}
+//----< matches of query, from the last matches if it narrows them >--
+
+const SearchSession::Matches& SearchSession::search(FindEngine& engine, const Query& query)
+{
+  if (!begin(query))
+  {
+    FindEngine::Walk walk(engine, walkQuery(query));
+    FindEngine::Visit visit;
+    while (walk.next(visit))
+      add(visit);
+    end();
+  }
+  return matches_;
+}
+//----< start query; true if it narrowed the last, false to walk >---
+/*
+ *  Until the walk's end, the session has no last query, so a walk
+ *  left unfinished isn't taken for a complete one.
+ */
+bool SearchSession::begin(const Query& query)
+{
+  narrowed_ = valid_ && narrows(query, last_);
+  if (narrowed_)
+  {
+    filter(query);
+    last_ = query;
+    return true;
+  }
+  ++stats_.walks;
+  valid_ = false;
+  matches_.clear();
+  walking_ = query;
+  return false;
+}
+//----< add the matches of one visit of the walk begun >-------------
+
+void SearchSession::add(const FindEngine::Visit& visit)
+{
+  ++stats_.dirs;
+  for (auto& found : visit.files)
+  {
+    const FileSystem::Directory::Entry& entry = visit.entries[found.entry];
+    matches_.push_back(Match{ visit.dir, entry.name, entry.time, found.pattern });
+  }
+}
+//----< the walk begun has visited every dir >-----------------------
+
+void SearchSession::end()
+{
+  last_ = walking_;
+  valid_ = true;
+}
+//----< query as FindEngine walks it, for files only >---------------
+
+FindEngine::Query SearchSession::walkQuery(const Query& query)
+{
+  FindEngine::Query walked;
+  walked.root = query.root;
+  walked.patterns = query.patterns;
+  walked.regex = query.regex;
+  walked.recursive = query.recursive;
+  return walked;
+}
+//----< can next match only names that last matched? >---------------
+
+bool SearchSession::narrows(const Query& next, const Query& last)
+{
+  if (next.recursive != last.recursive || !under(next.root, last.root, last.recursive))
+    return false;
+  size_t pos = 0;
+  for (auto& patt : next.patterns)
+  {
+    while (pos < last.patterns.size() && last.patterns[pos] != patt)
+      ++pos;
+    if (pos == last.patterns.size())
+      return false;
+    ++pos;
+  }
+  return narrowsRegex(next.regex, last.regex);
+}
+//----< does every name next finds contain a match of last? >--------
+/*
+ *  regex_search finds a match anywhere in a name, so a regex with more
+ *  appended still contains a match of the original, unless either has
+ *  alternatives, or the addition binds to the original's last atom, as
+ *  a quantifier would, or finishes an escape or closes a group the
+ *  original started.
+ */
+bool SearchSession::narrowsRegex(const std::string& next, const std::string& last)
+{
+  if (next == last || last == ".*" || last == "")
+    return true;
+  if (isLiteral(next) && isLiteral(last))
+    return next.find(last) != std::string::npos;
+  if (next.size() <= last.size() || next.compare(0, last.size(), last) != 0)
+    return false;
+  std::string added = next.substr(last.size());
+  bool escaped = false;   // last ends with an unfinished escape
+  for (size_t i = last.size(); i > 0 && last[i - 1] == '\\'; --i)
+    escaped = !escaped;
+  if (escaped || last.find('|') != std::string::npos || added.find('|') != std::string::npos ||
+      std::string("*+?{").find(added[0]) != std::string::npos)
+    return false;
+  int depth = 0;          // of groups opened by added
+  bool inClass = false;   // in a [...] of added
+  for (size_t i = 0; i < added.size(); ++i)
+  {
+    if (added[i] == '\\')
+      ++i;
+    else if (inClass)
+      inClass = (added[i] != ']');
+    else if (added[i] == '[')
+      inClass = true;
+    else if (added[i] == '(')
+      ++depth;
+    else if (added[i] == ')' && --depth < 0)
+      return false;
+  }
+  return true;
+}
+//----< keep last matches that query matches >-----------------------
+
+void SearchSession::filter(const Query& query)
+{
+  ++stats_.narrowed;
+  std::vector<size_t> renumber(last_.patterns.size(), query.patterns.size());
+  size_t pos = 0;
+  for (size_t p = 0; p < query.patterns.size(); ++p)
+  {
+    while (last_.patterns[pos] != query.patterns[p])
+      ++pos;
+    renumber[pos++] = p;
+  }
+  std::regex re(query.regex);
+  Matches kept;
+  for (auto& match : matches_)
+  {
+    if (renumber[match.pattern] == query.patterns.size() || !under(match.dir, query.root, query.recursive) ||
+        !std::regex_search(match.name, re))
+      continue;
+    kept.push_back(match);
+    kept.back().pattern = renumber[match.pattern];
+  }
+  matches_.swap(kept);
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SEARCHSESSION
+
+#include <iostream>
+#include <chrono>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing SearchSession";
+  std::cout << "\n =======================";
+
+  FindEngine engine;
+  SearchSession session;
+  SearchSession::Query query;
+  query.root = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : "..");
+  query.patterns = { "*.h", "*.cpp" };
+  query.recursive = true;
+  for (std::string typed : { "F", "Fi", "File", "Fil", "FileSystem" })
+  {
+    query.regex = typed;
+    auto start = std::chrono::steady_clock::now();
+    size_t count = session.search(engine, query).size();
+    auto took = std::chrono::steady_clock::now() - start;
+    std::cout << "\n  " << typed << ": " << count << " matches, " << (session.narrowed() ? "narrowed" : "walked")
+      << " in " << std::chrono::duration_cast<std::chrono::microseconds>(took).count() << " us";
+  }
+
+  struct { const char* last; const char* next; bool narrows; } cases[] = {
+    { "Fi", "Fil", true }, { "a", "a|b", false }, { "a", "a*", false }, { "a\\", "a\\.", false },
+    { "(a", "(a)b", false }, { "f1", "f1\\.h", true }, { "f", "f(1|2)", false }, { "f", "f[)]", true }
+  };
+  for (auto& c : cases)
+  {
+    bool narrows = SearchSession::narrowsRegex(c.next, c.last);
+    std::cout << "\n  " << c.last << " -> " << c.next << ": " << (narrows ? "narrows" : "walks")
+      << (narrows == c.narrows ? "" : "  -- wrong");
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
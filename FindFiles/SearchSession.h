@@ -0,0 +1,136 @@
+#ifndef SEARCHSESSION_H
+#define SEARCHSESSION_H
+///////////////////////////////////////////////////////////////////////
+// SearchSession.h - narrows the last query's matches as user types  //
+// Ver 1.1                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * An editor that searches as the user types sends a query per
+ * keystroke, and most keystrokes only narrow the last query: a longer
+ * regex, fewer patterns, a dir below the last one.  A SearchSession
+ * keeps the matches of its last query, and answers a query that can
+ * only match a subset of them by filtering those matches, without
+ * reading any dir.  Other queries walk the tree, with a FindEngine
+ * Walk, whose visits are added to the session, so a caller may take
+ * that walk a dir at a time: begin a query, add each visit of the walk,
+ * and end it.  A session whose walk isn't ended has no last query.
+ *
+ * A query narrows the last one if each of these holds:
+ * - its root is the last root, or, for recursive queries, a dir below it
+ * - it is recursive if and only if the last one was
+ * - its patterns are some of the last patterns, in the same order
+ * - its regex is the last one, or the last one with more appended, if
+ *   neither has a |, and what's appended doesn't start with a
+ *   quantifier, finish an escape, or close a group, or a literal
+ *   containing the last, if both are literals, or anything, if the
+ *   last was .*
+ * Each match records the pattern that found it, so filtered matches
+ * are in the order a walk would find them.
+ *
+ * Public Interface:
+ * -----------------
+ * SearchSession session;
+ * SearchSession::Query query{ root, { "*.h" }, "Fi", true };
+ * session.search(engine, query);           // a FindEngine
+ * query.regex = "Fil";
+ * for (auto& match : session.search(engine, query)) ... match.dir, match.name ...
+ * if (session.narrowed()) ... no dir was read ...
+ * if (!session.begin(query)) {             // or, a dir at a time
+ *   FindEngine::Walk walk(engine, SearchSession::walkQuery(query));
+ *   while (walk.next(visit)) session.add(visit);
+ *   session.end();
+ * }
+ *
+ * Required Files:
+ * ---------------
+ * SearchSession.h, SearchSession.cpp
+ * FindEngine.h, FindEngine.cpp, NameMatch.h, NameMatch.cpp, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.1 : 18 Oct 2026
+ * - walks are FindEngine Walks, added to the session a visit at a
+ *   time with begin, add, and end, instead of a walk of its own
+ * - a regex with | appended, or appending text that closes a group,
+ *   no longer narrows the last
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "FindEngine.h"
+
+class SearchSession
+{
+public:
+  using Path = std::string;
+  using Pattern = std::string;
+  using Patterns = std::vector<Pattern>;
+
+  struct Query
+  {
+    Path root;                          // full path
+    Patterns patterns{ "*.*" };
+    std::string regex = ".*";
+    bool recursive = false;
+  };
+
+  struct Match
+  {
+    Path dir;
+    std::string name;
+    uint64_t time = 0;       // last write, 100 ns ticks since 1601, UTC
+    size_t pattern = 0;      // index of pattern that found it, in its query
+  };
+  using Matches = std::vector<Match>;
+
+  struct Stats
+  {
+    size_t walks = 0;
+    size_t narrowed = 0;
+    size_t dirs = 0;         // read by walks
+  };
+
+  const Matches& search(FindEngine& engine, const Query& query);
+  bool begin(const Query& query);         // true if narrowed, so matches() are ready
+  void add(const FindEngine::Visit& visit);
+  void end();
+  bool narrowed() const;
+  const Matches& matches() const;
+  Stats stats() const;
+
+  static bool narrows(const Query& next, const Query& last);
+  static bool narrowsRegex(const std::string& next, const std::string& last);
+  static FindEngine::Query walkQuery(const Query& query);
+private:
+  void filter(const Query& query);
+
+  Query last_;
+  Query walking_;
+  bool valid_ = false;
+  bool narrowed_ = false;
+  Matches matches_;
+  Stats stats_;
+};
+
+inline bool SearchSession::narrowed() const
+{
+  return narrowed_;
+}
+
+inline const SearchSession::Matches& SearchSession::matches() const
+{
+  return matches_;
+}
+
+inline SearchSession::Stats SearchSession::stats() const
+{
+  return stats_;
+}
+
+#endif
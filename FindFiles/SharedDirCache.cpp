@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////
+// SharedDirCache.cpp - dir listings shared by concurrent processes  //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Slot layout, SlotSize bytes:
+ *   header  : sequence number, odd while written, payload size, u64
+ *             hash of lower cased dir path, u64 dir's last write time,
+ *             u64 time the slot was written
+ *   payload : varint length and lower cased dir path, varint entry
+ *             count, then per entry - u8 flags, 1 for a dir, varint
+ *             length and name
+ * The section's name carries the layout version, so processes with
+ * different layouts never share one.
+ */
+
+#include "SharedDirCache.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+#include <cstring>
+
+struct SharedDirCache::Slot
+{
+  volatile LONG sequence;
+  uint32_t size;
+  uint64_t key;
+  uint64_t time;
+  uint64_t stored;
+  char payload[SharedDirCache::SlotSize - 32];
+};
+
+namespace
+{
+  const uint64_t RacyTicks = 20000000;   // 2 sec, as for QueryCache
+}
+const size_t SharedDirCache::SlotCount;
+const size_t SharedDirCache::SlotSize;
+const char* const SharedDirCache::SectionName = "Local\\FindFiles.DirCache.1";
+
+//----< open section, creating it if this is the first process >-----
+
+SharedDirCache::SharedDirCache(const std::string& sectionName)
+{
+  static_assert(sizeof(Slot) == SlotSize, "slot header must be 32 bytes");
+  uint64_t size = static_cast<uint64_t>(SlotCount) * SlotSize;
+  hMap_ = ::CreateFileMappingA(
+    INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+    static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), sectionName.c_str()
+  );
+  if (hMap_ == NULL)
+  {
+    error_ = "can't create shared dir cache " + sectionName;
+    return;
+  }
+  base_ = static_cast<char*>(::MapViewOfFile(hMap_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+  if (base_ == nullptr)
+    error_ = "can't map shared dir cache " + sectionName;
+}
+//----< unmap; section is freed when the last process closes it >----
+
+SharedDirCache::~SharedDirCache()
+{
+  if (base_ != nullptr)
+    ::UnmapViewOfFile(base_);
+  if (hMap_ != NULL)
+    ::CloseHandle(hMap_);
+}
+
+//----< one of the two slots a dir's listing may be in >-------------
+
+SharedDirCache::Slot* SharedDirCache::slotOf(uint64_t key, int way) const
+{
+  uint64_t index = (way == 0) ? key % SlotCount : (key / SlotCount) % SlotCount;
+  return reinterpret_cast<Slot*>(base_ + index * SlotSize);
+}
+//----< entries of dir, if shared and its last write time matches >--
+/*
+ *  The slot is copied, then used only if no writer had it before or
+ *  during the copy.
+ */
+bool SharedDirCache::lookup(const Path& dir, uint64_t time, Entries& entries)
+{
+  if (!good() || time == 0)
+    return false;
+  std::string path = FileSystem::Path::toLower(dir);
+  uint64_t key = BinaryIO::fnv1a(path);
+  std::string payload;
+  bool copied = false;
+  for (int way = 0; way < 2 && !copied; ++way)
+  {
+    Slot* slot = slotOf(key, way);
+    for (int attempt = 0; attempt < 2 && !copied; ++attempt)
+    {
+      LONG before = slot->sequence;
+      ::MemoryBarrier();
+      if (before & 1)
+        continue;
+      uint32_t size = slot->size;
+      if (slot->key != key || slot->time != time || size > sizeof(slot->payload))
+        break;
+      payload.assign(slot->payload, size);
+      ::MemoryBarrier();
+      copied = (slot->sequence == before);
+    }
+  }
+  entries.clear();
+  BinaryIO::Reader rd(payload);
+  if (!copied || rd.str() != path)
+  {
+    ++stats_.misses;
+    return false;
+  }
+  uint64_t count = rd.varint();
+  for (uint64_t i = 0; i < count && rd.good(); ++i)
+  {
+    Entry entry;
+    entry.isDir = (rd.u8() & 1) != 0;
+    entry.name = rd.str();
+    entries.push_back(entry);
+  }
+  if (!rd.good())
+  {
+    entries.clear();
+    ++stats_.misses;
+    return false;
+  }
+  ++stats_.hits;
+  return true;
+}
+//----< share entries of dir, just enumerated >----------------------
+/*
+ *  A dir written to within RacyTicks might change again in the same
+ *  tick without its time moving, so its listing isn't shared.  The
+ *  listing replaces an older one of the dir, or else the older of the
+ *  dir's two slots.
+ */
+bool SharedDirCache::store(const Path& dir, uint64_t time, const Entries& entries)
+{
+  if (!good())
+    return false;
+  std::string path = FileSystem::Path::toLower(dir);
+  std::string payload;
+  BinaryIO::Writer wr(payload);
+  wr.str(path);
+  wr.varint(entries.size());
+  for (auto& entry : entries)
+  {
+    wr.u8(entry.isDir ? 1 : 0);
+    wr.str(entry.name);
+  }
+  uint64_t key = BinaryIO::fnv1a(path);
+  Slot* first = slotOf(key, 0);
+  Slot* second = slotOf(key, 1);
+  Slot* slot = (first->key == key || (second->key != key && first->stored <= second->stored)) ? first : second;
+  uint64_t now = FileSystem::FileInfo::now();
+  LONG before = slot->sequence;
+  if (time == 0 || time + RacyTicks >= now || payload.size() > sizeof(slot->payload) ||
+      (before & 1) || ::InterlockedCompareExchange(&slot->sequence, before + 1, before) != before)
+  {
+    ++stats_.skipped;
+    return false;
+  }
+  slot->size = static_cast<uint32_t>(payload.size());
+  slot->key = key;
+  slot->time = time;
+  slot->stored = now;
+  std::memcpy(slot->payload, payload.data(), payload.size());
+  ::InterlockedExchange(&slot->sequence, before + 2);
+  ++stats_.stores;
+  return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SHAREDDIRCACHE
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing SharedDirCache";
+  std::cout << "\n ========================";
+
+  std::string dir = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : ".");
+  uint64_t time = FileSystem::FileInfo(dir).time();
+  SharedDirCache writer("Local\\FindFiles.DirCache.test"), reader("Local\\FindFiles.DirCache.test");
+  SharedDirCache::Entries entries;
+  for (auto& entry : FileSystem::Directory::getEntries(dir))
+    entries.push_back(SharedDirCache::Entry{ entry.name, entry.isDir });
+  std::cout << "\n  stored " << entries.size() << " entries: " << writer.store(dir, time, entries);
+
+  SharedDirCache::Entries shared;
+  std::cout << "\n  lookup with same time: " << reader.lookup(dir, time, shared) << ", " << shared.size() << " entries";
+  std::cout << "\n  lookup with other time: " << reader.lookup(dir, time + 1, shared);
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
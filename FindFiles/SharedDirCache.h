@@ -0,0 +1,116 @@
+#ifndef SHAREDDIRCACHE_H
+#define SHAREDDIRCACHE_H
+///////////////////////////////////////////////////////////////////////
+// SharedDirCache.h - dir listings shared by concurrent processes    //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * A build often starts several FindFiles processes at once, and they
+ * enumerate the same dirs within seconds of each other.  With /shared,
+ * each process looks for a dir's listing in a named shared memory
+ * section before enumerating it, and leaves the listings it reads
+ * there for the others.
+ *
+ * The section is an array of fixed size slots, and a dir's listing is
+ * in one of two slots picked by a hash of its path.  A slot holds the
+ * path, the dir's last write time, and each entry's name and whether
+ * it is a dir.  A listing is used only if the dir's last write time is
+ * unchanged, and one too large for a slot is not shared.  The section
+ * exists while any process has it open, so it holds only recent
+ * listings.
+ *
+ * Readers take no lock.  Each slot has a sequence number a writer makes
+ * odd while it writes and even when done.  A reader copies the slot,
+ * then checks that the number was even and didn't change, and if not,
+ * tries once more, then reads the dir itself.  A writer claims a slot
+ * with a compare and swap of the sequence number, and if another writer
+ * has it, just doesn't share that listing.  A process that dies while
+ * writing leaves its slot unused until the section is recreated.
+ *
+ * Public Interface:
+ * -----------------
+ * SharedDirCache cache;
+ * SharedDirCache::Entries entries;
+ * if (!cache.lookup(dir, time, entries)) {
+ *   ... enumerate dir into entries ...
+ *   cache.store(dir, time, entries);
+ * }
+ *
+ * Required Files:
+ * ---------------
+ * SharedDirCache.h, SharedDirCache.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <windows.h>
+
+class SharedDirCache
+{
+public:
+  using Path = std::string;
+  static const size_t SlotCount = 4096;
+  static const size_t SlotSize = 16384;   // bytes, including slot header
+  static const char* const SectionName;
+
+  struct Entry
+  {
+    std::string name;
+    bool isDir = false;
+  };
+  using Entries = std::vector<Entry>;
+
+  struct Stats
+  {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stores = 0;
+    size_t skipped = 0;   // too large, just changed, or slot busy
+  };
+
+  SharedDirCache(const std::string& sectionName = SectionName);
+  ~SharedDirCache();
+  SharedDirCache(const SharedDirCache&) = delete;
+  SharedDirCache& operator=(const SharedDirCache&) = delete;
+
+  bool good() const;
+  std::string error() const;
+  bool lookup(const Path& dir, uint64_t time, Entries& entries);
+  bool store(const Path& dir, uint64_t time, const Entries& entries);
+  Stats stats() const;
+private:
+  struct Slot;
+  Slot* slotOf(uint64_t key, int way) const;
+
+  HANDLE hMap_ = NULL;
+  char* base_ = nullptr;
+  Stats stats_;
+  std::string error_;
+};
+
+inline bool SharedDirCache::good() const
+{
+  return base_ != nullptr;
+}
+
+inline std::string SharedDirCache::error() const
+{
+  return error_;
+}
+
+inline SharedDirCache::Stats SharedDirCache::stats() const
+{
+  return stats_;
+}
+
+#endif
@@ -0,0 +1,469 @@
+///////////////////////////////////////////////////////////////////////
+// Snapshot.cpp - sorted binary snapshots of a tree, and their diffs //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Snapshot file layout, all integers little-endian:
+ *   header  : magic "FFSN", version, u64 entry count, volume serial,
+ *             reserved, varint length and root path
+ *   entries : in path order - varint length of prefix shared with the
+ *             previous path, varint length and rest of path, u64 file
+ *             id, u64 size, u64 last write time
+ */
+
+#include "Snapshot.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+  const uint32_t Magic = 0x4e534646;   // "FFSN"
+  const uint32_t Version = 1;
+  const size_t CountOffset = 8;
+  const size_t ChunkSize = 1024 * 1024;
+
+  bool sameFile(const std::string& a, const std::string& b)
+  {
+    return FileSystem::Path::toLower(a) == FileSystem::Path::toLower(b);
+  }
+}
+//----< paths in walk order: a dir's subtree sorts where its name does >
+
+bool Snapshot::pathLess(const Path& a, const Path& b)
+{
+  size_t n = (std::min)(a.size(), b.size());
+  for (size_t i = 0; i < n; ++i)
+  {
+    unsigned char ca = (a[i] == '\\') ? 0 : static_cast<unsigned char>(a[i]);
+    unsigned char cb = (b[i] == '\\') ? 0 : static_cast<unsigned char>(b[i]);
+    if (ca != cb)
+      return ca < cb;
+  }
+  return a.size() < b.size();
+}
+//----< snapshot saved to file >-------------------------------------
+
+Snapshot::Snapshot(const Path& file) : file_(file) {}
+
+//----< walk tree below root, saving files that match >--------------
+
+bool Snapshot::take(const Path& root, const NameMatcher& matcher)
+{
+  matcher_ = matcher;
+  if (!begin(root, FileSystem::Directory::volumeOf(root)))
+    return false;
+  walk(root, "");
+  return end();
+}
+//----< start writing a snapshot of root, with no entries >----------
+/*
+ *  Entries are written to a temporary in chunks, so memory use doesn't
+ *  grow with the number of entries, and end() renames the temporary
+ *  over the file.
+ */
+bool Snapshot::begin(const Path& root, unsigned long volume)
+{
+  stats_ = Stats();
+  prev_.clear();
+  buffer_.clear();
+  Path temp = file_ + ".tmp";
+  out_.open(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out_.good())
+  {
+    error_ = "can't write " + temp;
+    return false;
+  }
+  BinaryIO::Writer wr(buffer_);
+  wr.u32(Magic);
+  wr.u32(Version);
+  wr.u64(0);   // count, known at end
+  wr.u32(volume);
+  wr.u32(0);
+  wr.str(root);
+  return true;
+}
+//----< write last chunk and count, and replace the file >-----------
+
+bool Snapshot::end()
+{
+  Path temp = file_ + ".tmp";
+  std::string count;
+  BinaryIO::Writer cw(count);
+  cw.u64(stats_.files);
+  out_.write(buffer_.data(), buffer_.size());
+  stats_.bytes += buffer_.size();
+  out_.seekp(CountOffset);
+  out_.write(count.data(), count.size());
+  bool ok = out_.good();
+  out_.close();
+  std::string().swap(buffer_);
+  if (!ok || !FileSystem::File::move(temp, file_))
+  {
+    FileSystem::File::remove(temp);
+    error_ = "can't write " + file_;
+    return false;
+  }
+  return true;
+}
+//----< stop writing, removing the temporary but not the file >------
+
+void Snapshot::abandon()
+{
+  out_.close();
+  std::string().swap(buffer_);
+  FileSystem::File::remove(file_ + ".tmp");
+}
+//----< save dir's files, and its subdirs' files, in path order >----
+
+void Snapshot::walk(const Path& dir, const Path& relative)
+{
+  ++stats_.dirs;
+  using DirEntry = FileSystem::Directory::Entry;
+  std::vector<DirEntry> entries = FileSystem::Directory::getIdEntries(dir);
+  for (auto& entry : entries)
+  {
+    if (entry.isDir)
+      entry.name += '\\';   // so subtree sorts as its paths will
+  }
+  std::sort(entries.begin(), entries.end(),
+    [](const DirEntry& a, const DirEntry& b) { return pathLess(a.name, b.name); });
+  for (auto& entry : entries)
+  {
+    if (entry.isDir)
+    {
+      entry.name.pop_back();
+      walk(dir + "\\" + entry.name, relative + entry.name + "\\");
+      continue;
+    }
+    Path fullPath = dir + "\\" + entry.name;
+    if (sameFile(fullPath, file_) || sameFile(fullPath, file_ + ".tmp"))
+      continue;
+    if (!matcher_.matches(entry.name.data(), entry.name.size()))
+      continue;
+    Entry rec;
+    rec.path = relative + entry.name;
+    rec.id = entry.id;
+    rec.size = entry.size;
+    rec.time = entry.time;
+    add(rec);
+  }
+}
+//----< front code entry's path against the previous one >-----------
+
+void Snapshot::add(const Entry& entry)
+{
+  size_t n = (std::min)(prev_.size(), entry.path.size());
+  size_t shared = 0;
+  while (shared < n && prev_[shared] == entry.path[shared])
+    ++shared;
+  BinaryIO::Writer wr(buffer_);
+  wr.varint(shared);
+  wr.varint(entry.path.size() - shared);
+  wr.bytes(entry.path.data() + shared, entry.path.size() - shared);
+  wr.u64(entry.id);
+  wr.u64(entry.size);
+  wr.u64(entry.time);
+  prev_ = entry.path;
+  ++stats_.files;
+  if (buffer_.size() >= ChunkSize)
+  {
+    out_.write(buffer_.data(), buffer_.size());
+    stats_.bytes += buffer_.size();
+    buffer_.clear();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////
+// SnapshotReader
+
+//----< map snapshot and read its header >---------------------------
+
+SnapshotReader::SnapshotReader(const Path& file) : map_(file), rd_(map_.data(), map_.end())
+{
+  if (!map_.good())
+  {
+    error_ = "can't open snapshot " + file;
+    return;
+  }
+  if (rd_.u32() != Magic || rd_.u32() != Version)
+  {
+    error_ = file + " is not a snapshot";
+    return;
+  }
+  count_ = rd_.u64();
+  volume_ = rd_.u32();
+  rd_.skip(4);
+  root_ = rd_.str();
+  if (!rd_.good())
+    error_ = file + " is damaged";
+}
+//----< decode next entry, false at end or if damaged >--------------
+
+bool SnapshotReader::next(Snapshot::Entry& entry)
+{
+  if (read_ >= count_ || !good())
+    return false;
+  uint64_t shared = rd_.varint();
+  size_t rest = static_cast<size_t>(rd_.varint());
+  const char* p = (shared <= path_.size()) ? rd_.bytes(rest) : nullptr;
+  if (p == nullptr)
+  {
+    error_ = "snapshot of " + root_ + " is damaged";
+    return false;
+  }
+  path_.resize(static_cast<size_t>(shared));
+  path_.append(p, rest);
+  entry.path = path_;
+  entry.id = rd_.u64();
+  entry.size = rd_.u64();
+  entry.time = rd_.u64();
+  if (!rd_.good())
+  {
+    error_ = "snapshot of " + root_ + " is damaged";
+    return false;
+  }
+  ++read_;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// SnapshotDiff
+
+SnapshotDiff::SnapshotDiff(const Path& before, const Path& after) : before_(before), after_(after) {}
+
+//----< merge snapshots, reporting each change to visit >------------
+/*
+ *  Modified files are reported as the merge finds them.  Files in only
+ *  one snapshot are held until the end, then paired by file id into
+ *  renames, and the rest are reported as added or removed.
+ */
+bool SnapshotDiff::run(Visitor visit)
+{
+  counts_ = Counts();
+  SnapshotReader before(before_), after(after_);
+  if (!before.good() || !after.good())
+  {
+    error_ = before.good() ? after.error() : before.error();
+    return false;
+  }
+  bool compareIds = before.volume() != 0 && before.volume() == after.volume();
+
+  std::vector<Entry> removed, added;
+  Entry a, b;
+  bool hasA = before.next(a);
+  bool hasB = after.next(b);
+  while (hasA || hasB)
+  {
+    if (hasA && (!hasB || Snapshot::pathLess(a.path, b.path)))
+    {
+      removed.push_back(a);
+      hasA = before.next(a);
+    }
+    else if (hasB && (!hasA || Snapshot::pathLess(b.path, a.path)))
+    {
+      added.push_back(b);
+      hasB = after.next(b);
+    }
+    else
+    {
+      if (a.size != b.size || a.time != b.time || (compareIds && a.id != b.id))
+      {
+        ++counts_.modified;
+        visit(Change{ Modified, a, b });
+      }
+      else
+        ++counts_.unchanged;
+      hasA = before.next(a);
+      hasB = after.next(b);
+    }
+  }
+  if (!before.good() || !after.good())
+  {
+    error_ = before.good() ? after.error() : before.error();
+    return false;
+  }
+
+  std::unordered_map<uint64_t, size_t> removedIds;
+  if (compareIds)
+  {
+    for (size_t i = 0; i < removed.size(); ++i)
+    {
+      if (removed[i].id != 0)
+        removedIds.emplace(removed[i].id, i);
+    }
+  }
+  std::vector<bool> wasRenamed(removed.size(), false), isRename(added.size(), false);
+  for (size_t i = 0; i < added.size() && removedIds.size() > 0; ++i)
+  {
+    auto iter = removedIds.find(added[i].id);
+    if (added[i].id == 0 || iter == removedIds.end())
+      continue;
+    ++counts_.renamed;
+    visit(Change{ Renamed, removed[iter->second], added[i] });
+    wasRenamed[iter->second] = true;
+    isRename[i] = true;
+    removedIds.erase(iter);
+  }
+  for (size_t i = 0; i < added.size(); ++i)
+  {
+    if (isRename[i])
+      continue;
+    ++counts_.added;
+    visit(Change{ Added, Entry(), added[i] });
+  }
+  for (size_t i = 0; i < removed.size(); ++i)
+  {
+    if (wasRenamed[i])
+      continue;
+    ++counts_.removed;
+    visit(Change{ Removed, removed[i], Entry() });
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////
+// SnapshotSet
+
+SnapshotSet::SnapshotSet(Op op, const Path& first, const Path& second) : op_(op), first_(first), second_(second) {}
+
+//----< merge snapshots, passing each entry of the result to visit >-
+/*
+ *  Both snapshots are read once, in path order, and each entry of the
+ *  result is passed on as the merge finds it, so it's in path order
+ *  too.  Paths are relative to root, so both must have the same root.
+ */
+bool SnapshotSet::run(Visitor visit)
+{
+  counts_ = Counts();
+  SnapshotReader first(first_), second(second_);
+  if (!first.good() || !second.good())
+  {
+    error_ = first.good() ? second.error() : first.error();
+    return false;
+  }
+  root_ = first.root();
+  if (!sameFile(first.root(), second.root()))
+  {
+    error_ = first_ + " is of " + first.root() + ", but " + second_ + " is of " + second.root();
+    return false;
+  }
+  auto keep = [&](const Entry& entry) {
+    ++counts_.result;
+    visit(entry);
+  };
+  Entry a, b;
+  bool hasA = first.next(a);
+  bool hasB = second.next(b);
+  while (hasA || hasB)
+  {
+    if (hasA && (!hasB || Snapshot::pathLess(a.path, b.path)))
+    {
+      if (op_ != Intersect)
+        keep(a);
+      ++counts_.first;
+      hasA = first.next(a);
+    }
+    else if (hasB && (!hasA || Snapshot::pathLess(b.path, a.path)))
+    {
+      if (op_ == Union)
+        keep(b);
+      ++counts_.second;
+      hasB = second.next(b);
+    }
+    else
+    {
+      if (op_ != Minus)
+        keep(a);
+      ++counts_.first;
+      ++counts_.second;
+      hasA = first.next(a);
+      hasB = second.next(b);
+    }
+    if (op_ != Union && !hasA)   // rest of second can't be in result
+      break;
+  }
+  if (!first.good() || !second.good())
+  {
+    error_ = first.good() ? second.error() : first.error();
+    return false;
+  }
+  return true;
+}
+//----< save result as a snapshot of the same root >-----------------
+
+bool SnapshotSet::save(const Path& file)
+{
+  SnapshotReader first(first_), second(second_);
+  if (!first.good() || !second.good())
+  {
+    error_ = first.good() ? second.error() : first.error();
+    return false;
+  }
+  unsigned long volume = (first.volume() == second.volume()) ? first.volume() : 0;
+  Snapshot result(file);
+  if (!result.begin(first.root(), volume))
+  {
+    error_ = result.error();
+    return false;
+  }
+  if (!run([&](const Entry& entry) { result.add(entry); }))
+  {
+    result.abandon();
+    return false;
+  }
+  if (!result.end())
+  {
+    error_ = result.error();
+    return false;
+  }
+  return true;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_SNAPSHOT
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing Snapshot";
+  std::cout << "\n ==================";
+
+  std::string root = FileSystem::Path::getFullFileSpec(argc > 1 ? argv[1] : ".");
+  Snapshot first("first.snap"), second("second.snap");
+  first.take(root);
+  std::cout << "\n  first: " << first.stats().files << " files, " << first.stats().bytes << " bytes";
+  {
+    std::ofstream out(FileSystem::Path::fileSpec(root, "Snapshot.test"));
+    out << "added between snapshots";
+  }
+  second.take(root);
+  FileSystem::File::remove(FileSystem::Path::fileSpec(root, "Snapshot.test"));
+  std::cout << "\n  second: " << second.stats().files << " files, " << second.stats().bytes << " bytes";
+
+  const char* kinds[] = { "added", "removed", "modified", "renamed" };
+  SnapshotDiff diff("first.snap", "second.snap");
+  diff.run([&](const SnapshotDiff::Change& change) {
+    std::cout << "\n    " << kinds[change.kind] << "  " << (change.after.path.size() > 0 ? change.after.path : change.before.path);
+  });
+  SnapshotDiff::Counts counts = diff.counts();
+  std::cout << "\n  " << counts.added << " added, " << counts.unchanged << " unchanged";
+
+  Snapshot headers("headers.snap");
+  headers.take(root, NameMatcher({ "*.h" }));
+  SnapshotSet minus(SnapshotSet::Minus, "first.snap", "headers.snap");
+  if (!minus.save("minus.snap"))
+    std::cout << "\n  " << minus.error();
+  SnapshotSet::Counts mc = minus.counts();
+  std::cout << "\n  first minus headers: " << mc.result << " of " << mc.first << " files";
+  SnapshotSet both(SnapshotSet::Union, "minus.snap", "headers.snap");
+  both.run([](const Snapshot::Entry&) {});
+  std::cout << "\n  that union headers: " << both.counts().result << " files";
+  for (auto file : { "first.snap", "second.snap", "headers.snap", "minus.snap" })
+    FileSystem::File::remove(file);
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
@@ -0,0 +1,278 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+///////////////////////////////////////////////////////////////////////
+// Snapshot.h - sorted binary snapshots of a tree, and their diffs   //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * FindFiles /snapshot and /diff find drift, e.g., on deployed hosts,
+ * by comparing the state of a tree on two days.
+ *
+ * Snapshot walks a tree and saves, for every file, its path relative
+ * to the root, its file id, its size, and its last write time.  Entries
+ * are written in path order as the walk finds them, with each path
+ * front coded against the one before.  A dir's subtree sorts where its
+ * name does, so each dir's entries only need sorting among themselves.
+ *
+ * SnapshotReader maps a saved snapshot and decodes its entries in
+ * order, without loading them.
+ *
+ * SnapshotDiff reads two snapshots side by side in one linear merge:
+ * - a path in both with a different size, time, or file id is modified.
+ * - a path only in the older snapshot was removed or renamed, and a
+ *   path only in the newer one was added or is a rename's new name.
+ *   Removed and added entries with the same file id are renames.
+ * File ids are compared only when both snapshots were taken on the
+ * same volume.  Memory use is proportional to the changes, not to the
+ * size of the tree.
+ *
+ * A snapshot of the files matching a query is that query's result set.
+ * SnapshotSet merges two snapshots of the same root into their union,
+ * intersection, or difference, also in one linear merge, writing the
+ * result as a snapshot as it goes, so memory use doesn't depend on the
+ * size of either.  Where both have a path, the union and intersection
+ * keep the first snapshot's entry.
+ *
+ * Public Interface:
+ * -----------------
+ * Snapshot snap("monday.snap");
+ * snap.take(root, NameMatcher({ "*.dll", "*.exe" }));
+ * SnapshotDiff diff("monday.snap", "tuesday.snap");
+ * diff.run([](const SnapshotDiff::Change& change) { ... });
+ * SnapshotDiff::Counts counts = diff.counts();
+ * SnapshotSet dlls(SnapshotSet::Minus, "all.snap", "signed.snap");
+ * dlls.save("unsigned.snap");   // or dlls.run([](const Snapshot::Entry& entry) { ... });
+ *
+ * Required Files:
+ * ---------------
+ * Snapshot.h, Snapshot.cpp
+ * NameMatch.h, NameMatch.cpp, Trigram.h, Trigram.cpp
+ * BinaryIO.h, FileSystem.h, FileSystem.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.2 : 18 Oct 2026
+ * - added abandon(), so a failed SnapshotSet::save leaves the file it
+ *   would have replaced as it was
+ * Ver 1.1 : 18 Oct 2026
+ * - added SnapshotSet, and begin, add, and end for writing entries
+ *   from somewhere other than a walk
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <fstream>
+#include <cstdint>
+#include "NameMatch.h"
+#include "BinaryIO.h"
+#include "FileSystem.h"
+
+class Snapshot
+{
+public:
+  using Path = std::string;
+
+  struct Entry
+  {
+    Path path;          // relative to root
+    uint64_t id = 0;    // file id, 0 if unknown
+    uint64_t size = 0;
+    uint64_t time = 0;  // last write, 100 ns ticks since 1601, UTC
+  };
+
+  struct Stats
+  {
+    size_t dirs = 0;
+    size_t files = 0;
+    size_t bytes = 0;   // size of saved snapshot
+  };
+
+  Snapshot(const Path& file);
+  bool take(const Path& root, const NameMatcher& matcher = NameMatcher());
+  bool begin(const Path& root, unsigned long volume);
+  void add(const Entry& entry);   // in pathLess order
+  bool end();
+  void abandon();   // instead of end(), keeping the file as it was
+  Stats stats();
+  std::string error();
+
+  static bool pathLess(const Path& a, const Path& b);
+private:
+  void walk(const Path& dir, const Path& relative);
+
+  Path file_;
+  NameMatcher matcher_;
+  std::ofstream out_;
+  std::string buffer_;   // written to out_ in chunks
+  Path prev_;
+  Stats stats_;
+  std::string error_;
+};
+
+inline Snapshot::Stats Snapshot::stats()
+{
+  return stats_;
+}
+
+inline std::string Snapshot::error()
+{
+  return error_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// SnapshotReader class
+// - decodes entries of a mapped snapshot in path order
+
+class SnapshotReader
+{
+public:
+  using Path = Snapshot::Path;
+
+  SnapshotReader(const Path& file);
+  bool good() const;
+  std::string error() const;
+  Path root() const;
+  uint64_t count() const;
+  unsigned long volume() const;
+  bool next(Snapshot::Entry& entry);
+private:
+  FileSystem::MappedFile map_;
+  BinaryIO::Reader rd_;
+  Path root_;
+  uint64_t count_ = 0;
+  uint64_t read_ = 0;
+  unsigned long volume_ = 0;
+  Path path_;   // of last entry read
+  std::string error_;
+};
+
+inline bool SnapshotReader::good() const
+{
+  return error_.size() == 0;
+}
+
+inline std::string SnapshotReader::error() const
+{
+  return error_;
+}
+
+inline SnapshotReader::Path SnapshotReader::root() const
+{
+  return root_;
+}
+
+inline uint64_t SnapshotReader::count() const
+{
+  return count_;
+}
+
+inline unsigned long SnapshotReader::volume() const
+{
+  return volume_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// SnapshotDiff class
+// - added, removed, modified, and renamed files between two snapshots
+
+class SnapshotDiff
+{
+public:
+  using Path = Snapshot::Path;
+  using Entry = Snapshot::Entry;
+  enum Kind { Added, Removed, Modified, Renamed };
+
+  struct Change
+  {
+    Kind kind;
+    Entry before;   // empty path if added
+    Entry after;    // empty path if removed
+  };
+  using Visitor = std::function<void(const Change& change)>;
+
+  struct Counts
+  {
+    size_t added = 0;
+    size_t removed = 0;
+    size_t modified = 0;
+    size_t renamed = 0;
+    size_t unchanged = 0;
+  };
+
+  SnapshotDiff(const Path& before, const Path& after);
+  bool run(Visitor visit);
+  Counts counts() const;
+  std::string error() const;
+private:
+  Path before_;
+  Path after_;
+  Counts counts_;
+  std::string error_;
+};
+
+inline SnapshotDiff::Counts SnapshotDiff::counts() const
+{
+  return counts_;
+}
+
+inline std::string SnapshotDiff::error() const
+{
+  return error_;
+}
+
+///////////////////////////////////////////////////////////////////////
+// SnapshotSet class
+// - union, intersection, or difference of two snapshots' entries
+
+class SnapshotSet
+{
+public:
+  using Path = Snapshot::Path;
+  using Entry = Snapshot::Entry;
+  using Visitor = std::function<void(const Entry& entry)>;
+  enum Op { Union, Intersect, Minus };
+
+  struct Counts
+  {
+    size_t first = 0;    // entries read from each snapshot
+    size_t second = 0;
+    size_t result = 0;
+  };
+
+  SnapshotSet(Op op, const Path& first, const Path& second);
+  bool run(Visitor visit);
+  bool save(const Path& file);
+  Path root() const;
+  Counts counts() const;
+  std::string error() const;
+private:
+  Op op_;
+  Path first_;
+  Path second_;
+  Path root_;
+  Counts counts_;
+  std::string error_;
+};
+
+inline SnapshotSet::Path SnapshotSet::root() const
+{
+  return root_;
+}
+
+inline SnapshotSet::Counts SnapshotSet::counts() const
+{
+  return counts_;
+}
+
+inline std::string SnapshotSet::error() const
+{
+  return error_;
+}
+
+#endif
@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////
+// TextSearch.cpp - find lines in a file matching a regex            //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "TextSearch.h"
+#include "Decompressor.h"
+#include <cstring>
+
+//----< construct with compiled regex >------------------------------
+
+TextSearcher::TextSearcher(const Regex& regex)
+{
+  this->regex(regex);
+}
+//----< compile regex once, not once per file >----------------------
+
+void TextSearcher::regex(const Regex& regex)
+{
+  regexStr_ = regex;
+  re_ = std::regex(regex);
+}
+//----< each thread owns one decompressor, reused for all files >----
+
+Decompressor& TextSearcher::decompressor()
+{
+  thread_local Decompressor dc;
+  return dc;
+}
+//----< return all matching lines with their line numbers >----------
+
+TextSearcher::Matches TextSearcher::search(const std::string& fileSpec)
+{
+  Matches matches;
+  scan(fileSpec, &matches);
+  return matches;
+}
+//----< does file contain a matching line? stops at first match >----
+
+bool TextSearcher::found(const std::string& fileSpec)
+{
+  return scan(fileSpec, nullptr);
+}
+//----< read uncompressed text a block at a time, matching lines >---
+/*
+ *  Line numbers count newlines in the uncompressed text, so they
+ *  agree with what an editor shows after decompressing the file.
+ */
+bool TextSearcher::scan(const std::string& fileSpec, Matches* pMatches)
+{
+  error_.clear();
+  Decompressor& dc = decompressor();
+  if (!dc.open(fileSpec))
+  {
+    error_ = dc.error();
+    return false;
+  }
+
+  const size_t BufSize = 64 * 1024;
+  std::vector<char> buffer(BufSize);
+  std::string line;     // holds a line split across two blocks
+  LineNumber lineNum = 0;
+  bool foundMatch = false;
+
+  auto test = [&](const char* beg, const char* end) {
+    ++lineNum;
+    if (end > beg && *(end - 1) == '\r')
+      --end;
+    if (std::regex_search(beg, end, re_))
+    {
+      foundMatch = true;
+      if (pMatches)
+      {
+        size_t len = static_cast<size_t>(end - beg);
+        if (maxLineLength_ > 0 && len > maxLineLength_)
+          len = maxLineLength_;
+        pMatches->push_back(Match{ lineNum, std::string(beg, len) });
+      }
+    }
+  };
+
+  size_t n = 0;
+  while ((n = dc.read(buffer.data(), BufSize)) > 0)
+  {
+    const char* pos = buffer.data();
+    const char* end = pos + n;
+    while (pos < end)
+    {
+      const char* nl = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+      if (nl == nullptr)
+      {
+        line.append(pos, end);
+        break;
+      }
+      if (line.size() > 0)
+      {
+        line.append(pos, nl);
+        test(line.data(), line.data() + line.size());
+        line.clear();
+      }
+      else
+        test(pos, nl);
+      pos = nl + 1;
+      if (foundMatch && !pMatches)
+        break;
+    }
+    if (foundMatch && !pMatches)
+      break;
+  }
+  if (line.size() > 0 && !(foundMatch && !pMatches))
+    test(line.data(), line.data() + line.size());
+
+  if (!dc.good())
+    error_ = dc.error();
+  dc.close();
+  return foundMatch;
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TEXTSEARCH
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+  std::cout << "\n  Testing TextSearcher";
+  std::cout << "\n ======================";
+  if (argc < 3)
+  {
+    std::cout << "\n  usage: TextSearch regex file [file]*\n\n";
+    return 1;
+  }
+  TextSearcher ts(argv[1]);
+  for (int i = 2; i < argc; ++i)
+  {
+    TextSearcher::Matches matches = ts.search(argv[i]);
+    std::cout << "\n  " << argv[i] << ": " << matches.size() << " matches";
+    if (ts.error().size() > 0)
+      std::cout << " -- " << ts.error();
+    for (size_t j = 0; j < matches.size() && j < 5; ++j)
+      std::cout << "\n    " << matches[j].line << ": " << matches[j].text;
+  }
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
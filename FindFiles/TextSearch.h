@@ -0,0 +1,86 @@
+#ifndef TEXTSEARCH_H
+#define TEXTSEARCH_H
+///////////////////////////////////////////////////////////////////////
+// TextSearch.h - find lines in a file matching a regex              //
+// Ver 1.0                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * TextSearcher supports FindFiles content search, /C regex.
+ * - Reads each file through a Decompressor, so *.log.gz and *.log.zst
+ *   files are searched like plain text, without writing them to disk.
+ * - Reports matching lines with their uncompressed line numbers.
+ * - Uses one Decompressor per thread, so contexts are reused across
+ *   all the files a thread searches.
+ *
+ * Public Interface:
+ * -----------------
+ * TextSearcher ts("threads|sockets");
+ * TextSearcher::Matches matches = ts.search(fileSpec);
+ * for (auto m : matches)
+ *   std::cout << m.line << ": " << m.text;
+ *
+ * Required Files:
+ * ---------------
+ * TextSearch.h, TextSearch.cpp
+ * Decompressor.h, Decompressor.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <regex>
+
+class Decompressor;
+
+class TextSearcher
+{
+public:
+  using Regex = std::string;
+  using LineNumber = size_t;
+
+  struct Match
+  {
+    LineNumber line;
+    std::string text;
+  };
+  using Matches = std::vector<Match>;
+
+  TextSearcher(const Regex& regex = ".*");
+  void regex(const Regex& regex);
+  Regex regex();
+  void maxLineLength(size_t max);
+  Matches search(const std::string& fileSpec);
+  bool found(const std::string& fileSpec);
+  std::string error();
+private:
+  static Decompressor& decompressor();
+  bool scan(const std::string& fileSpec, Matches* pMatches);
+  Regex regexStr_;
+  std::regex re_;
+  size_t maxLineLength_ = 200;
+  std::string error_;
+};
+
+inline TextSearcher::Regex TextSearcher::regex()
+{
+  return regexStr_;
+}
+
+inline void TextSearcher::maxLineLength(size_t max)
+{
+  maxLineLength_ = max;
+}
+
+inline std::string TextSearcher::error()
+{
+  return error_;
+}
+
+#endif
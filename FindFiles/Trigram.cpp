@@ -0,0 +1,335 @@
+///////////////////////////////////////////////////////////////////////
+// Trigram.cpp - turns a regex into a trigram query over postings    //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+
+#include "Trigram.h"
+#include <algorithm>
+#include <sstream>
+#include <cctype>
+
+namespace
+{
+  using Runs = std::vector<std::string>;
+
+  //----< index of ']' closing bracket expression starting at i >----
+
+  size_t skipClass(const std::string& rx, size_t i)
+  {
+    size_t j = i + 1;
+    if (j < rx.size() && rx[j] == '^')
+      ++j;
+    if (j < rx.size() && rx[j] == ']')
+      ++j;
+    while (j < rx.size() && rx[j] != ']')
+    {
+      if (rx[j] == '\\')
+        ++j;
+      ++j;
+    }
+    return (std::min)(j, rx.size());
+  }
+  //----< index of ')' closing group starting at i >-----------------
+
+  size_t skipGroup(const std::string& rx, size_t i)
+  {
+    int depth = 0;
+    for (size_t j = i; j < rx.size(); ++j)
+    {
+      char c = rx[j];
+      if (c == '\\')
+        ++j;
+      else if (c == '[')
+        j = skipClass(rx, j);
+      else if (c == '(')
+        ++depth;
+      else if (c == ')' && --depth == 0)
+        return j;
+    }
+    return rx.size();
+  }
+  //----< split regex at its top level alternation bars >------------
+
+  std::vector<std::string> splitAlternatives(const std::string& rx)
+  {
+    std::vector<std::string> alts;
+    size_t start = 0;
+    for (size_t i = 0; i < rx.size(); ++i)
+    {
+      if (rx[i] == '\\')
+        ++i;
+      else if (rx[i] == '[')
+        i = skipClass(rx, i);
+      else if (rx[i] == '(')
+        i = skipGroup(rx, i);
+      else if (rx[i] == '|')
+      {
+        alts.push_back(rx.substr(start, i - start));
+        start = i + 1;
+      }
+    }
+    alts.push_back(rx.substr((std::min)(start, rx.size())));
+    return alts;
+  }
+  //----< collect runs of characters every match must contain >------
+  /*
+   *  cur holds the run being built.  Anything that is not a single
+   *  literal character ends the run.  A quantifier that allows zero
+   *  repetitions also removes the character it applies to.  Groups
+   *  without alternation or optional quantifiers are read through.
+   *  Runs shorter than minLength are dropped.
+   */
+  void literalRuns(const std::string& rx, Runs& runs, std::string& cur, size_t minLength = 3)
+  {
+    auto endRun = [&]() {
+      if (cur.size() >= minLength)
+        runs.push_back(cur);
+      cur.clear();
+    };
+
+    for (size_t i = 0; i < rx.size(); ++i)
+    {
+      char c = rx[i];
+      switch (c)
+      {
+      case '\\':
+        if (i + 1 < rx.size() && std::ispunct(static_cast<unsigned char>(rx[i + 1])))
+          cur += rx[++i];   // escaped metacharacter is a literal
+        else
+        {
+          ++i;              // \d, \w, \b, ... match classes or positions
+          endRun();
+        }
+        break;
+      case '[':
+        i = skipClass(rx, i);
+        endRun();
+        break;
+      case '(':
+      {
+        size_t end = skipGroup(rx, i);
+        std::string inner = rx.substr(i + 1, end - (std::min)(end, i + 1));
+        char next = end + 1 < rx.size() ? rx[end + 1] : '\0';
+        bool optional = (next == '*' || next == '?' || next == '{');
+        bool lookaround = inner.size() > 0 && inner[0] == '?' && (inner.size() < 2 || inner[1] != ':');
+        if (inner.size() > 1 && inner[0] == '?' && inner[1] == ':')
+          inner = inner.substr(2);
+        if (optional || lookaround || splitAlternatives(inner).size() > 1)
+          endRun();
+        else
+        {
+          literalRuns(inner, runs, cur, minLength);
+          if (next == '+')
+            endRun();
+        }
+        i = end;
+        if (optional || next == '+')
+        {
+          endRun();
+          if (next == '{')
+          {
+            size_t close = rx.find('}', end);
+            i = (close == std::string::npos) ? rx.size() : close;
+          }
+          else
+            ++i;
+        }
+        break;
+      }
+      case '*':
+      case '?':
+        if (cur.size() > 0)
+          cur.pop_back();
+        endRun();
+        break;
+      case '{':
+      {
+        if (cur.size() > 0)
+          cur.pop_back();
+        endRun();
+        size_t close = rx.find('}', i);
+        i = (close == std::string::npos) ? rx.size() : close;
+        break;
+      }
+      case '+':
+      case '.':
+      case '^':
+      case '$':
+      case ')':
+      case '|':
+        endRun();
+        break;
+      default:
+        cur += c;
+      }
+    }
+  }
+}
+//----< construct and parse >----------------------------------------
+
+TrigramQuery::TrigramQuery(const std::string& regex)
+{
+  parse(regex);
+}
+//----< build OR of ANDs from the regex's literal runs >-------------
+
+void TrigramQuery::parse(const std::string& regex)
+{
+  branches_.clear();
+  matchesAll_ = false;
+  for (auto alt : splitAlternatives(regex))
+  {
+    Runs runs;
+    std::string cur;
+    literalRuns(alt, runs, cur);
+    if (cur.size() >= 3)
+      runs.push_back(cur);
+
+    Trigrams conj;
+    for (auto run : runs)
+    {
+      Trigrams tgs = trigramsOf(run.data(), run.data() + run.size());
+      conj.insert(conj.end(), tgs.begin(), tgs.end());
+    }
+    std::sort(conj.begin(), conj.end());
+    conj.erase(std::unique(conj.begin(), conj.end()), conj.end());
+    if (conj.size() == 0)
+    {
+      // this branch can match without any known trigram
+      matchesAll_ = true;
+      branches_.clear();
+      return;
+    }
+    branches_.push_back(conj);
+  }
+}
+//----< runs of minLength or more characters every match contains >-
+/*
+ *  With top level alternation no run is required, so none are
+ *  returned.
+ */
+std::vector<std::string> TrigramQuery::literals(const std::string& regex, size_t minLength)
+{
+  Runs runs;
+  std::vector<std::string> alts = splitAlternatives(regex);
+  if (alts.size() != 1)
+    return runs;
+  std::string cur;
+  literalRuns(alts[0], runs, cur, minLength);
+  if (cur.size() >= minLength)
+    runs.push_back(cur);
+  return runs;
+}
+//----< sorted, unique trigrams of a character range >---------------
+
+TrigramQuery::Trigrams TrigramQuery::trigramsOf(const char* beg, const char* end)
+{
+  Trigrams tgs;
+  for (const char* p = beg; p + 2 < end; ++p)
+    tgs.push_back(make(p[0], p[1], p[2]));
+  std::sort(tgs.begin(), tgs.end());
+  tgs.erase(std::unique(tgs.begin(), tgs.end()), tgs.end());
+  return tgs;
+}
+//----< intersect sorted id lists >----------------------------------
+
+TrigramQuery::Ids TrigramQuery::intersect(const Ids& a, const Ids& b)
+{
+  Ids result;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+  return result;
+}
+//----< unite sorted id lists >--------------------------------------
+
+TrigramQuery::Ids TrigramQuery::unite(const Ids& a, const Ids& b)
+{
+  Ids result;
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+  return result;
+}
+//----< evaluate query against posting lists >-----------------------
+/*
+ *  Each branch intersects its lists shortest first, so the working
+ *  set shrinks as fast as possible.  Branch results are united.
+ */
+TrigramQuery::Ids TrigramQuery::candidates(Postings postings) const
+{
+  Ids result;
+  for (auto branch : branches_)
+  {
+    std::vector<Ids> lists;
+    for (auto tg : branch)
+    {
+      lists.push_back(postings(tg));
+      if (lists.back().size() == 0)
+        break;
+    }
+    std::sort(lists.begin(), lists.end(), [](const Ids& a, const Ids& b) { return a.size() < b.size(); });
+    Ids ids = lists.size() > 0 ? lists[0] : Ids();
+    for (size_t i = 1; i < lists.size() && ids.size() > 0; ++i)
+      ids = intersect(ids, lists[i]);
+    result = unite(result, ids);
+  }
+  return result;
+}
+//----< display query, e.g., (Fin & ind) | (Uti & til) >-------------
+
+std::string TrigramQuery::show() const
+{
+  if (matchesAll_)
+    return "*";
+  std::ostringstream out;
+  for (size_t i = 0; i < branches_.size(); ++i)
+  {
+    if (i > 0)
+      out << " | ";
+    out << "(";
+    for (size_t j = 0; j < branches_[i].size(); ++j)
+    {
+      Trigram t = branches_[i][j];
+      if (j > 0)
+        out << " & ";
+      out << static_cast<char>(t >> 16) << static_cast<char>((t >> 8) & 0xff) << static_cast<char>(t & 0xff);
+    }
+    out << ")";
+  }
+  return out.str();
+}
+
+//----< test stub >--------------------------------------------------
+
+#ifdef TEST_TRIGRAM
+
+#include <iostream>
+#include <map>
+
+int main()
+{
+  std::cout << "\n  Testing TrigramQuery";
+  std::cout << "\n ======================";
+
+  std::vector<std::string> regexes = {
+    "FindFiles$|Utilities$", "^File|^Util", "Logger", "Sing(leton)?Logger",
+    "Dir(Explorer)+T", "a.*b", "Code\\.h", "[A-Z]+Mgr\\.cpp", "(Find|Code)Utilities"
+  };
+  for (auto rx : regexes)
+    std::cout << "\n  " << rx << "  =>  " << TrigramQuery(rx).show();
+
+  std::vector<std::string> names = {
+    "FindFiles", "CppUtilities", "SingletonLogger.h", "FindFileMgr.cpp", "FileSystem.h", "Logger.cpp"
+  };
+  std::map<TrigramQuery::Trigram, TrigramQuery::Ids> index;
+  for (TrigramQuery::Id id = 0; id < names.size(); ++id)
+    for (auto tg : TrigramQuery::trigramsOf(names[id].data(), names[id].data() + names[id].size()))
+      index[tg].push_back(id);
+
+  TrigramQuery q("Logger|FindFiles$");
+  TrigramQuery::Ids ids = q.candidates([&](TrigramQuery::Trigram t) { return index[t]; });
+  std::cout << "\n\n  candidates for Logger|FindFiles$:";
+  for (auto id : ids)
+    std::cout << "\n    " << names[id];
+  std::cout << "\n\n";
+  return 0;
+}
+#endif
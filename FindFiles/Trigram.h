@@ -0,0 +1,96 @@
+#ifndef TRIGRAM_H
+#define TRIGRAM_H
+///////////////////////////////////////////////////////////////////////
+// Trigram.h - turns a regex into a trigram query over posting lists //
+// Ver 1.2                                                           //
+// Jim Fawcett, https://github.com/JimFawcett/FindFiles, Fall 2026   //
+///////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Trigram indexes map every three character sequence to a sorted list
+ * of the items, files or names, that contain it.  TrigramQuery pulls
+ * the literal runs out of a regex and builds an OR of ANDs of their
+ * trigrams, e.g.:
+ *   "FindFiles$|Utilities$"  =>  (Fin & ind & ndF & ...) | (Uti & til & ...)
+ * Intersecting and uniting the posting lists gives a candidate set that
+ * is guaranteed to contain every match.  Callers run the real regex on
+ * the candidates only.
+ *
+ * Any branch with no literal run of three or more characters could
+ * match anything, so the query then reports matchesAll() and callers
+ * fall back to checking every item.
+ *
+ * literals(regex) returns the runs themselves, for callers that scan
+ * text directly rather than posting lists.
+ *
+ * Public Interface:
+ * -----------------
+ * TrigramQuery q("Logger|Utilities");
+ * if (!q.matchesAll())
+ *   TrigramQuery::Ids ids = q.candidates([&](Trigram t) { return postings(t); });
+ * std::vector<std::string> runs = TrigramQuery::literals("Code\\.h$");   // "Code.h"
+ *
+ * Required Files:
+ * ---------------
+ * Trigram.h, Trigram.cpp
+ *
+ * Maintenance History:
+ * --------------------
+ * Ver 1.2 : 18 Oct 2026
+ * - literals(regex, minLength) can return runs shorter than 3
+ * Ver 1.1 : 18 Oct 2026
+ * - added literals(regex)
+ * Ver 1.0 : 18 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class TrigramQuery
+{
+public:
+  using Trigram = uint32_t;
+  using Trigrams = std::vector<Trigram>;
+  using Id = uint32_t;
+  using Ids = std::vector<Id>;
+  using Postings = std::function<Ids(Trigram)>;
+
+  TrigramQuery(const std::string& regex = "");
+  void parse(const std::string& regex);
+  bool matchesAll() const;
+  const std::vector<Trigrams>& branches() const;
+  Ids candidates(Postings postings) const;
+  std::string show() const;
+
+  static Trigram make(char a, char b, char c);
+  static Trigrams trigramsOf(const char* beg, const char* end);
+  static std::vector<std::string> literals(const std::string& regex, size_t minLength = 3);
+  static Ids intersect(const Ids& a, const Ids& b);
+  static Ids unite(const Ids& a, const Ids& b);
+private:
+  std::vector<Trigrams> branches_;   // OR of branches, each an AND of trigrams
+  bool matchesAll_ = true;
+};
+
+inline bool TrigramQuery::matchesAll() const
+{
+  return matchesAll_;
+}
+
+inline const std::vector<TrigramQuery::Trigrams>& TrigramQuery::branches() const
+{
+  return branches_;
+}
+
+inline TrigramQuery::Trigram TrigramQuery::make(char a, char b, char c)
+{
+  return (static_cast<Trigram>(static_cast<uint8_t>(a)) << 16) |
+         (static_cast<Trigram>(static_cast<uint8_t>(b)) << 8) |
+          static_cast<Trigram>(static_cast<uint8_t>(c));
+}
+
+#endif